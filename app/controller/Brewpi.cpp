@@ -39,6 +39,8 @@
 #include "Sensor.h"
 #include "SettingsManager.h"
 #include "UI.h"
+#include "OneWireBusScheduler.h"
+#include "ControlDataLog.h"
 
 #if BREWPI_SIMULATE
 	#include "Simulator.h"
@@ -89,7 +91,10 @@ void setup()
 #endif	
     settingsManager.loadSettings();
 
-    control.update();
+    control.runScheduled(); // all updates are due at the first run
+#if BREWPI_DATA_LOG
+    controlDataLog.init(platform_dataLogStorage());
+#endif
 
     ui.showControllerPage();
     			
@@ -102,18 +107,31 @@ void setup()
 void brewpiLoop(void)
 {
 	static unsigned long lastUpdate = -1000; // init at -1000 to update immediately
+    ticks_millis_t idle = 0; // time until something is due
     ui.ticks();
         
-    if(!ui.inStartup() && (ticks.millis() - lastUpdate >= (1000))) { //update settings every second
-		lastUpdate = ticks.millis();
-		control.update();
-        ui.update();
+    if(!ui.inStartup()) {
+        idle = control.runScheduled(); // update sensors, pids and actuators when their period has passed
+        if(ticks.millis() - lastUpdate >= (1000)) { //update settings every second
+            lastUpdate = ticks.millis();
+            ui.update();
+            eepromManager.update(); // write settings that were stored more than EEPROM_WRITE_WINDOW ago
+#if BREWPI_DATA_LOG
+            controlDataLog.update();
+#endif
+        }
+        ticks_millis_t untilSettings = 1000 - (ticks.millis() - lastUpdate);
+        idle = (untilSettings < idle) ? untilSettings : idle;
     }
 
-    control.fastUpdate(); // update actuators as often as possible for PWM
+    OneWireBusScheduler::updateAll(); // request and read temperature conversions without blocking
+    ticks_millis_t untilOneWire = OneWireBusScheduler::timeUntilNextAll();
+    idle = (untilOneWire < idle) ? untilOneWire : idle;
 
     //listen for incoming serial connections while waiting to update
     piLink.receive();
+
+    platform_idle(idle);
 }
 
 void loop() {
@@ -102,6 +102,8 @@ Control::Control()
     setpoints.push_back(fridgeSet);
 
     mutex->setDeadTime(1800000); // 30 minutes
+
+    schedule();
 }
 
 Control::~Control(){
@@ -176,6 +178,52 @@ void Control::fastUpdateActuators(){
     }
 }
 
+static void updateSensor(void * sensor){
+    static_cast<TempSensorBasic *>(sensor)->update();
+}
+
+static void updatePid(void * pid){
+    static_cast<Pid *>(pid)->update();
+}
+
+static void updateActuator(void * actuator){
+    static_cast<Actuator *>(actuator)->update();
+}
+
+static void fastUpdateActuator(void * actuator){
+    static_cast<Actuator *>(actuator)->fastUpdate();
+}
+
+static ticks_millis_t fastUpdatePeriod(void * actuator){
+    return static_cast<Actuator *>(actuator)->fastUpdatePeriod();
+}
+
+static void updateMutexGroup(void * mutex){
+    static_cast<ActuatorMutexGroup *>(mutex)->update();
+}
+
+// tasks are added in the same order as in update(), so sensors are read before the pids that use them
+void Control::schedule(){
+    scheduler.clear();
+    for ( auto &sensor : sensors ) {
+        scheduler.add(&updateSensor, sensor, updatePeriod);
+    }
+    for ( auto &pid : pids ) {
+        scheduler.add(&updatePid, pid, updatePeriod);
+    }
+    for ( auto &actuator : actuators ) {
+        scheduler.add(&updateActuator, actuator, updatePeriod);
+    }
+    scheduler.add(&updateMutexGroup, mutex, updatePeriod);
+    for ( auto &actuator : actuators ) {
+        scheduler.addWithPeriodFn(&fastUpdateActuator, actuator, &fastUpdatePeriod); // PWM period can be changed later
+    }
+}
+
+ticks_millis_t Control::runScheduled(){
+    return scheduler.run();
+}
+
 void Control::serialize(JSON::Adapter& adapter){
     JSON::Class root(adapter, "Control");
     JSON_T(adapter, pids);
@@ -184,4 +232,24 @@ void Control::serialize(JSON::Adapter& adapter){
     //JSON_T(adapter, setpoints);
 }
 
+uint8_t Control::getLogValues(int16_t * values, uint8_t maxValues){
+    uint8_t n = 0;
+    for(auto & sensor : sensors){
+        if(n < maxValues){
+            values[n++] = sensor->read().getRaw();
+        }
+    }
+    for(auto & setpoint : setpoints){
+        if(n < maxValues){
+            values[n++] = setpoint->read().getRaw();
+        }
+    }
+    for(auto & pid : pids){
+        if(n < maxValues){
+            values[n++] = pid->getOutputActuator()->getValue().getRaw();
+        }
+    }
+    return n;
+}
+
 Control control;
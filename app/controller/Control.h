@@ -32,6 +32,7 @@
 #include "ActuatorMutexGroup.h"
 #include "json_writer.h"
 #include "ActuatorSetPoint.h"
+#include "UpdateScheduler.h"
 
 class Control
 {
@@ -43,6 +44,16 @@ public:
     void update(); // update everything
     void fastUpdate(); // update things that need fast updating (like PWM)
 
+    /* Runs the updates that are due, with the period each object needs: sensors, pids and actuators every
+     * second and fast actuator updates at their fastUpdatePeriod(). Returns ms until the next update is due.
+     */
+    ticks_millis_t runScheduled();
+
+    // rebuilds the update schedule, call after adding or removing objects
+    void schedule();
+
+    static const ticks_millis_t updatePeriod = 1000; // pids are tuned for updates every second
+
     void updateSensors();
     void updatePids();
     void updateActuators();
@@ -50,6 +61,11 @@ public:
 
     void serialize(JSON::Adapter& adapter);
 
+    /* Writes the values that are stored in the data log: the sensor values, the setpoints and the outputs of the
+     * pids as raw temp_t values. Returns the number of values written, at most maxValues.
+     */
+    uint8_t getLogValues(int16_t * values, uint8_t maxValues);
+
     std::vector<SetPoint*> setpoints;
     std::vector<TempSensorBasic*> sensors;
     std::vector<Pid*>        pids;
@@ -87,6 +103,8 @@ protected:
     SetPointSimple * beer2Set;
     SetPointSimple * fridgeSet;
 
+    UpdateScheduler scheduler;
+
     friend class TempControl;
     friend class DeviceManager;
 };
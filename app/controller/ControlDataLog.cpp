@@ -0,0 +1,73 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ControlDataLog.h"
+
+#if BREWPI_DATA_LOG
+
+#include "Control.h"
+
+ControlDataLog::ControlDataLog() :
+    storage(NULL),
+    logger(NULL),
+    logTime(0),
+    lastSampleTime(0),
+    lastSecond(0)
+{
+}
+
+void ControlDataLog::init(DataLogStorage * s)
+{
+    storage = s;
+    if(!storage){
+        return;
+    }
+    logger = new DataLogger(*storage);
+    logger->begin();
+    // the time that passed during the reset is unknown, continue one interval after the last sample
+    logTime = logger->lastTime() + logInterval;
+    lastSampleTime = logTime - logInterval;
+    lastSecond = ticks.millis();
+}
+
+void ControlDataLog::update()
+{
+    if(!logger){
+        return;
+    }
+    ticks_millis_t elapsed = ticks.timeSinceMillis(lastSecond);
+    if(elapsed < 1000){
+        return;
+    }
+    uint32_t seconds = elapsed / 1000;
+    lastSecond += seconds * 1000;
+    logTime += seconds;
+    if(logTime - lastSampleTime < logInterval){
+        return;
+    }
+    lastSampleTime = logTime;
+
+    int16_t values[DataLog::maxValues];
+    uint8_t numValues = control.getLogValues(values, DataLog::maxValues);
+    logger->append(logTime, values, numValues);
+}
+
+ControlDataLog controlDataLog;
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Brewpi.h"
+
+#if BREWPI_DATA_LOG
+
+#include "DataLog.h"
+#include "Ticks.h"
+
+/*
+ * Stores the values of Control in the data log every logInterval seconds.
+ *
+ * The log time is in seconds. After a reset it continues after the last sample in the log, so it always increases.
+ * The host maps log time to its own clock with the current log time, which is sent with the samples.
+ */
+class ControlDataLog
+{
+public:
+    ControlDataLog();
+    ~ControlDataLog() = default;
+
+    // starts logging to storage, which can be NULL when there is no flash for the log
+    void init(DataLogStorage * storage);
+
+    // appends a sample when logInterval has passed, call at least every second
+    void update();
+
+    uint32_t now() const {
+        return logTime;
+    }
+
+    DataLogStorage * getStorage() const {
+        return storage;
+    }
+
+    static const uint16_t logInterval = 10; // seconds
+
+private:
+    DataLogStorage * storage;
+    DataLogger * logger;
+    uint32_t logTime;
+    uint32_t lastSampleTime;
+    ticks_millis_t lastSecond;
+};
+
+extern ControlDataLog controlDataLog;
+
+#endif
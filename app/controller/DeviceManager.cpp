@@ -41,6 +41,7 @@
 #ifdef WIRING
 
 #include "OneWireTempSensor.h"
+#include "OneWireBusScheduler.h"
 #include "ActuatorOneWire.h"
 #include "DS2413.h"
 #include "OneWire.h"
@@ -111,7 +112,11 @@ void * DeviceManager::createDevice(DeviceConfig & config,
             return new ExternalTempSensor(
                 false);    // initially disconnected, so init doesn't populate the filters with the default value of 0.0
 #else
-            return new OneWireTempSensor(oneWireBus(config.hw.pinNr), config.hw.address, config.hw.offset.calibration);
+            {
+                OneWire * bus = oneWireBus(config.hw.pinNr);
+                return new OneWireTempSensor(bus, config.hw.address, config.hw.offset.calibration,
+                                             OneWireBusScheduler::forBus(bus));
+            }
 #endif
 
 #if BREWPI_DS2413
@@ -448,12 +453,22 @@ bool isUniqueFunction(int8_t f){
  * Updates the device definition. Only changes that result in a valid device, with no conflicts with other devices
  * are allowed.
  */
+// stream the response to a device command is written to when the JSON request has been received
+static Stream * responseStream;
+
 void DeviceManager::parseDeviceDefinition(Stream & p)
 {
-    static DeviceDefinition dev;
+    static DeviceDefinition dev; // static, because the definition is received after this function returns
 
     fill((int8_t *) &dev, sizeof(dev));
-    piLink.parseJson(&handleDeviceDefinition, &dev);
+    responseStream = &p;
+    piLink.parseJson(&handleDeviceDefinition, &dev, &applyDeviceDefinition);
+}
+
+void DeviceManager::applyDeviceDefinition(void * pv)
+{
+    DeviceDefinition & dev = *(DeviceDefinition *) pv;
+    Stream & p = *responseStream;
 
     if (!inRangeInt8(dev.id, 0, MAX_DEVICE_SLOT))    // no device id given, or it's out of range, can't do anything else.
     {
@@ -1090,7 +1105,7 @@ void DeviceManager::enumerateOneWireDevices(EnumerateHardware & h,
 
 void DeviceManager::enumerateHardwareToStream(Stream & p)
 {
-    EnumerateHardware spec;
+    static EnumerateHardware spec;
 
     // set up defaults
     spec.unused   = 0;     // list all devices
@@ -1099,16 +1114,23 @@ void DeviceManager::enumerateHardwareToStream(Stream & p)
     spec.hardware = -1;    // any hardware
     spec.function = 0;     // no function restriction
 
-    piLink.parseJson(handleHardwareSpec, &spec);
+    responseStream = &p;
+    piLink.parseJson(handleHardwareSpec, &spec, &outputHardware);
+}
 
+void DeviceManager::outputHardware(void * pv)
+{
+    EnumerateHardware & spec = *(EnumerateHardware *) pv;
     DeviceCallbackInfo info;
 
-    info.data = &p;
+    info.data = responseStream;
 
     // logDebug("Enumerating Hardware");
     firstDeviceOutput = true;
 
+    piLink.openListResponse('h');
     enumerateHardware(spec, OutputEnumeratedDevices, &info);
+    piLink.closeListResponse();
 
     // logDebug("Enumerating Hardware Complete");
 }
@@ -1206,15 +1228,23 @@ void DeviceManager::UpdateDeviceState(DeviceDisplay & dd,
 
 void DeviceManager::listDevices(Stream & p)
 {
-    DeviceConfig  dc;
-    DeviceDisplay dd;
+    static DeviceDisplay dd;
 
     fill((int8_t *) &dd, sizeof(dd));
 
     dd.empty = 0;
 
-    piLink.parseJson(HandleDeviceDisplay, (void *) &dd);
+    responseStream = &p;
+    piLink.parseJson(HandleDeviceDisplay, (void *) &dd, &outputDevices);
+}
+
+void DeviceManager::outputDevices(void * pv)
+{
+    DeviceDisplay & dd = *(DeviceDisplay *) pv;
+    DeviceConfig  dc;
+    Stream & p = *responseStream;
 
+    piLink.openListResponse('d');
     deviceManager.beginDeviceOutput();
 
     for (device_slot_t idx = 0; deviceManager.allDevices(dc, idx); idx++){
@@ -1227,6 +1257,7 @@ void DeviceManager::listDevices(Stream & p)
             deviceManager.printDevice(idx, dc, val, p);
         }
     }
+    piLink.closeListResponse();
 }
 
 /*
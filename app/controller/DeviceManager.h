@@ -332,6 +332,7 @@ class DeviceManager
         static void uninstallDevice(DeviceConfig & config);
 
         static void parseDeviceDefinition(Stream & p);
+        static void applyDeviceDefinition(void * pv); // called when the device definition has been received
 
         static void printDevice(device_slot_t  slot,
                                 DeviceConfig & config,
@@ -354,6 +355,7 @@ class DeviceManager
      * read hardware spec from stream and output matching devices
      */
         static void enumerateHardwareToStream(Stream & p);
+        static void outputHardware(void * pv); // called when the hardware spec has been received
     
         /*
      * Enumerates the devices detected in the system. Installed devices
@@ -377,6 +379,7 @@ class DeviceManager
                                uint8_t         idx);
 
         static void listDevices(Stream & p);
+        static void outputDevices(void * pv); // called when the device display spec has been received
 	
     private:
         static int8_t enumerateActuatorPins(uint8_t offset);
@@ -29,6 +29,11 @@
 EepromManager eepromManager;
 EepromAccess eepromAccess;
 
+// settings and constants of the active chamber and beer
+static EepromWriteCache<EepromAccess, 2> settingsCache(eepromAccess, EEPROM_WRITE_WINDOW);
+static uint8_t constantsShadow[sizeof(ControlConstants)];
+static uint8_t settingsShadow[sizeof(ControlSettings)];
+
 #define pointerOffset(x) offsetof(EepromFormat, x)
 
 EepromManager::EepromManager()
@@ -38,6 +43,10 @@ EepromManager::EepromManager()
 
 void EepromManager::init() 
 {    
+	eptr_t pv = pointerOffset(chambers);
+	settingsCache.add(pv+offsetof(ChamberBlock, chamberSettings.cc), &tempControl.cc, constantsShadow, sizeof(ControlConstants));
+	settingsCache.add(pv+offsetof(ChamberBlock, beer[0].cs), &tempControl.cs, settingsShadow, sizeof(ControlSettings));
+	settingsCache.sync();
 }
 
 
@@ -51,6 +60,7 @@ void EepromManager::zapEeprom()
 {
 	for (uint16_t offset=0; offset<EepromFormat::MAX_EEPROM_SIZE; offset++)
 		eepromAccess.writeByte(offset, 0);
+	settingsCache.sync();
 }
 
 
@@ -80,6 +90,7 @@ void EepromManager::initializeEeprom()
     // set the version flag - so that storeDevice will work
     eepromAccess.writeByte(0, EEPROM_FORMAT_VERSION);
 
+    settingsCache.sync();
     saveDefaultDevices();
 }
 
@@ -121,21 +132,32 @@ bool EepromManager::applySettings()
 
 void EepromManager::storeTempConstantsAndSettings()
 {
-	uint8_t chamber = 0;
-	eptr_t pv = pointerOffset(chambers);
-	pv += sizeof(ChamberBlock)*chamber;
-	tempControl.storeConstants(pv+offsetof(ChamberBlock, chamberSettings.cc));
+	tempControl.updateConstants();
+	settingsCache.store(&tempControl.cc, ticks.millis());
 		
 	storeTempSettings();
 }
 
 void EepromManager::storeTempSettings()
 {
-	uint8_t chamber = 0;
-	eptr_t pv = pointerOffset(chambers);
-	pv += sizeof(ChamberBlock)*chamber;
-	// for now assume just one beer. 
-	tempControl.storeSettings(pv+offsetof(ChamberBlock, beer[0].cs));	
+	// for now assume just one chamber and one beer, see init()
+	tempControl.settingsStored();
+	settingsCache.store(&tempControl.cs, ticks.millis());
+}
+
+void EepromManager::update()
+{
+	settingsCache.update(ticks.millis());
+}
+
+void EepromManager::flush()
+{
+	settingsCache.flush();
+}
+
+const EepromWriteStats & EepromManager::getWriteStats()
+{
+	return settingsCache.getStats();
 }
 
 bool EepromManager::fetchDevice(DeviceConfig& config, uint8_t deviceIndex)
@@ -24,6 +24,7 @@
 #include "Platform.h"
 
 #include "EepromAccess.h"
+#include "EepromWriteCache.h"
 
 
 void fill(int8_t* p, uint8_t size);
@@ -32,7 +33,10 @@ void clear(uint8_t* p, uint8_t size);
 struct DeviceConfig;
 
 
-// todo - the Eeprom manager should avoid too frequent saves to the eeprom since it supports 100,000 writes. 
+/*
+ * The temp control settings and constants are not written to EEPROM immediately, but after EEPROM_WRITE_WINDOW ms.
+ * Changes within the window are combined and only the bytes that changed are written, to limit flash wear.
+ */
 class EepromManager {
 public:		
 		
@@ -76,6 +80,21 @@ public:
 	 */
 	static void storeTempSettings();
 
+	/**
+	 * Writes the stored settings and constants when the write window has passed. Called from the main loop.
+	 */
+	static void update();
+
+	/**
+	 * Writes the stored settings and constants now, for example before a reset.
+	 */
+	static void flush();
+
+	/**
+	 * Statistics of the writes of settings and constants, to monitor flash wear.
+	 */
+	static const EepromWriteStats & getWriteStats();
+
 	static bool fetchDevice(DeviceConfig& config, uint8_t deviceIndex);
 	static bool storeDevice(const DeviceConfig& config, uint8_t deviceIndex);
 	
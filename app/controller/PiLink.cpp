@@ -40,6 +40,8 @@
 #include "ActuatorMocks.h"
 #include "Control.h"
 #include "json_writer.h"
+#include "Telemetry.h"
+#include "ControlDataLog.h"
 
 #if BREWPI_SIMULATE
 #include "Simulator.h"
@@ -79,6 +81,38 @@ StdIO stdIO;
 #endif
 
 bool PiLink::firstPair;
+
+JsonTokenizer PiLink::jsonTokenizer;
+PiLink::ParseJsonCallback PiLink::jsonCallback;
+PiLink::ParseJsonComplete PiLink::jsonComplete;
+void* PiLink::jsonData;
+ticks_millis_t PiLink::jsonLastReceived;
+bool PiLink::jsonActive = false;
+#if BREWPI_BINARY_TELEMETRY
+bool PiLink::binaryTelemetry = false;
+
+enum TelemetryChannel {
+    TELEMETRY_BEER_TEMP,
+    TELEMETRY_BEER_SET,
+    TELEMETRY_FRIDGE_TEMP,
+    TELEMETRY_FRIDGE_SET,
+    TELEMETRY_ROOM_TEMP,
+    TELEMETRY_STATE,
+    TELEMETRY_CHANNELS
+};
+
+static TelemetryEncoder telemetryEncoder(TELEMETRY_CHANNELS);
+#endif
+
+#if BREWPI_DATA_LOG
+struct DataLogRequest {
+    uint32_t from;
+    uint32_t to;
+};
+static DataLogRequest dataLogRequest;
+static const uint16_t dataLogMaxSamples = 360; // an hour of samples per response, so the loop is not blocked too long
+#endif
+
 char PiLink::printfBuff[PRINTF_BUFFER_SIZE];
 
 void PiLink::init(void){
@@ -154,7 +188,8 @@ bool readCrLf(){
 }
 
 void PiLink::receive(void){
-    while (piStream.available() > 0) {
+    // bytes that belong to a JSON object that is being received are not commands
+    while (feedJson() && piStream.available() > 0) {
         char inByte = piStream.read();
         switch(inByte){
         case ' ':
@@ -207,25 +242,65 @@ void PiLink::receive(void){
         case 'v': // Control variables requested, send Control Object as json
             sendControlVariables();
             break;
+        case 'w': // EEPROM write statistics requested
+            sendEepromWriteStats();
+            break;
+#if BREWPI_BINARY_TELEMETRY
+        case 'B': // switch temperatures to binary telemetry frames
+            if(readCrLf()){
+                binaryTelemetry = true;
+                telemetryEncoder.requestKeyFrame(); // receiver needs all values to start
+            }
+            break;
+        case 'b': // switch temperatures back to JSON
+            if(readCrLf()){
+                binaryTelemetry = false;
+            }
+            break;
+#endif
+#if ONEWIRE_PROFILE
+        case 'o': // OneWire bus profile requested
+            sendOneWireProfile();
+            break;
+        case 'O': // clear OneWire bus profile
+            if(readCrLf()){
+                OneWireProfiler::clear();
+            }
+            break;
+#endif
+#if BREWPI_DATA_LOG
+        case 'H': // data log history requested, for a time range: {"from":<log time>,"to":<log time>}
+            dataLogRequest.from = 0;
+            dataLogRequest.to = UINT32_MAX;
+            parseJson(&processDataLogPair, &dataLogRequest, &sendDataLog);
+            break;
+#endif
         case 'n':
             // v version
             // s shield type
             // y: simulator
             // b: board
+            // l: log messages version
+            // t: binary telemetry version, 0 when not supported
+            // h: data log version, 0 when not supported
             print_P(PSTR(   "N:{"
                     "\"v\":\"" PRINTF_PROGMEM "\","
                     "\"n\":\"" PRINTF_PROGMEM "\","
                     "\"s\":%d,"
                     "\"y\":%d,"
                     "\"b\":\"%c\","
-                    "\"l\":\"%d\""
+                    "\"l\":\"%d\","
+                    "\"t\":%d,"
+                    "\"h\":%d"
                     "}"),
                     PSTR(VERSION_STRING),               // v:
                     PSTR(stringify(BUILD_NAME)),      // n:
                     getShieldVersion(),               // s:
                     BREWPI_SIMULATE,                    // y:
                     BREWPI_BOARD,      // b:
-                    BREWPI_LOG_MESSAGES_VERSION);       // l:
+                    BREWPI_LOG_MESSAGES_VERSION,        // l:
+                    BREWPI_BINARY_TELEMETRY,            // t:
+                    BREWPI_DATA_LOG);                   // h:
             printNewLine();
             break;
         case 'l': // Display content requested
@@ -271,17 +346,13 @@ void PiLink::receive(void){
             }
             break;
         case 'd': // list devices in eeprom order
-            openListResponse('d');
             deviceManager.listDevices(piStream);
-            closeListResponse();
             break;
         case 'U': // update device
             deviceManager.parseDeviceDefinition(piStream);
             break;
         case 'h': // hardware query
-            openListResponse('h');
             deviceManager.enumerateHardwareToStream(piStream);
-            closeListResponse();
             break;
 
 #if (BREWPI_DEBUG > 0)			
@@ -295,12 +366,14 @@ void PiLink::receive(void){
 
         case 'R': // reset
             if(readCrLf()){
+                eepromManager.flush(); // write settings that are still waiting for the write window
                 handleReset();
             }
             break;
 
         case 'F': // flash firmware
             if(readCrLf()){
+                eepromManager.flush();
                 flashFirmware();
             }
             break;
@@ -405,10 +478,38 @@ void PiLink::sendJsonTemp(const char* name, const temp_t & temp)
 }
 
 void PiLink::printTemperatures(void){
+#if BREWPI_BINARY_TELEMETRY
+    if(binaryTelemetry){
+        sendTemperaturesBinary(); // annotations are rare and are still sent as JSON
+        return;
+    }
+#endif
     // print all temperatures with empty annotations
     printTemperaturesJSON(0, 0);
 }
 
+#if BREWPI_BINARY_TELEMETRY
+/*
+ * Sends the same values as printTemperaturesJSON, as raw temp_t values in a binary frame (see Telemetry.h).
+ * Only values that changed since the previous frame are sent, so no formatting with printf is needed.
+ */
+void PiLink::sendTemperaturesBinary(){
+    int16_t values[TELEMETRY_CHANNELS];
+    values[TELEMETRY_BEER_TEMP] = tempControl.getBeerTemp().getRaw();
+    values[TELEMETRY_BEER_SET] = tempControl.getBeerSetting().getRaw();
+    values[TELEMETRY_FRIDGE_TEMP] = tempControl.getFridgeTemp().getRaw();
+    values[TELEMETRY_FRIDGE_SET] = tempControl.getFridgeSetting().getRaw();
+    values[TELEMETRY_ROOM_TEMP] = tempControl.getRoomTemp().getRaw();
+    values[TELEMETRY_STATE] = tempControl.getState();
+
+    uint8_t frame[Telemetry::maxFrameLength];
+    uint8_t length = telemetryEncoder.encode(values, frame);
+    for(uint8_t i = 0; i < length; i++){
+        piStream.write(frame[i]);
+    }
+}
+#endif
+
 void PiLink::printBeerAnnotation(const char * annotation, ...){
     char tempString[128]; // resulting string limited to 128 chars
     va_list args;
@@ -477,6 +578,104 @@ void PiLink::sendControlSettings(void){
     sendJsonClose();
 }
 
+#if ONEWIRE_PROFILE
+/*
+ * Sends the OneWire profile as
+ * O:{"ops":{"reset":{"n":count,"max":us,"h":[histogram]},...},"devs":[{"a":"address","n":count,"crc":errors,"r":retries},...]}
+ * Histogram bucket i counts operations that took less than 2^(i+6) us, the last bucket counts all slower operations.
+ */
+void PiLink::sendOneWireProfile(void){
+    printResponse('O');
+    print_P(PSTR("{\"ops\":{"));
+    for(uint8_t op = 0; op < OneWireProfiler::NUM_OPERATIONS; op++){
+        const OneWireProfiler::OperationStats & stats = OneWireProfiler::getOperation(OneWireProfiler::Operation(op));
+        print_P(PSTR("%s\"%s\":{\"n\":%lu,\"max\":%lu,\"h\":["), (op > 0) ? "," : "",
+                OneWireProfiler::operationName(OneWireProfiler::Operation(op)),
+                (unsigned long) stats.count, (unsigned long) stats.maxMicros);
+        for(uint8_t b = 0; b < OneWireProfiler::numBuckets; b++){
+            print_P(PSTR("%s%lu"), (b > 0) ? "," : "", (unsigned long) stats.buckets[b]);
+        }
+        print_P(PSTR("]}"));
+    }
+    print_P(PSTR("},\"devs\":["));
+    for(uint8_t i = 0; i < OneWireProfiler::getDeviceCount(); i++){
+        const OneWireProfiler::DeviceStats & device = OneWireProfiler::getDevice(i);
+        char addressString[17];
+        printBytes(device.address, 8, addressString);
+        print_P(PSTR("%s{\"a\":\"%s\",\"n\":%lu,\"crc\":%u,\"r\":%u}"), (i > 0) ? "," : "", addressString,
+                (unsigned long) device.transactions, (unsigned int) device.crcErrors, (unsigned int) device.retries);
+    }
+    print_P(PSTR("]}"));
+    printNewLine();
+}
+#endif
+
+/*
+ * st: settings stored, fl: flushes, wr: writes, by: bytes written, pe: flash page erases, pw: flash page writes
+ * The page erases and writes include writes of devices, which do not go through the write window.
+ */
+void PiLink::sendEepromWriteStats(void){
+    const EepromWriteStats & stats = eepromManager.getWriteStats();
+    printResponse('W');
+    print_P(PSTR("{\"st\":%lu,\"fl\":%lu,\"wr\":%lu,\"by\":%lu,\"pe\":%lu,\"pw\":%lu}"),
+            (unsigned long) stats.stores, (unsigned long) stats.flushes, (unsigned long) stats.writes,
+            (unsigned long) stats.bytes, (unsigned long) eepromAccess.pageErases(),
+            (unsigned long) eepromAccess.pageWrites());
+    printNewLine();
+}
+
+#if BREWPI_DATA_LOG
+void PiLink::processDataLogPair(const char * key, const char * val, void* pv){
+    DataLogRequest * request = (DataLogRequest *) pv;
+    if(strcmp_P(key, PSTR("from")) == 0){
+        request->from = strtoul(val, NULL, 10);
+    }
+    else if(strcmp_P(key, PSTR("to")) == 0){
+        request->to = strtoul(val, NULL, 10);
+    }
+}
+
+/*
+ * Sends the samples in the requested time range as [time, values...], with the values as raw temp_t in the order of
+ * Control::getLogValues(). "now" is the current log time, so the host can convert log time to its own clock.
+ * At most dataLogMaxSamples are sent at once. When more is 1, "next" is the time of the first sample that was not sent
+ * and the host requests the rest with that as "from".
+ */
+void PiLink::sendDataLog(void* pv){
+    DataLogRequest * request = (DataLogRequest *) pv;
+    printResponse('H');
+    print_P(PSTR("{\"now\":%lu,\"s\":["), (unsigned long) controlDataLog.now());
+    bool more = false;
+    uint32_t next = 0;
+    DataLogStorage * storage = controlDataLog.getStorage();
+    if(storage){
+        DataLogReader reader(*storage);
+        reader.seek(request->from);
+        DataLogSample sample;
+        uint16_t count = 0;
+        while(reader.next(sample) && sample.time <= request->to){
+            if(count == dataLogMaxSamples){
+                more = true;
+                next = sample.time;
+                break;
+            }
+            print_P(PSTR("%s[%lu"), (count > 0) ? "," : "", (unsigned long) sample.time);
+            for(uint8_t i = 0; i < sample.numValues; i++){
+                print_P(PSTR(",%d"), sample.values[i]);
+            }
+            piStream.print(']');
+            count++;
+        }
+    }
+    print_P(PSTR("],\"more\":%d"), more);
+    if(more){
+        print_P(PSTR(",\"next\":%lu"), (unsigned long) next);
+    }
+    piStream.print('}');
+    printNewLine();
+}
+#endif
+
 // where the offset is relative to. This saves having to store a full 16-bit pointer.
 // becasue the structs are static, we can only compute an offset relative to the struct (cc,cs,cv etc..)
 // rather than offset from tempControl. 
@@ -632,75 +831,61 @@ void PiLink::sendJsonPair(const char * name, uint8_t val) {
     sendJsonPair(name, (uint16_t)val);
 }
 
-int readNext()
+void PiLink::parseJson(ParseJsonCallback fn, void* data, ParseJsonComplete done)
 {
-    uint16_t retries = 0;
-    while (piStream.available()==0) {
-        wait.microseconds(100);
-        retries++;
-        if(retries >= 10000){
-            return -1;
-        }
-    }
-    return piStream.read();
+    jsonTokenizer.reset();
+    jsonCallback = fn;
+    jsonComplete = done;
+    jsonData = data;
+    jsonLastReceived = ticks.millis();
+    jsonActive = true;
+    feedJson(); // handle what is already received, the rest is handled in the next calls to receive()
 }
-/**
- * Parses a token from the piStream.
- * \return true if a token was parsed
- */
-bool parseJsonToken(char* val) {
-    uint8_t index = 0;
-    val[0] = 0;
-    bool result = true;
-    for(;;) // get value
-    {
-        int character = readNext();
-        if (index==29 || character == '}' || character==-1) {
-            result = false;
-            break;
+
+bool PiLink::feedJson(void)
+{
+    if(!jsonActive){
+        return true;
+    }
+    while (piStream.available() > 0) {
+        char c = piStream.read();
+        uint8_t result = jsonTokenizer.feed(c);
+        if(result & JsonTokenizer::PAIR){
+            jsonCallback(jsonTokenizer.key(), jsonTokenizer.value(), jsonData);
         }
-        if(character == ',' || character==':')  // end of value
-            break;
-        if(character == ' ' || character == '"'){
-            ; // skip spaces and apostrophes
+        if(result & JsonTokenizer::ERROR){
+            logErrorInt(ERROR_EXPECTED_BRACKET, jsonTokenizer.error());
         }
-        else
-            val[index++] = character;
+        if(result & (JsonTokenizer::END | JsonTokenizer::ERROR)){
+            endJson();
+            return true;
+        }
+        jsonLastReceived = ticks.millis();
+    }
+    if(ticks.timeSinceMillis(jsonLastReceived) >= jsonTimeout){
+        endJson(); // host stopped sending, finish with the pairs received so far
+        return true;
     }
-    val[index]=0; // null terminate string
-    return result;
+    return false;
 }
 
-void PiLink::parseJson(ParseJsonCallback fn, void* data) 
+void PiLink::endJson(void)
 {
-    char key[30];
-    char val[30];
-    *key = 0;
-    *val = 0;
-    bool next = true;
-    // read first open brace
-    int c = readNext();
-    if (c!='{')
-    {
-        logErrorInt(ERROR_EXPECTED_BRACKET, c);
-        return;
+    jsonActive = false;
+    if(jsonComplete){
+        jsonComplete(jsonData);
     }
-    do {
-        next = parseJsonToken(key) && parseJsonToken(val);
-        if (val[0] && key[0])
-            fn(key, val, data);
-    } while (next);
 }
 
 void PiLink::receiveJson(void){
+    parseJson(&processJsonPair, NULL, &receiveJsonComplete);
+}
 
-    parseJson(&processJsonPair, NULL);
-
+void PiLink::receiveJsonComplete(void* data){
 #if !BREWPI_SIMULATE	// this is quite an overhead and not needed for the simulator
     sendControlSettings();	// update script with new settings
     sendControlConstants();
 #endif
-    return;
 }
 
 
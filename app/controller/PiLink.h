@@ -24,6 +24,8 @@
 #include "temperatureFormats.h"
 #include "DeviceManager.h"
 #include "Logger.h"
+#include "OneWireProfiler.h"
+#include "JsonTokenizer.h"
 
 #define PRINTF_BUFFER_SIZE 128
 
@@ -46,8 +48,13 @@ class PiLink{
 	static void printTemperatures(void);
 	
 	typedef void (*ParseJsonCallback)(const char* key, const char* val, void* data);
+	typedef void (*ParseJsonComplete)(void* data);
 
-	static void parseJson(ParseJsonCallback fn, void* data=NULL);
+	/* Starts parsing a JSON object from the serial port. Parsing does not block: receive() feeds the bytes that are
+	 * available to the tokenizer and calls fn for each key/value pair. done is called when the object is closed,
+	 * invalid or no data is received for jsonTimeout ms.
+	 */
+	static void parseJson(ParseJsonCallback fn, void* data=NULL, ParseJsonComplete done=NULL);
 	
 	private:
 	
@@ -55,8 +62,20 @@ class PiLink{
 	static void receiveControlConstants(void);
 	static void sendControlConstants(void);
 	static void sendControlVariables(void);
+	static void sendEepromWriteStats(void); // send the number of settings writes and flash erases, to monitor wear
+#if ONEWIRE_PROFILE
+	static void sendOneWireProfile(void); // send OneWire latency histograms and error counts per device
+#endif
+#if BREWPI_DATA_LOG
+	static void processDataLogPair(const char * key, const char * val, void* pv); // parse the requested time range
+	static void sendDataLog(void* pv); // send the samples in the data log for the requested time range
+#endif
 	
 	static void receiveJson(void); // receive settings as JSON key:value pairs
+	static void receiveJsonComplete(void* data);
+
+	static bool feedJson(void); // feeds received bytes to the JSON tokenizer, returns false while an object is incomplete
+	static void endJson(void);
 	
 	static void print(char *fmt, ...); // use when format string is stored in RAM
 	static void print(char c)       // inline for arduino
@@ -76,6 +95,10 @@ class PiLink{
 	static void printChamberInfo();
 	
 	static void printTemperaturesJSON(char * beerAnnotation, char * fridgeAnnotation);
+#if BREWPI_BINARY_TELEMETRY
+	static void sendTemperaturesBinary(); // send temperatures and state as a binary telemetry frame
+	static bool binaryTelemetry; // enabled by the host with the 'B' command
+#endif
 	static void sendJsonPair(const char * name, const char * val); // send one JSON pair with a string value as name:val,
 	static void sendJsonPair(const char * name, char val); // send one JSON pair with a char value as name:val,
 	static void sendJsonPair(const char * name, uint16_t val); // send one JSON pair with a uint16_t value as name:val,
@@ -141,6 +164,15 @@ class PiLink{
 
 	private:
 	static bool firstPair;
+
+	// state of the JSON object that is being received
+	static const ticks_millis_t jsonTimeout = 1000;
+	static JsonTokenizer jsonTokenizer;
+	static ParseJsonCallback jsonCallback;
+	static ParseJsonComplete jsonComplete;
+	static void* jsonData;
+	static ticks_millis_t jsonLastReceived;
+	static bool jsonActive;
 	friend class DeviceManager;
 	friend class PiLinkTest;
 	friend class Logger;
@@ -103,6 +103,9 @@ public:
     void loadDefaultConstants(void);
 
     void loadSettingsAndConstants(void);
+    void settingsStored(void) { // called when the settings are stored to EEPROM without storeSettings
+        storedBeerSetting = cs.beerSetting;
+    }
     void updateConstants(void); // copy tempControl to control
 
     tcduration_t timeSinceCooling(void);
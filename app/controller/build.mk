@@ -43,6 +43,14 @@ $(error BOOST_ROOT not set. Download boost and add BOOST_ROOT to your environmen
 endif
 CFLAGS += -I$(BOOST_ROOT)
 
+ifeq ("$(PLATFORM_ID)","3")
+# the virtual device simulates the OneWire hardware, the hardware platforms do not include the simulation
+INCLUDE_DIRS += $(SOURCE_PATH)/lib/sim
+CPPSRC += $(call target_files,lib/sim,*.cpp)
+# virtual_timer.h, so the idle time of the main loop can be skipped in virtual time
+INCLUDE_DIRS += $(SOURCE_PATH)/platform/spark/firmware/hal/src/gcc
+endif
+
 ifeq ("$(PLATFORM_ID)","0")
 # disable freertos for the core, until we have more free space.
 FREERTOS=0
@@ -48,6 +48,30 @@
 #define BREWPI_EEPROM_HELPER_COMMANDS BREWPI_DEBUG || BREWPI_SIMULATE
 #endif
 
+/**
+ * Support binary telemetry frames for the temperatures and state, as an alternative to JSON.
+ * The host enables them with the 'B' command after seeing "t" in the version info.
+ */
+#ifndef BREWPI_BINARY_TELEMETRY
+#define BREWPI_BINARY_TELEMETRY 1
+#endif
+
+/**
+ * Store the control values in a persistent data log, which the host reads with the 'H' command.
+ * Needs a platform_dataLogStorage() that returns flash for the log.
+ */
+#ifndef BREWPI_DATA_LOG
+#define BREWPI_DATA_LOG 0
+#endif
+
+/**
+ * Time in ms that the temp control settings are kept in RAM before they are written to EEPROM.
+ * All changes in this window are written at once, which reduces flash wear when the host sends settings one by one.
+ */
+#ifndef EEPROM_WRITE_WINDOW
+#define EEPROM_WRITE_WINDOW 5000
+#endif
+
 #ifndef OPTIMIZE_GLOBAL
 #define OPTIMIZE_GLOBAL 1
 #endif
@@ -20,6 +20,18 @@ result=$?
 popd
 status $result
 
+pushd lib/bench
+make
+result=$?
+popd
+status $result
+
+pushd lib/tuning
+make
+result=$?
+popd
+status $result
+
 pushd platform/spark 
 ./build-all.sh
 result=$?
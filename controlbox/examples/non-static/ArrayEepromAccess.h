@@ -30,11 +30,28 @@ template <size_t eeprom_size>
 class ArrayEepromAccess : public EepromAccess
 {
 public:
-	ArrayEepromAccess()
+	ArrayEepromAccess() : writeLimit(-1), reads(0)
 	{
 		memset(data, -1, eepromLength());
 	}
 
+	/**
+	 * Simulates a power loss: after the given number of writes, further writes are discarded.
+	 * @param limit The number of writes that are still done, or negative for no limit.
+	 */
+	void setWriteLimit(int limit)
+	{
+		writeLimit = limit;
+	}
+
+	/**
+	 * The number of read calls so far, to compare how often eeprom is accessed.
+	 */
+	uint32_t readCount() const
+	{
+		return reads;
+	}
+
 	void load(std::istream& in)
 	{
         unsigned offset = 0;
@@ -50,6 +67,7 @@ public:
 
 	uint8_t readByte(eptr_t offset) const override
 	{
+		reads++;
 		if (isValidRange(offset, 1))
 			return data[offset];
 		return 0;
@@ -57,7 +75,7 @@ public:
 
 	void writeByte(eptr_t offset, uint8_t value) override
 	{
-		if (isValidRange(offset, 1))
+		if (isValidRange(offset, 1) && writeAllowed())
 		{
 			data[offset] = value;
 			flagChanged();
@@ -66,13 +84,14 @@ public:
 
 	void readBlock(void* target, eptr_t offset, uint16_t size) const override
 	{
+		reads++;
 		if (isValidRange(offset, size))
 			memcpy((uint8_t*) target, &data[offset], size);
 	}
 
 	void writeBlock(eptr_t target, const void* source, uint16_t size) override
 	{
-		if (isValidRange(target, size))
+		if (isValidRange(target, size) && writeAllowed())
 		{
 			memcpy(&data[target], (const uint8_t*) source, size);
 			flagChanged();
@@ -116,6 +135,15 @@ protected:
         changed = false;
     }
 
+	bool writeAllowed()
+	{
+		if (!writeLimit)
+			return false;
+		if (writeLimit>0)
+			writeLimit--;
+		return true;
+	}
+
 	bool isValidRange(uint16_t offset, uint16_t size) const
 	{
 		assert(sizeof(ArrayEepromAccess) > eeprom_size);
@@ -126,5 +154,7 @@ protected:
 private:
 	uint8_t data[eeprom_size];
 	bool changed;
+	int writeLimit;
+	mutable uint32_t reads;
 };
 
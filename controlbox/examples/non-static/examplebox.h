@@ -60,8 +60,12 @@ public:
 
     Box& get_box() { return box; }
 
+    ArrayEepromAccess<1024>& get_eeprom() { return eepromAccess; }
+
     enum class object_type : uint8_t {
-        ValueTicksScaled = 1
+        ValueTicksScaled = 1,
+        ValueInt16 = 2,
+        ValueEeprom = 3
     };
 
     static constexpr inline uint8_t as_int(object_type t) {
@@ -139,6 +143,12 @@ public:
             case as_int(object_type::ValueTicksScaled):
                 return new ScaledTicksValue(ticks);
 
+            case as_int(object_type::ValueInt16):
+                return new TransientValue<int16_t>();
+
+            case as_int(object_type::ValueEeprom):
+                return EepromValue::create(def);
+
             default:
                 return nullFactory(def);
         }
@@ -56,6 +56,16 @@ public:
 	{
 		process();
 		comms_.receive();
+		maintain();
+	}
+
+	/**
+	 * Does a bounded amount of background work, such as compacting the eeprom after objects were deleted.
+	 * @return true while there is more work to do.
+	 */
+	bool maintain()
+	{
+		return systemProfile_.compactStep();
 	}
 
 	/**
@@ -96,6 +106,7 @@ private:
 	            logValuesFlag = false;
 	            logValues(ids);
 	        }
+	        logChangedValues();
 	    }
 	}
 
@@ -107,6 +118,16 @@ private:
 		out.close();
 	}
 
+	/**
+	 * Logs the subscribed values that changed during this update. Nothing is sent when no value changed.
+	 */
+	void logChangedValues()
+	{
+		DataOut& out = comms_.dataOut();
+		if (commands_.logChangedValuesImpl(out, Commands::CMD_LOG_CHANGED_VALUES_AUTO))
+			out.close();
+	}
+
 
 };
 
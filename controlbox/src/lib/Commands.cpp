@@ -199,7 +199,7 @@ void Commands::createObjectCommandHandler(DataIn& _in, DataOut& out)
  * and will be removed from eeprom next time eeprom is compacted.
  */
 void Commands::removeEepromCreateCommand(BufferDataOut& id) {
-	EepromDataIn eepromData cb_nonstatic_decl((eepromAccess));
+	BufferedEepromDataIn eepromData cb_nonstatic_decl((eepromAccess));
 	systemProfile.profileReadRegion(systemProfile.currentProfile(), eepromData);
 	Commands& cmds =
 #if CONTROLBOX_STATIC
@@ -246,8 +246,10 @@ void Commands::deleteObjectCommandHandler(DataIn& in, DataOut& out)
 	BufferDataOut idCapture(buf, MAX_CONTAINER_DEPTH+1);	// buffer to capture id
 	PipeDataIn idPipe(in, idCapture);						// capture read id
 	uint8_t error = deleteObject(idPipe);
-	if (!error)
+	if (!error) {
 		removeEepromCreateCommand(idCapture);
+		systemProfile.requestCompaction();		// done in the background by the control loop
+	}
 	out.write(error);
 }
 
@@ -319,7 +321,7 @@ bool logValuesCallback(Object* o, void* data, const container_id* id, const cont
 }
 
 void Commands::logValuesImpl(container_id* ids, DataOut& out) {
-	walkRoot(systemProfile.rootContainer(), logValuesCallback, NULL, ids);
+	walkRoot(systemProfile.rootContainer(), logValuesCallback, &out, ids);
 }
 
 const uint8_t LOG_FLAGS_IDCHAIN = 1<<0;
@@ -349,7 +351,7 @@ void Commands::logValuesCommandHandler(DataIn& in, DataOut& out) {
         while (id & 0x80);
         BufferDataIn buffer(ids);
 
-		Object* source = lookupUserObject(systemProfile.rootContainer(), buffer);
+		Object* source = lookupUserObject(root, buffer);
 			if (source) {
 				success = true;
 				out.write(0);		// success
@@ -359,7 +361,7 @@ void Commands::logValuesCommandHandler(DataIn& in, DataOut& out) {
     else {
 			success = true;
 			out.write(0);
-        walkContainer(systemProfile.rootContainer(), logValuesCallback, &out, ids, ids);
+        walkContainer(root, logValuesCallback, &out, ids, ids);
     }
 }
 
@@ -367,6 +369,65 @@ void Commands::logValuesCommandHandler(DataIn& in, DataOut& out) {
     		out.write(uint8_t(-1));
 }
 
+/**
+ * Reads an id chain into a buffer of MAX_CONTAINER_DEPTH ids.
+ * @return The length of the id chain, or 0 if the chain is too long.
+ */
+uint8_t readIDChain(DataIn& in, container_id* ids) {
+	uint8_t idx = 0;
+	container_id id;
+	do {
+		id = container_id(in.next());
+		if (idx<MAX_CONTAINER_DEPTH)
+			ids[idx] = id;
+		idx++;
+	} while (id<0 && in.hasNext());
+	return idx<=MAX_CONTAINER_DEPTH ? idx : 0;
+}
+
+/**
+ * Subscribes to a value, so it is logged when it changes.
+ */
+void Commands::subscribeValueCommandHandler(DataIn& in, DataOut& out) {
+	uint8_t flags = in.next();
+	container_id ids[MAX_CONTAINER_DEPTH];
+	uint8_t idLength = readIDChain(in, ids);
+	uint16_t deadband = in.next();
+	deadband |= uint16_t(in.next())<<8;
+	int8_t result = subscriptions.add(ids, idLength, flags & LOG_FLAGS_SYSTEM_CONTAINER, deadband);
+	out.write(uint8_t(result));
+}
+
+/**
+ * Removes the subscription to a value, or all subscriptions when no id is given.
+ */
+void Commands::unsubscribeValueCommandHandler(DataIn& in, DataOut& out) {
+	uint8_t flags = in.next();
+	bool success = true;
+	if (flags & LOG_FLAGS_IDCHAIN) {
+		container_id ids[MAX_CONTAINER_DEPTH];
+		uint8_t idLength = readIDChain(in, ids);
+		success = subscriptions.remove(ids, idLength, flags & LOG_FLAGS_SYSTEM_CONTAINER);
+	}
+	else {
+		subscriptions.clear();
+	}
+	out.write(success ? 0 : uint8_t(-1));
+}
+
+const uint8_t LOG_CHANGED_FLAGS_ALL = 1<<0;
+
+/**
+ * Logs the subscribed values that changed since they were last logged, or all subscribed values when the flag
+ * is set, for example after the host reconnects.
+ */
+void Commands::logChangedValuesCommandHandler(DataIn& in, DataOut& out) {
+	uint8_t flags = in.next();
+	out.write(0);
+	subscriptions.logChanged(systemProfile.rootContainer(), systemProfile.systemContainer(), out, 0,
+			flags & LOG_CHANGED_FLAGS_ALL);
+}
+
 void Commands::resetCommandHandler(DataIn& in, DataOut& out) {
 	uint8_t flags = in.next();
 	if (flags&1)
@@ -407,9 +468,47 @@ CommandHandler Commands::handlers[] = {
 	&Commands::readSystemValueCommandHandler,	// 0x0F
 	&Commands::setSystemValueCommandHandler,	// 0x10
 	&Commands::setMaskValueCommandHandler,		// 0x11
-	&Commands::setSystemMaskValueCommandHandler // 0x12
+	&Commands::setSystemMaskValueCommandHandler, // 0x12
+	&Commands::subscribeValueCommandHandler,	// 0x13
+	&Commands::unsubscribeValueCommandHandler,	// 0x14
+	&Commands::logChangedValuesCommandHandler	// 0x15
 };
 
+/**
+ * Runs the commands in a batch. The response is the number of commands, followed by the response to each command
+ * prefixed with its length. A response that does not fit CONTROLBOX_BATCH_RESPONSE_SIZE has length 0.
+ */
+void Commands::batchCommandHandler(DataIn& in, PipeDataIn& pipeIn, DataOut& out)
+{
+	uint8_t count = pipeIn.next();
+	uint8_t buffer[CONTROLBOX_BATCH_RESPONSE_SIZE+1];		// one extra byte to detect overflow
+	for (uint8_t i=0; i<count && in.hasNext(); i++) {
+		uint8_t length = in.next();
+		RegionDataIn request(in, length);
+		BufferDataOut response(buffer, sizeof(buffer));
+		if (request.hasNext())
+			handleCommand(request, response);
+		while (request.hasNext())		// discard what the command did not read, so the next command is found
+			request.next();
+		uint8_t size = response.bytesWritten();
+		if (size>CONTROLBOX_BATCH_RESPONSE_SIZE)
+			size = 0;
+		out.write(size);
+		out.writeBuffer(buffer, size);
+	}
+}
+
+/**
+ * Runs a command tagged with a sequence number. Requests are handled in the order they are received, so a host can
+ * send several requests without waiting, and match the responses by sequence number.
+ */
+void Commands::sequenceCommandHandler(DataIn& in, PipeDataIn& pipeIn, DataOut& out)
+{
+	pipeIn.next();			// the sequence number
+	if (in.hasNext())
+		handleCommand(in, out);
+}
+
 /*
  * Processes the command request from a data stream.
  * @param dataIn The request data. The first byte is the command id. The stream is assumed to contain at least
@@ -419,7 +518,15 @@ void Commands::handleCommand(DataIn& dataIn, DataOut& dataOut)
 {
 	PipeDataIn pipeIn = PipeDataIn(dataIn, dataOut);	// ensure command input is also piped to output
 	uint8_t cmd_id = pipeIn.next();						// command type code
-	if (cmd_id>sizeof(handlers)/sizeof(handlers[0]))	// check range
+	if (cmd_id==CMD_BATCH) {
+		batchCommandHandler(dataIn, pipeIn, dataOut);
+		return;
+	}
+	if (cmd_id==CMD_SEQUENCE) {
+		sequenceCommandHandler(dataIn, pipeIn, dataOut);
+		return;
+	}
+	if (cmd_id>=sizeof(handlers)/sizeof(handlers[0]))	// check range
 		cmd_id = 0;
 	(
 #if !CONTROLBOX_STATIC
@@ -432,6 +539,7 @@ void Commands::handleCommand(DataIn& dataIn, DataOut& dataOut)
 
 #if CONTROLBOX_STATIC
 Commands commands;
+ValueSubscriptions Commands::subscriptions;
 #endif
 
 
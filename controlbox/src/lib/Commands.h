@@ -26,6 +26,14 @@
 #include "Values.h"
 #include "SystemProfile.h"
 #include "Integration.h"
+#include "ValueSubscriptions.h"
+
+/**
+ * The maximum size of the response to one command in a batch. The responses are buffered to prefix them with the length.
+ */
+#ifndef CONTROLBOX_BATCH_RESPONSE_SIZE
+#define CONTROLBOX_BATCH_RESPONSE_SIZE 64
+#endif
 
 typedef char* pchar;
 typedef const char* cpchar;
@@ -114,14 +122,38 @@ class Commands
 	cb_static void setSystemValueCommandHandler(DataIn& in, DataOut& out);
 	cb_static void setMaskValueCommandHandler(DataIn& in, DataOut& out);
 	cb_static void setSystemMaskValueCommandHandler(DataIn& in, DataOut& out);
+	cb_static void subscribeValueCommandHandler(DataIn& in, DataOut& out);
+	cb_static void unsubscribeValueCommandHandler(DataIn& in, DataOut& out);
+	cb_static void logChangedValuesCommandHandler(DataIn& in, DataOut& out);
+
+	/**
+	 * The batch and sequence commands contain other commands. These read from the request without piping it
+	 * to the response, since the contained commands echo their own request.
+	 */
+	cb_static void batchCommandHandler(DataIn& in, PipeDataIn& pipeIn, DataOut& out);
+	cb_static void sequenceCommandHandler(DataIn& in, PipeDataIn& pipeIn, DataOut& out);
 
 
 	cb_static Object* createObject(DataIn& in, bool dryRun);
 	cb_static void removeEepromCreateCommand(BufferDataOut& id);
 
+	/**
+	 * The values the host subscribed to with the subscribe value command.
+	 */
+	cb_static ValueSubscriptions subscriptions;
+
 public:
 	cb_static void logValuesImpl(container_id* ids, DataOut& out);
 
+	/**
+	 * Logs the subscribed values that changed since they were last reported.
+	 * @param header	Written before the first value. Nothing is written when no value changed.
+	 * @return The number of values logged.
+	 */
+	cb_static uint8_t logChangedValuesImpl(DataOut& out, uint8_t header) {
+		return subscriptions.logChanged(systemProfile.rootContainer(), systemProfile.systemContainer(), out, header);
+	}
+
 #if !CONTROLBOX_STATIC
 private:
 	Comms& comms;
@@ -208,11 +240,17 @@ public:
 		CMD_WRITE_SYSTEM_VALUE = 16,// write the value to a system object
 		CMD_WRITE_MASK_VALUE = 17,	// write a value with a mask to preserve some of the existing value
 		CMD_WRITE_SYSTEM_MASK_VALUE = 18,	// write a system value with a mask to preserve some of the existing value
+		CMD_SUBSCRIBE_VALUE = 19,	// log a value when it changes
+		CMD_UNSUBSCRIBE_VALUE = 20,	// stop logging a value when it changes
+		CMD_LOG_CHANGED_VALUES = 21,	// log the subscribed values that changed since they were last logged
+		CMD_BATCH = 22,				// run several commands and send all responses at once
+		CMD_SEQUENCE = 23,			// run a command tagged with a sequence number, which is echoed in the response
 		CMD_MAX = 127,				// max command value for user-visible commands
 		CMD_SPECIAL_FLAG = 128,
 		CMD_INVALID = CMD_SPECIAL_FLAG | CMD_NONE,						// special value for invalid command in eeprom. Used as a placeholder for incomplete data
 		CMD_DISPOSED_OBJECT = CMD_CREATE_OBJECT | CMD_SPECIAL_FLAG,	// flag in eeprom for object that is now deleted. Allows space to be reclaimed later.
 		CMD_LOG_VALUES_AUTO = CMD_LOG_VALUES | CMD_SPECIAL_FLAG,
+		CMD_LOG_CHANGED_VALUES_AUTO = CMD_LOG_CHANGED_VALUES | CMD_SPECIAL_FLAG,
 	};
 
 };
@@ -521,8 +521,29 @@ inline void Comms::handleCommand(DataIn& in, DataOut& out)
 	cmd_callback(handleCommand(in, out));
 }
 
+/**
+ * Reads a binary frame and processes the command in it. The response is sent as a binary frame.
+ * A frame with an invalid CRC, or that is too long, is answered with an empty frame.
+ */
+void processFrame(
+#if !CONTROLBOX_STATIC
+		Comms& comms,
+#endif
+		StandardConnection* connection)
+{
+    FrameDataIn frameIn(connection->getDataIn());
+    FrameDataOut frameOut(connection->getDataOut());
+    if (frameIn.readFrame() && frameIn.hasNext()) {
+        comms.handleCommand(frameIn, frameOut);
+        connection->getData().request_received = true;
+    }
+    frameOut.close();
+    connection->getData().binary = true;
+}
+
 /**
  * Called when the connection has at least one byte of data for the next command line.
+ * A line starting with framing::END is a binary frame, everything else is hex text.
  */
 void processCommand(
 #if !CONTROLBOX_STATIC
@@ -533,6 +554,14 @@ void processCommand(
     DataIn& dataIn = connection->getDataIn();
     DataOut& dataOut = connection->getDataOut();
     while (dataIn.available()) {
+		  if (dataIn.peek()==framing::END) {
+				processFrame(
+#if !CONTROLBOX_STATIC
+						comms,
+#endif
+						connection);
+				continue;
+		  }
 		  // there is some data ready to be processed											// form this point on, the system will block waiting for a complete command or newline.
 		  TextIn textIn(dataIn);
 		  HexTextToBinaryIn hexIn(textIn);
@@ -543,6 +572,7 @@ void processCommand(
 						  hexIn.next();
 				}
 				connection->getData().request_received = true;
+				connection->getData().binary = false;
 		}
 		hexOut.close();
     }
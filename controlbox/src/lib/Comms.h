@@ -22,6 +22,7 @@
 
 #include "Static.h"
 #include "DataStream.h"
+#include "Framing.h"
 #include <string.h>
 
 #if !CONTROLBOX_STATIC
@@ -233,6 +234,12 @@ struct StandardConnectionDataType
 	 */
 	bool request_received;
 
+	/**
+	 * Set when the last request was a binary frame, cleared when it was hex text.
+	 * Responses use the same format as the request.
+	 */
+	bool binary;
+
 };
 
 /**
@@ -408,9 +415,12 @@ private:
 	Commands* commands_ptr;
 	StandardConnection& connection_;
 	BinaryToHexTextOut hexOut;
+	FrameDataOut frameOut;
+
+	Comms(StandardConnection& connection, DataOut& out) : hexOut(out), frameOut(out), prevConnected(false), reset(false), connection_(connection) {}
 
 public:
-	Comms(StandardConnection& connection) : hexOut(connection.getDataOut()), prevConnected(false), reset(false), connection_(connection) {}
+	Comms(StandardConnection& connection) : Comms(connection, connection.getDataOut()) {}
 
 	void setCommands(Commands& commands)
 	{
@@ -446,8 +456,15 @@ public:
 
 	/**
 	 * Output stream. Used to write data after command processing.
+	 * In static mode this is always hex text, since it is shared by all connections.
 	 */
-	inline cb_static DataOut& dataOut() { return hexOut; }
+#if CONTROLBOX_STATIC
+	inline static DataOut& dataOut() { return hexOut; }
+#else
+	inline DataOut& dataOut() {
+		return connection_.getData().binary ? static_cast<DataOut&>(frameOut) : hexOut;
+	}
+#endif
 };
 
 #if CONTROLBOX_STATIC
@@ -96,6 +96,12 @@ size_t StdIO::write(uint8_t w) {
     return 1;
 }
 
+size_t StdIO::write(const uint8_t* data, size_t len) {
+    size_t written = fwrite(data, 1, len, out);
+    fflush(out);
+    return written;
+}
+
 int StdIO::read() {
     return in.next();
 }
@@ -7,6 +7,8 @@
 #include <string>
 #include <thread>
 #include <queue>
+#include <mutex>
+#include <memory>
 
 class Stream {};
 
@@ -16,46 +18,57 @@ class Stream {};
 
 class InputStreamPoll : public DataIn
 {
-	std::istream& in;
-    std::thread thread;
-	std::queue<uint8_t> queue;
+	// shared with the thread, which can outlive this object
+	struct State {
+		std::istream& in;
+		std::queue<uint8_t> queue;
+		std::mutex mutex;
 
-public:
-	InputStreamPoll(std::istream& in_) : in(in_), thread(std::bind(&InputStreamPoll::run, this)) {}
+		State(std::istream& in_) : in(in_) {}
+	};
 
-	void run()
-	{
-		// make it a daemon thread
-		thread.detach();
+	std::shared_ptr<State> state;
 
-		while (!in.eof())
+	static void run(std::shared_ptr<State> state)
+	{
+		while (!state->in.eof())
 		{
 			char c;
-			in.get(c);
-			queue.push(uint8_t(c));
+			state->in.get(c);
+			std::lock_guard<std::mutex> lock(state->mutex);
+			state->queue.push(uint8_t(c));
 		}
 	}
 
+public:
+	InputStreamPoll(std::istream& in_) : state(std::make_shared<State>(in_)) {
+		// make it a daemon thread
+		std::thread(run, state).detach();
+	}
+
 	unsigned available()
 	{
-		return queue.size()>0;
+		std::lock_guard<std::mutex> lock(state->mutex);
+		return state->queue.size()>0;
 	}
 
 	bool hasNext()
 	{
-		return !in.eof();
+		return !state->in.eof();
 	}
 
 	uint8_t next()
 	{
-		uint8_t front = peek();
-		queue.pop();
+		std::lock_guard<std::mutex> lock(state->mutex);
+		uint8_t front = state->queue.front();
+		state->queue.pop();
 		return front;
 	}
 
 	uint8_t peek()
 	{
-		return queue.front();
+		std::lock_guard<std::mutex> lock(state->mutex);
+		return state->queue.front();
 	}
 };
 
@@ -75,6 +88,7 @@ public:
     int peek();
 
     size_t write(uint8_t w);
+    size_t write(const uint8_t* data, size_t len);
     size_t write(const uint8_t* data, uint8_t len) {
         return write(data, size_t(len));
     }
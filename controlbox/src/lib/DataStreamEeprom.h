@@ -81,6 +81,7 @@ public:
  */
 class EepromDataIn : public DataIn, public EepromStreamRegion
 {
+protected:
 	cb_nonstatic_decl(EepromAccess& eepromAccess;)
 public:
 
@@ -100,3 +101,46 @@ public:
         unsigned available() { return _length; }
 };
 
+
+/**
+ * An eeprom input stream that reads ahead in blocks. Reading a byte at a time is slow when eeprom is emulated in flash,
+ * so this is used to stream through whole profiles. Data that is written behind the read position is not seen again,
+ * but the region ahead must not be changed while reading.
+ */
+class BufferedEepromDataIn : public EepromDataIn
+{
+	uint8_t buffer[32];
+	eptr_t bufferOffset;
+	uint8_t bufferLength;
+
+	bool buffered() {
+		return _offset>=bufferOffset && eptr_t(_offset-bufferOffset)<bufferLength;
+	}
+
+	void fill() {
+		bufferOffset = _offset;
+		bufferLength = uint8_t(_length<sizeof(buffer) ? _length : sizeof(buffer));
+		eepromAccess.readBlock(buffer, bufferOffset, bufferLength);
+	}
+
+public:
+
+	BufferedEepromDataIn(cb_nonstatic_decl(EepromAccess& ea)) : EepromDataIn(cb_nonstatic_decl(ea)), bufferOffset(0), bufferLength(0) {}
+
+	uint8_t peek() override {
+		if (!_length)
+			return EepromDataIn::peek();
+		if (!buffered())
+			fill();
+		return buffer[_offset-bufferOffset];
+	}
+
+	uint8_t next() override {
+		if (!_length)
+			return 0;
+		uint8_t result = peek();
+		_offset++;
+		_length--;
+		return result;
+	}
+};
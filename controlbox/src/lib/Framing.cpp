@@ -0,0 +1,122 @@
+/*
+ * Copyright 2014-2015 Matthew McGowan.
+ *
+ * This file is part of Nice Firmware.
+ *
+ * Controlbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Controlbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Framing.h"
+
+uint16_t framing::crc(uint16_t crc, uint8_t data)
+{
+	crc ^= uint16_t(data)<<8;
+	for (uint8_t i=0; i<8; i++) {
+		crc = (crc & 0x8000) ? uint16_t((crc<<1) ^ 0x1021) : uint16_t(crc<<1);
+	}
+	return crc;
+}
+
+bool FrameDataIn::readFrame()
+{
+	using namespace framing;
+
+	length = 0;
+	pos = 0;
+	uint16_t count = 0;
+	bool escaped = false;
+	bool complete = false;
+	while (_in->hasNext()) {
+		if (!_in->available())
+			continue;
+		uint8_t d = _in->next();
+		if (d==END) {
+			if (count) {
+				complete = true;
+				break;
+			}
+			continue;			// END before the frame, or an empty frame
+		}
+		if (d==ESC) {
+			escaped = true;
+			continue;
+		}
+		if (escaped) {
+			escaped = false;
+			if (d==ESC_END)
+				d = END;
+			else if (d==ESC_ESC)
+				d = ESC;
+		}
+		if (count<sizeof(buffer))
+			buffer[count] = d;
+		count++;
+	}
+
+	if (!complete || count<2 || count>sizeof(buffer))
+		return false;
+
+	uint8_t payload = uint8_t(count-2);
+	uint16_t expected = CRC_INIT;
+	for (uint8_t i=0; i<payload; i++) {
+		expected = crc(expected, buffer[i]);
+	}
+	if (expected!=((buffer[payload]<<8) | buffer[payload+1]))
+		return false;
+
+	length = payload;
+	return true;
+}
+
+void FrameDataOut::writeEscaped(uint8_t data)
+{
+	using namespace framing;
+
+	if (data==END) {
+		_out->write(ESC);
+		data = ESC_END;
+	}
+	else if (data==ESC) {
+		_out->write(ESC);
+		data = ESC_ESC;
+	}
+	_out->write(data);
+}
+
+void FrameDataOut::start()
+{
+	if (!started) {
+		started = true;
+		crc = framing::CRC_INIT;
+		_out->write(framing::END);	// discards any line noise received before the frame
+	}
+}
+
+bool FrameDataOut::write(uint8_t data)
+{
+	start();
+	crc = framing::crc(crc, data);
+	writeEscaped(data);
+	return true;
+}
+
+void FrameDataOut::close()
+{
+	start();
+	uint16_t value = crc;
+	writeEscaped(uint8_t(value>>8));
+	writeEscaped(uint8_t(value));
+	_out->write(framing::END);
+	started = false;
+}
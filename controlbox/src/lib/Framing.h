@@ -0,0 +1,99 @@
+/*
+ * Copyright 2014-2015 Matthew McGowan.
+ *
+ * This file is part of Nice Firmware.
+ *
+ * Controlbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Controlbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "DataStream.h"
+
+/**
+ * The maximum payload size of a binary frame. Longer frames are discarded.
+ */
+#ifndef CONTROLBOX_MAX_FRAME_SIZE
+#define CONTROLBOX_MAX_FRAME_SIZE 128
+#endif
+
+/*
+ * Binary framing of commands and responses, as an alternative to the hex text format.
+ * Each frame is delimited by END bytes and uses SLIP (RFC 1055) byte stuffing, so END never occurs inside a frame.
+ * The payload is followed by a CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF), most significant byte first.
+ */
+namespace framing {
+	const uint8_t END = 0xC0;
+	const uint8_t ESC = 0xDB;
+	const uint8_t ESC_END = 0xDC;
+	const uint8_t ESC_ESC = 0xDD;
+
+	const uint16_t CRC_INIT = 0xFFFF;
+
+	uint16_t crc(uint16_t crc, uint8_t data);
+}
+
+/**
+ * Reads a binary frame from a stream and provides the payload as a DataIn.
+ * The whole frame is buffered, so the CRC is verified before any of the command is processed.
+ */
+class FrameDataIn : public DataIn
+{
+	DataIn* _in;
+	uint8_t buffer[CONTROLBOX_MAX_FRAME_SIZE+2];	// payload and CRC
+	uint8_t length;
+	uint8_t pos;
+
+public:
+	FrameDataIn(DataIn& in) : _in(&in), length(0), pos(0) {}
+
+	/**
+	 * Reads the next frame. END bytes before the frame are skipped. Once the frame has started, this blocks until the
+	 * closing END is received or the stream is closed.
+	 * @return true if a complete frame was received with a valid CRC. The payload is then available from this stream.
+	 */
+	bool readFrame();
+
+	bool hasNext() override { return pos<length; }
+	uint8_t next() override { return hasNext() ? buffer[pos++] : 0; }
+	uint8_t peek() override { return buffer[pos]; }
+	unsigned available() override { return unsigned(length-pos); }
+};
+
+/**
+ * A DataOut decorator that writes the data as a binary frame. close() ends the frame.
+ * Annotations are not supported in binary frames and are discarded.
+ */
+class FrameDataOut : public DataOut
+{
+	DataOut* _out;
+	uint16_t crc;
+	bool started;
+
+	void writeEscaped(uint8_t data);
+	void start();
+
+public:
+	FrameDataOut(DataOut& out) : _out(&out), crc(framing::CRC_INIT), started(false) {}
+
+	bool write(uint8_t data) override;
+
+	void flush() override { _out->flush(); }
+
+	/**
+	 * Writes the CRC and the closing END. When nothing was written, this writes an empty frame.
+	 */
+	void close() override;
+};
@@ -24,25 +24,33 @@
 
 container_id DynamicContainer::next() {
 	container_id sz = _size();
-	for (container_id i=0; i<sz;i++)
-		if (!_items[i])
-			return i;
+	if (slots.free()<sz)
+		return slots.free();
 	return !((sz+1)&0x80) ? sz : -1;
 }
 
 bool DynamicContainer::expand(uint8_t sz)
 {
-	// some useful details on malloc/realloc here - http://www.nongnu.org/avr-libc/user-manual/malloc.html
-	void* _newitems = realloc(_items, sz*sizeof(Object*));
-	if (_newitems) {
-		uint8_t prev_sz = size();
+	if (sz>capacity) {
+		// grow to double the size, so that adding objects one by one needs few reallocations
+		uint8_t newCapacity = capacity*2;
+		if (newCapacity>MAX_CONTAINER_ID+1)
+			newCapacity = MAX_CONTAINER_ID+1;
+		if (newCapacity<sz)
+			newCapacity = sz;
+		// some useful details on malloc/realloc here - http://www.nongnu.org/avr-libc/user-manual/malloc.html
+		void* _newitems = realloc(_items, newCapacity*sizeof(Object*));
+		if (!_newitems)
+			return false;
 		_items = (Object**)_newitems;
-		while (prev_sz<sz)	{
-			assign(prev_sz++, NULL);
-		}
-        setSize(sz);
+		capacity = newCapacity;
 	}
-	return _newitems!=0;
+	uint8_t prev_sz = size();
+	while (prev_sz<sz)	{
+		assign(prev_sz++, NULL);
+	}
+	setSize(sz);
+	return true;
 }
 
 bool DynamicContainer::add(container_id slot, Object* item) {
@@ -50,6 +58,8 @@ bool DynamicContainer::add(container_id slot, Object* item) {
 		return false;
 	remove(slot);
 	assign(slot, item);
+	if (item)
+		slots.added(_items, _size(), slot);
 	return true;
 }
 
@@ -60,6 +70,7 @@ void DynamicContainer::remove(container_id id) {
 	{
 		delete_object(item(id));
 		assign(id, NULL);
+		slots.removed(_items, id);
 	}
 }
 
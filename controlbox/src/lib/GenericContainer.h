@@ -37,7 +37,61 @@ inline void do_prepare(Object* o, void* data) {
                 *result = p;
 }
 
-#define DYNAMIC_CONTAINER_MAINTAIN_SIZE 1
+/**
+ * Tracks which slots of a container are used, so that the next free slot is found without scanning from the start,
+ * and iteration stops at the last object instead of visiting all empty slots after it.
+ * Invariant: all slots below firstFree hold an object, and no slot from end onwards holds an object.
+ */
+class ContainerSlots
+{
+	container_id firstFree;
+	container_id end;
+
+public:
+	ContainerSlots() : firstFree(0), end(0) {}
+
+	/**
+	 * Initializes the tracking from the current contents of the slots.
+	 */
+	void reset(Object** items, container_id size) {
+		firstFree = 0;
+		while (firstFree<size && items[firstFree])
+			firstFree++;
+		end = size;
+		while (end>0 && !items[end-1])
+			end--;
+	}
+
+	/**
+	 * One past the highest slot that holds an object.
+	 */
+	container_id used() const { return end; }
+
+	/**
+	 * The lowest free slot. This is equal to size when all slots are used.
+	 */
+	container_id free() const { return firstFree; }
+
+	/**
+	 * Called after an object was stored in a slot.
+	 */
+	void added(Object** items, container_id size, container_id slot) {
+		if (slot>=end)
+			end = slot+1;
+		while (firstFree<size && items[firstFree])
+			firstFree++;
+	}
+
+	/**
+	 * Called after a slot was cleared.
+	 */
+	void removed(Object** items, container_id slot) {
+		if (slot<firstFree)
+			firstFree = slot;
+		while (end>0 && !items[end-1])
+			end--;
+	}
+};
 
 /**
  * A container whose backing store is allocated dynamically as objects are added.
@@ -46,9 +100,9 @@ class DynamicContainer: public OpenContainer
 {
 	private:
 		Object** _items;	// the items in this container.
-#if DYNAMIC_CONTAINER_MAINTAIN_SIZE
 		container_id sz;
-#endif
+		uint8_t capacity;	// allocated slots, grown in steps to avoid a realloc for each added slot
+		ContainerSlots slots;
 		void assign(container_id id, Object* item) {
 			_items[id] = item;
 		}
@@ -59,7 +113,7 @@ class DynamicContainer: public OpenContainer
             static Object* create(ObjectDefinition& def) { return new DynamicContainer(); }
 
                 void iterate_objects(void* data, ObjectHandler handler) {
-			for (container_id i=0; i<_size(); i++) {
+			for (container_id i=0; i<slots.used(); i++) {
 				// using the function to access the item is requires 10 bytes less space than
 				// directly using _items[i]
 				Object* obj = item(i);
@@ -81,13 +135,12 @@ class DynamicContainer: public OpenContainer
 		DynamicContainer() {
 			_items = (Object**)malloc(sizeof(Object*));
                         assign(0, NULL);
+                        capacity = 1;
                         setSize(0);
 		}
 
                 inline void setSize(container_id size) {
-#if DYNAMIC_CONTAINER_MAINTAIN_SIZE
                     sz = size;
-#endif
                 }
 
 		Object* item(container_id id);
@@ -104,11 +157,7 @@ class DynamicContainer: public OpenContainer
 		container_id size() { return _size(); }
 
 		inline container_id _size() {
-#if DYNAMIC_CONTAINER_MAINTAIN_SIZE			// fetch the block size that preceeds the malloc'ed pointer
-                        return sz;
-#else
-                        return container_id(((pointer_scalar)_items[-3])/sizeof(Object*));
-#endif
+                        return sz;		// the malloc'ed block may be larger, see capacity
 		}
 
 
@@ -131,12 +180,10 @@ template<int SIZE> class StaticTemplateContainer : public OpenContainer
 {
 	private:
 		Object* _items[SIZE];	// the items in this container.
+		ContainerSlots slots;
 
 		container_id freeSlot() {
-			for (int i=0; i<SIZE;i++)
-				if (!_items[i])
-					return i;
-			return -1;
+			return slots.free()<SIZE ? slots.free() : -1;
 		}
 
 		void prepare(Object* item, prepare_t& time) {
@@ -147,14 +194,14 @@ template<int SIZE> class StaticTemplateContainer : public OpenContainer
 	public:
 		prepare_t prepare() {
 			prepare_t time = 0;
-			for (int i=0; i<size(); i++ ) {
+			for (int i=0; i<slots.used(); i++ ) {
 				prepare(item(i), time);
 			}
 			return time;
 		}
 
 		virtual void update() {
-			for (int i=0; i<size(); i++ ) {
+			for (int i=0; i<slots.used(); i++ ) {
 				Object* o = item(i);
 				if (o)
 				o->update();
@@ -178,12 +225,15 @@ template<int SIZE> class StaticTemplateContainer : public OpenContainer
 				return false;
 			remove(slot);
 			_items[slot] = item;
+			if (item)
+				slots.added(_items, SIZE, slot);
 			return true;
 		}
 
 		void remove(container_id id) {
 			delete_object(_items[id]);
 			_items[id] = NULL;
+			slots.removed(_items, id);
 		}
 
 		/*
@@ -210,12 +260,10 @@ class FixedContainer : public OpenContainer
 	private:
 		container_id SIZE;
 		Object** _items;
+		ContainerSlots slots;
 
 		container_id freeSlot() {
-			for (int i=0; i<size();i++)
-				if (!_items[i])
-					return i;
-			return -1;
+			return slots.free()<SIZE ? slots.free() : -1;
 		}
 
 		void prepare(Object* item, prepare_t& time) {
@@ -228,6 +276,7 @@ class FixedContainer : public OpenContainer
 
 		FixedContainer(container_id size, Object** items)
 		: SIZE(size), _items(items) {
+			slots.reset(_items, SIZE);
 		}
 
 
@@ -242,14 +291,14 @@ class FixedContainer : public OpenContainer
 
 		prepare_t prepare() {
 			prepare_t time = 0;
-			for (int i=0; i<size(); i++ ) {
+			for (int i=0; i<slots.used(); i++ ) {
 				prepare(item(i), time);
 			}
 			return time;
 		}
 
 		virtual void update() {
-			for (int i=0; i<size(); i++ ) {
+			for (int i=0; i<slots.used(); i++ ) {
 				Object* o = item(i);
 				if (o)
 				o->update();
@@ -270,12 +319,15 @@ class FixedContainer : public OpenContainer
 				return false;
 			remove(slot);
 			_items[slot] = item;
+			if (item)
+				slots.added(_items, SIZE, slot);
 			return true;
 		}
 
 		void remove(container_id id) {
 			delete_object(_items[id]);
 			_items[id] = NULL;
+			slots.removed(_items, id);
 		}
 
 		/*
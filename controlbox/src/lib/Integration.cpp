@@ -56,6 +56,16 @@ void logValues(container_id* ids)
 	out.close();
 }
 
+/**
+ * Logs the subscribed values that changed during this update.
+ */
+void logChangedValues()
+{
+	DataOut& out = comms.dataOut();
+	if (commands.logChangedValuesImpl(out, Commands::CMD_LOG_CHANGED_VALUES_AUTO))
+		out.close();
+}
+
 
 bool logValuesFlag = false;
 
@@ -88,6 +98,7 @@ void process()
             logValuesFlag = false;
             logValues(ids);
         }
+        logChangedValues();
     }
 }
 
@@ -99,6 +110,7 @@ void controlbox_loop(void)
 {
 	process();
 	Comms::receive();
+	SystemProfile::compactStep();
 }
 
 #endif
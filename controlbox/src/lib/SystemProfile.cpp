@@ -23,6 +23,7 @@
 #include "Ticks.h"
 #include "ValueTicks.h"
 #include "ValuesEeprom.h"
+#include <algorithm>
 
 
 const uint8_t EEPROM_HEADER_SIZE = 2;
@@ -37,6 +38,29 @@ const uint8_t SYSTEM_PROFILE_FAT = SYSTEM_PROFILE_OPEN_END+sizeof(eptr_t);
 const uint8_t SYSTEM_PROFILE_DATA_OFFSET = SYSTEM_PROFILE_FAT + (MAX_SYSTEM_PROFILES*sizeof(eptr_t));
 
 const uint16_t SYSTEM_PROFILE_EEPROM_HEADER = 		uint16_t(SYSTEM_PROFILE_MAGIC)<<8 | SYSTEM_PROFILE_VERSION;
+const uint16_t SYSTEM_PROFILE_EEPROM_HEADER_V1 = 	uint16_t(SYSTEM_PROFILE_MAGIC)<<8 | 0x01;
+
+/**
+ * The compaction journal at the end of eeprom. Before a definition is moved, the move is written to the journal,
+ * so that it can be completed on startup when power is lost during the move. The fields are written while the state
+ * is idle, and the state is a single byte, so the journal is never seen half written.
+ * Version 1 eeprom has no journal, these bytes can hold old profile data. See migrateVersion1().
+ */
+const uint8_t JOURNAL_STATE = 0;		// idle, copying chunk n, writing the gap or shrinking the profile
+const uint8_t JOURNAL_TO = 1;			// 2 bytes, where the definition is moved to, or the new end of the profile
+const uint8_t JOURNAL_FROM = 3;			// 2 bytes, where the definition is moved from
+const uint8_t JOURNAL_LENGTH = 5;		// 2 bytes, the length of the definition
+const uint8_t SYSTEM_PROFILE_JOURNAL_SIZE = 7;
+
+const uint8_t JOURNAL_IDLE = 0xFF;		// erased eeprom
+const uint8_t JOURNAL_COPY_MAX = 0x7F;	// 0..0x7F: copying, the value is the number of chunks already copied
+const uint8_t JOURNAL_GAP = 0x80;		// definition copied, writing the disposed definitions that fill the gap
+const uint8_t JOURNAL_SHRINK = 0x81;	// setting the end of the open profile
+
+/**
+ * The largest disposed definition that fills a gap: command, id, type, length and up to 255 data bytes.
+ */
+const uint16_t MAX_GAP_DEFINITION = 4+255;
 
 typedef int8_t system_profile_t;
 
@@ -64,12 +88,17 @@ cb_static_decl(EepromDataOut SystemProfile::writer;)
 cb_static_decl(profile_id_t SystemProfile::current;)
 cb_static_decl(Container* SystemProfile::root = NULL;)
 cb_static_decl(Container& SystemProfile::systemRoot = systemRootContainer();)
+cb_static_decl(bool SystemProfile::compacting = false;)
+cb_static_decl(bool SystemProfile::compactPending = false;)
+cb_static_decl(eptr_t SystemProfile::compactRead;)
+cb_static_decl(eptr_t SystemProfile::compactWrite;)
 
 
 
 #if !CONTROLBOX_STATIC
 SystemProfile::SystemProfile(EepromAccess& access, Container& systemRootContainer)
-: eepromAccess(access), system_id(access,SYSTEM_PROFILE_ID_OFFSET,1), root(nullptr), systemRoot(systemRootContainer), writer(access) {}
+: eepromAccess(access), system_id(access,SYSTEM_PROFILE_ID_OFFSET,1), root(nullptr), systemRoot(systemRootContainer), writer(access),
+  compacting(false), compactPending(false), compactRead(0), compactWrite(0) {}
 
 #endif
 
@@ -108,8 +137,13 @@ void SystemProfile::initializeEeprom() {
 void SystemProfile::initialize() {
 
 	current = SYSTEM_PROFILE_DEFAULT;
+	compacting = false;
+	compactPending = false;
+	if (readPointer(eepromAccess, 0)==SYSTEM_PROFILE_EEPROM_HEADER_V1) {
+		migrateVersion1();
+	}
 	if (readPointer(eepromAccess, 0)==SYSTEM_PROFILE_EEPROM_HEADER) {
-		// no initialization required
+		recoverCompaction();		// complete a move that was interrupted by a power loss
 	}
 	else {
 		writePointer(eepromAccess, SYSTEM_PROFILE_ID_OFFSET, -1);            // id and reserved
@@ -131,6 +165,19 @@ void SystemProfile::initialize() {
 }
 
 
+/**
+ * Version 1 has no compaction journal, so the profiles could use all of eeprom. When no profile reaches into the
+ * bytes that are now the journal, they are cleared and the header is updated, which keeps the profiles.
+ * Otherwise the header is left at version 1, so the eeprom is re-initialized.
+ * The header is written last, so the migration is repeated when power is lost before it completes.
+ */
+void SystemProfile::migrateVersion1() {
+	if (getProfileOffset(-1)>storageEnd())
+		return;
+	writeEepromRange(eepromAccess, storageEnd(), eepromAccess.length(), JOURNAL_IDLE);
+	writePointer(eepromAccess, 0, SYSTEM_PROFILE_EEPROM_HEADER);
+}
+
 /**
  * Creates a new profile.
  * This enumerates the profile slots, looking for one that has the value 0, meaning unused, and then initializes
@@ -187,10 +234,11 @@ bool SystemProfile::activateProfile(profile_id_t profile) {
 		setCurrentProfile(profile);								// persist the change
 		if (profile>=0) {
 			root = invoke_cmd_method(createRootContainer());
-			EepromDataIn eepromReader cb_nonstatic_decl((eepromAccess));
+			BufferedEepromDataIn eepromReader cb_nonstatic_decl((eepromAccess));
 			profileReadRegion(profile, eepromReader);			// get region in eeprom for the profile
 			streamObjectDefinitions(eepromReader);
 			profileWriteRegion(writer, true);		// reset to available region (allow open profile)
+			requestCompaction();					// finish compaction that was interrupted by a reset
 		}
 		return activated;
 	}
@@ -230,6 +278,8 @@ profile_id_t SystemProfile::deleteProfile(profile_id_t profile) {
         if (!start || profile<0)             // profile not defined
             return 0;
 
+	finishCompaction();		// the open profile is moved below
+
 	eptr_t end = getProfileEnd(profile);
 
 	setProfileOffset(profile, 0);  // mark the slot as available
@@ -243,11 +293,11 @@ profile_id_t SystemProfile::deleteProfile(profile_id_t profile) {
 	}
 
 	// block copy eeprom
-	while (end<eepromAccess.length()) {
+	while (end<storageEnd()) {
 		uint8_t b = eepromAccess.readByte(end++);
 		eepromAccess.writeByte(start++, b);
 	}
-	writeEepromRange(eepromAccess, start, eepromAccess.length(), 0xFF);
+	writeEepromRange(eepromAccess, start, storageEnd(), 0xFF);
 
 	// update the start/end of the writable region
 	profileWriteRegion(writer, true);
@@ -286,9 +336,8 @@ bool deleteDynamicallyAllocatedObject(Object* obj, void* data, const container_i
 void SystemProfile::closeOpenProfile()
 {
 	// if this profile is open, be sure to compact eeprom
-	if (current >= 0 && getProfileEnd(current, true)==eepromAccess.length()) {
-		eptr_t end = compactObjectDefinitions();
-		setProfileOffset(-1, end);
+	if (current >= 0 && getProfileEnd(current, true)==storageEnd()) {
+		compactObjectDefinitions();
 	}
 	// close the writer region
 	profileWriteRegion(writer, false);
@@ -306,7 +355,14 @@ void SystemProfile::deactivateCurrentProfile() {
 
 	// delete all the objects that were dynamically allocated.
 	container_id id[MAX_CONTAINER_DEPTH];				// buffer for id during traversal
-	walkRoot(rootContainer(), deleteDynamicallyAllocatedObject, NULL, id);
+	Commands& cmds =
+#if CONTROLBOX_STATIC
+			commands
+#else
+			*commands_ptr
+#endif
+				;
+	walkRoot(rootContainer(), deleteDynamicallyAllocatedObject, &cmds, id);
 	current = -1;
 
 	if (isDynamicallyAllocated(root))
@@ -366,13 +422,13 @@ void SystemProfile::profileReadRegion(profile_id_t profile, EepromStreamRegion&
  * end is set to the end of the profile.
  */
 eptr_t SystemProfile::getProfileEnd(profile_id_t profile, bool includeOpen)  {
-	eptr_t end = eepromAccess.length();
+	eptr_t end = storageEnd();
 	eptr_t start = getProfileOffset(profile);
 
 	// find smallest profile offset that is greater than the start
 	for (profile_id_t i=-1; i<MAX_SYSTEM_PROFILES; i++) {		// include last profile end
 		eptr_t p = getProfileOffset(i);
-		if ((i!=profile) && (p>=start) && (p<end) && (i>=0 || !includeOpen))		// when i==-1 and !includeOpen then the end is used, otherwise end remains at eepromAccess.length()
+		if ((i!=profile) && (p>=start) && (p<end) && (i>=0 || !includeOpen))		// when i==-1 and !includeOpen then the end is used, otherwise end remains at storageEnd()
 			end = p;
 	}
 	return end;
@@ -428,21 +484,178 @@ bool ObjectDefinitionWalker::writeNext(DataOut& out) {
  * Compacts the eeprom instruction store by removing deleted object definitions.
  *
  * @return The offset where the next eeprom instruction will be stored.
- * This method assumes SystemProfile::writer points to the last written location at the end of the profile.
  */
 eptr_t SystemProfile::compactObjectDefinitions() {
-	EepromDataOut eepromData cb_nonstatic_decl((eepromAccess));
-	profile_id_t current = SystemProfile::currentProfile();
-	profileReadRegion(current, eepromData);
-	listEepromInstructionsTo(current, eepromData);
-	return eepromData.offset();
+	requestCompaction();
+	finishCompaction();
+	return getProfileOffset(-1);
+}
+
+eptr_t SystemProfile::storageEnd() {
+	return eptr_t(eepromAccess.length()-SYSTEM_PROFILE_JOURNAL_SIZE);
+}
+
+void SystemProfile::requestCompaction() {
+	if (compacting) {
+		compactPending = true;		// a definition before compactRead may have been disposed, so do another pass
+		return;
+	}
+	if (current>=0 && getProfileEnd(current, true)==storageEnd()) {	// only the open profile is compacted
+		compacting = true;
+		compactRead = compactWrite = getProfileOffset(current);
+	}
+}
+
+void SystemProfile::finishCompaction() {
+	while (compactStep()) {}
+}
+
+/**
+ * The length of the object definition at the given offset, or 0 if it extends past the end.
+ */
+eptr_t SystemProfile::definitionLength(eptr_t offset, eptr_t end) {
+	eptr_t p = offset+1;								// skip command
+	while (p<end && int8_t(eepromAccess.readByte(p++))<0) {}	// skip id chain
+	eptr_t next = p+2;									// skip type and length
+	if (next>end)
+		return 0;
+	next += eepromAccess.readByte(p+1);					// skip data
+	return next>end ? 0 : next-offset;
+}
+
+/**
+ * Moves a definition down, in chunks no larger than the gap, so that a chunk never overwrites source data that has
+ * not been copied yet. Each chunk is journaled, so the move can be repeated from the last completed chunk.
+ * @param chunk	The number of chunks already copied.
+ */
+void SystemProfile::moveDefinition(eptr_t to, eptr_t from, eptr_t length, uint8_t chunk) {
+	eptr_t journal = storageEnd();
+	eptr_t gap = from-to;
+	uint8_t buffer[16];
+	for (eptr_t done = eptr_t(chunk)*gap; done<length; done += gap) {
+		eptr_t chunkEnd = std::min(eptr_t(done+gap), length);
+		for (eptr_t i=done; i<chunkEnd; i+=sizeof(buffer)) {
+			uint16_t size = std::min(eptr_t(sizeof(buffer)), eptr_t(chunkEnd-i));
+			eepromAccess.readBlock(buffer, from+i, size);
+			eepromAccess.writeBlock(to+i, buffer, size);
+		}
+		eepromAccess.writeByte(journal+JOURNAL_STATE, ++chunk);
+	}
+	eepromAccess.writeByte(journal+JOURNAL_STATE, JOURNAL_GAP);
+}
+
+/**
+ * Fills a region with disposed definitions, so that the profile can be parsed as before.
+ * Only the headers are written, the data of the disposed definitions is whatever is in eeprom.
+ */
+void SystemProfile::writeGap(eptr_t start, eptr_t length) {
+	while (length) {
+		eptr_t size = std::min(length, eptr_t(MAX_GAP_DEFINITION));
+		if (length-size && length-size<4)		// leave enough for the header of the last definition
+			size = length-4;
+		uint8_t header[4] = { Commands::CMD_DISPOSED_OBJECT, 0, 0, uint8_t(size-4) };
+		eepromAccess.writeBlock(start, header, sizeof(header));
+		start += size;
+		length -= size;
+	}
+}
+
+void SystemProfile::shrinkOpenProfile(eptr_t end) {
+	eptr_t journal = storageEnd();
+	writePointer(eepromAccess, journal+JOURNAL_TO, end);
+	eepromAccess.writeByte(journal+JOURNAL_STATE, JOURNAL_SHRINK);
+	setProfileOffset(-1, end);
+	eepromAccess.writeByte(journal+JOURNAL_STATE, JOURNAL_IDLE);
+}
+
+/**
+ * Gives the object that was created from the definition at the given offset its new address.
+ */
+void SystemProfile::relocateObject(eptr_t offset) {
+	EepromDataIn idReader cb_nonstatic_decl((eepromAccess));
+	idReader.reset(offset+1, storageEnd()-offset-1);
+	Object* o = lookupUserObject(rootContainer(), idReader);
+	if (o) {
+		o->relocated(idReader.offset()+2);		// skip type and length, as in rehydrateObject
+	}
+}
+
+/**
+ * Compacts the open profile by one definition. Live definitions are moved down over the disposed ones.
+ * The gap between the processed and the unprocessed definitions is filled with disposed definitions, so the
+ * profile is valid after each step and can be read and changed by commands between steps.
+ */
+bool SystemProfile::compactStep() {
+	if (!compacting)
+		return false;
+
+	eptr_t end = getProfileOffset(-1);		// end of the open profile, which grows when objects are created
+	eptr_t length = compactRead<end ? definitionLength(compactRead, end) : 0;
+	if (!length) {
+		if (compactWrite<compactRead) {
+			shrinkOpenProfile(compactWrite);
+			profileWriteRegion(writer, true);
+		}
+		compacting = false;
+		if (compactPending) {
+			compactPending = false;
+			requestCompaction();
+		}
+		return compacting;
+	}
+
+	if (eepromAccess.readByte(compactRead)!=Commands::CMD_CREATE_OBJECT) {
+		compactRead += length;			// disposed or incomplete, becomes part of the gap
+	}
+	else {
+		if (compactWrite<compactRead) {
+			eptr_t journal = storageEnd();
+			writePointer(eepromAccess, journal+JOURNAL_TO, compactWrite);
+			writePointer(eepromAccess, journal+JOURNAL_FROM, compactRead);
+			writePointer(eepromAccess, journal+JOURNAL_LENGTH, length);
+			eepromAccess.writeByte(journal+JOURNAL_STATE, 0);
+			moveDefinition(compactWrite, compactRead, length, 0);
+			writeGap(compactWrite+length, compactRead-compactWrite);
+			eepromAccess.writeByte(journal+JOURNAL_STATE, JOURNAL_IDLE);
+			relocateObject(compactWrite);
+		}
+		compactWrite += length;
+		compactRead += length;
+	}
+	return true;
+}
+
+/**
+ * Completes the journaled operation when power was lost during compaction. No objects exist yet, so they don't need
+ * to be relocated.
+ */
+void SystemProfile::recoverCompaction() {
+	eptr_t journal = storageEnd();
+	uint8_t state = eepromAccess.readByte(journal+JOURNAL_STATE);
+	if (state==JOURNAL_IDLE)
+		return;
+
+	eptr_t to = readPointer(eepromAccess, journal+JOURNAL_TO);
+	eptr_t from = readPointer(eepromAccess, journal+JOURNAL_FROM);
+	eptr_t length = readPointer(eepromAccess, journal+JOURNAL_LENGTH);
+	if (state==JOURNAL_SHRINK) {
+		if (to>=SYSTEM_PROFILE_DATA_OFFSET && to<=journal)
+			setProfileOffset(-1, to);
+	}
+	else if (to>=SYSTEM_PROFILE_DATA_OFFSET && to<from && from+length<=journal) {
+		if (state<=JOURNAL_COPY_MAX)
+			moveDefinition(to, from, length, state);
+		if (state<=JOURNAL_GAP)
+			writeGap(to+length, from-to);
+	}
+	eepromAccess.writeByte(journal+JOURNAL_STATE, JOURNAL_IDLE);
 }
 
 /**
  * Enumerates all the create object instructions in eeprom to an output stream.
  */
 void SystemProfile::listEepromInstructionsTo(profile_id_t profile, DataOut& out) {
-	EepromDataIn eepromData cb_nonstatic_decl((eepromAccess));
+	BufferedEepromDataIn eepromData cb_nonstatic_decl((eepromAccess));
 	profileReadRegion(profile, eepromData);
 	Commands& cmds =
 #if CONTROLBOX_STATIC
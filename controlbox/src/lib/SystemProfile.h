@@ -45,7 +45,7 @@ static const profile_id_t SYSTEM_PROFILE_DEFAULT = -2;
 static const profile_id_t SYSTEM_PROFILE_NONE = -1;
 
 const uint8_t SYSTEM_PROFILE_MAGIC = 0x69;
-const uint8_t SYSTEM_PROFILE_VERSION = 0x01;
+const uint8_t SYSTEM_PROFILE_VERSION = 0x02;	// 0x02: compaction journal at the end of eeprom
 
 #if CONTROLBOX_STATIC
 
@@ -100,6 +100,28 @@ class SystemProfile {
 	cb_static void closeOpenProfile();
 	cb_static eptr_t compactObjectDefinitions();
 
+	/**
+	 * State of the incremental compaction of the open profile. Definitions before compactRead have been processed,
+	 * the live ones are now below compactWrite. The region between them holds only disposed definitions.
+	 */
+	cb_static bool compacting;
+	cb_static bool compactPending;
+	cb_static eptr_t compactRead;
+	cb_static eptr_t compactWrite;
+
+	/**
+	 * The end of the eeprom used for profiles. The compaction journal is stored after this.
+	 */
+	cb_static eptr_t storageEnd();
+
+	cb_static eptr_t definitionLength(eptr_t offset, eptr_t end);
+	cb_static void moveDefinition(eptr_t to, eptr_t from, eptr_t length, uint8_t chunk);
+	cb_static void writeGap(eptr_t start, eptr_t length);
+	cb_static void shrinkOpenProfile(eptr_t end);
+	cb_static void relocateObject(eptr_t offset);
+	cb_static void recoverCompaction();
+	cb_static void migrateVersion1();
+
 
 	cb_static void streamObjectDefinitions(EepromDataIn& eepromReader);
 
@@ -219,6 +241,23 @@ public:
 
 	cb_static void listDefinedProfiles(DataIn& in, DataOut& out);
 
+	/**
+	 * Requests that deleted object definitions are removed from the open profile. This is done incrementally by
+	 * compactStep(), so that deleting objects does not stall the control loop.
+	 */
+	cb_static void requestCompaction();
+
+	/**
+	 * Does a bounded amount of compaction: at most one object definition is moved.
+	 * @return true while compaction is in progress.
+	 */
+	cb_static bool compactStep();
+
+	/**
+	 * Completes any pending compaction.
+	 */
+	cb_static void finishCompaction();
+
 	cb_static void listEepromInstructionsTo(profile_id_t profile, DataOut& out);
 
 	cb_static void initializeEeprom();
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2014-2015 Matthew McGowan.
+ *
+ * This file is part of Nice Firmware.
+ *
+ * Controlbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Controlbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ValueSubscriptions.h"
+#include "Commands.h"
+#include "Framing.h"
+#include <string.h>
+
+void ValueSubscriptions::clear()
+{
+	for (uint8_t i=0; i<CONTROLBOX_MAX_SUBSCRIPTIONS; i++) {
+		subscriptions[i].idLength = 0;
+	}
+}
+
+uint8_t ValueSubscriptions::count()
+{
+	uint8_t result = 0;
+	for (uint8_t i=0; i<CONTROLBOX_MAX_SUBSCRIPTIONS; i++) {
+		if (subscriptions[i].idLength)
+			result++;
+	}
+	return result;
+}
+
+ValueSubscriptions::Subscription* ValueSubscriptions::find(const container_id* id, uint8_t idLength, bool system)
+{
+	uint8_t flags = system ? SYSTEM : 0;
+	for (uint8_t i=0; i<CONTROLBOX_MAX_SUBSCRIPTIONS; i++) {
+		Subscription& s = subscriptions[i];
+		if (!idLength ? !s.idLength :
+				s.idLength==idLength && (s.flags & SYSTEM)==flags && !memcmp(s.id, id, idLength))
+			return &s;
+	}
+	return NULL;
+}
+
+int8_t ValueSubscriptions::add(const container_id* id, uint8_t idLength, bool system, uint16_t deadband)
+{
+	if (idLength==0 || idLength>MAX_CONTAINER_DEPTH)
+		return -1;
+
+	Subscription* s = find(id, idLength, system);
+	if (!s) {
+		s = find(NULL, 0, false);		// first free slot
+		if (!s)
+			return -1;
+		memcpy(s->id, id, idLength);
+		s->idLength = idLength;
+	}
+	s->flags = system ? SYSTEM : 0;		// not reported yet
+	s->deadband = deadband;
+	s->size = 0;
+	return int8_t(s-subscriptions);
+}
+
+bool ValueSubscriptions::remove(const container_id* id, uint8_t idLength, bool system)
+{
+	Subscription* s = idLength ? find(id, idLength, system) : NULL;
+	if (s)
+		s->idLength = 0;
+	return s!=NULL;
+}
+
+/**
+ * Reads data of 1 to 4 bytes as a little endian signed integer.
+ */
+static int32_t readSigned(const uint8_t* data, uint8_t size)
+{
+	uint32_t result = 0;
+	for (uint8_t i=size; i-->0; ) {
+		result = (result<<8) | data[i];
+	}
+	uint8_t unused = 32-(size*8);
+	return int32_t(result<<unused)>>unused;		// sign extend
+}
+
+/**
+ * Computes the CRC of the data written to it, to detect changes in values that are too large to keep.
+ */
+struct CrcDataOut : public DataOut {
+	uint16_t crc;
+	uint8_t size;
+
+	CrcDataOut() : crc(framing::CRC_INIT), size(0) {}
+
+	virtual bool write(uint8_t data) {
+		crc = framing::crc(crc, data);
+		size++;
+		return true;
+	}
+};
+
+bool ValueSubscriptions::changed(Subscription& s, const uint8_t* data, uint8_t size)
+{
+	if (!(s.flags & REPORTED) || s.size!=size)
+		return true;
+	if (size>CONTROLBOX_SUBSCRIPTION_VALUE_SIZE)
+		return memcmp(data, s.data, sizeof(uint16_t))!=0;	// data is the crc
+	if (s.deadband && size>0 && size<=4) {
+		int32_t delta = readSigned(data, size)-readSigned(s.data, size);
+		return delta>int32_t(s.deadband) || delta<-int32_t(s.deadband);
+	}
+	return memcmp(data, s.data, size)!=0;
+}
+
+uint8_t ValueSubscriptions::logChanged(Container* root, Container* systemRoot, DataOut& out, uint8_t header, bool all)
+{
+	uint8_t written = 0;
+	for (uint8_t i=0; i<CONTROLBOX_MAX_SUBSCRIPTIONS; i++) {
+		Subscription& s = subscriptions[i];
+		if (!s.idLength)
+			continue;
+
+		bool system = s.flags & SYSTEM;
+		Container* c = system ? systemRoot : root;
+		BufferDataIn idIn(s.id);
+		Object* o = c ? lookupObject(c, idIn) : NULL;
+		Value* v = (Value*)o;
+
+		uint8_t data[CONTROLBOX_SUBSCRIPTION_VALUE_SIZE];
+		uint8_t size = 0;
+		obj_type_t type = 0;
+		if (isValue(o)) {
+			type = v->typeID();
+			if (v->streamSize()<=sizeof(data)) {
+				BufferDataOut dataOut(data, sizeof(data));
+				v->readTo(dataOut);
+				size = dataOut.bytesWritten();
+			}
+			else {
+				CrcDataOut crcOut;
+				v->readTo(crcOut);
+				size = crcOut.size;
+				memcpy(data, &crcOut.crc, sizeof(crcOut.crc));
+			}
+		}
+
+		if (!all && !changed(s, data, size))
+			continue;
+
+		if (header && !written)
+			out.write(header);
+		out.write(system ? Commands::CMD_READ_SYSTEM_VALUE : Commands::CMD_READ_VALUE);
+		out.writeBuffer(s.id, s.idLength);
+		out.write(type);
+		out.write(size);
+		if (size>CONTROLBOX_SUBSCRIPTION_VALUE_SIZE)
+			v->readTo(out);
+		else
+			out.writeBuffer(data, size);
+		written++;
+
+		memcpy(s.data, data, size>CONTROLBOX_SUBSCRIPTION_VALUE_SIZE ? sizeof(uint16_t) : size);
+		s.size = size;
+		s.flags |= REPORTED;
+	}
+	return written;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2014-2015 Matthew McGowan.
+ *
+ * This file is part of Nice Firmware.
+ *
+ * Controlbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Controlbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Values.h"
+#include "DataStream.h"
+
+/**
+ * The maximum number of values that can be subscribed to.
+ */
+#ifndef CONTROLBOX_MAX_SUBSCRIPTIONS
+#define CONTROLBOX_MAX_SUBSCRIPTIONS 16
+#endif
+
+/**
+ * The largest subscribed value for which the last reported data is kept to detect changes. Changes in larger values
+ * are detected with a CRC of the data.
+ */
+#ifndef CONTROLBOX_SUBSCRIPTION_VALUE_SIZE
+#define CONTROLBOX_SUBSCRIPTION_VALUE_SIZE 8
+#endif
+
+/**
+ * Values the host has subscribed to. Instead of logging all values in the container hierarchy, only the
+ * subscribed values that changed since they were last reported are logged.
+ *
+ * Each subscription has a deadband. For values of 1 to 4 bytes, which are read as little endian signed integers,
+ * a change is only reported when the value differs more than the deadband from the last reported value. For other
+ * values, and with a deadband of 0, any change in the data is reported. Values larger than
+ * CONTROLBOX_SUBSCRIPTION_VALUE_SIZE are reported when the CRC of their data changes.
+ *
+ * The objects are looked up by id on each check, so subscriptions stay valid when objects are deleted or the
+ * profile is changed. When a subscribed object is no longer a value, it is reported once with size 0.
+ */
+class ValueSubscriptions
+{
+	struct Subscription {
+		container_id id[MAX_CONTAINER_DEPTH];
+		uint8_t idLength;		// 0 for an unused slot
+		uint8_t flags;
+		uint16_t deadband;
+		uint8_t size;			// size of the last reported data
+		uint8_t data[CONTROLBOX_SUBSCRIPTION_VALUE_SIZE];	// the data, or its CRC when it does not fit
+	};
+
+	Subscription subscriptions[CONTROLBOX_MAX_SUBSCRIPTIONS];
+
+	/**
+	 * Finds the subscription with the given id, or the first free slot when idLength is 0.
+	 */
+	Subscription* find(const container_id* id, uint8_t idLength, bool system);
+	bool changed(Subscription& s, const uint8_t* data, uint8_t size);
+
+public:
+	enum Flags {
+		SYSTEM = 1<<0,		// the id is in the system container
+		REPORTED = 1<<1		// the value was reported at least once
+	};
+
+	ValueSubscriptions() {
+		clear();
+	}
+
+	/**
+	 * Subscribes to the value with the given id chain. Subscribing again to the same value changes the deadband
+	 * and reports the value on the next call to logChanged().
+	 * @return The index of the subscription, or -1 if all subscriptions are in use.
+	 */
+	int8_t add(const container_id* id, uint8_t idLength, bool system, uint16_t deadband);
+
+	/**
+	 * @return {@code true} if the value was subscribed to.
+	 */
+	bool remove(const container_id* id, uint8_t idLength, bool system);
+
+	void clear();
+
+	uint8_t count();
+
+	/**
+	 * Writes a record for each subscribed value that changed since it was last reported, in the same format as
+	 * the log values command: the read command id, the id chain, the type, the size and the data.
+	 * The read system value command id is used for values in the system container.
+	 * @param header	When not 0, this is written before the first record, so nothing is written when nothing
+	 *   changed.
+	 * @param all		Write all subscribed values, also when they did not change.
+	 * @return The number of records written.
+	 */
+	uint8_t logChanged(Container* root, Container* systemRoot, DataOut& out, uint8_t header=0, bool all=false);
+};
@@ -84,6 +84,12 @@ struct Object
 	 */
 	virtual void rehydrated(eptr_t eeprom_address) {}
 
+	/**
+	 * Notifies this object that its definition was moved in eeprom while compacting the profile.
+	 * The stored data is unchanged, so objects that read their state on rehydration only need the new address.
+	 */
+	virtual void relocated(eptr_t eeprom_address) { rehydrated(eeprom_address); }
+
 	/**
 	 * Prepare this object for subsequent updates.
 	 * The returned value is the number of milliseconds the object needs before updates can be performed.
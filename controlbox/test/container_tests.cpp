@@ -0,0 +1,150 @@
+#include "catch.hpp"
+#include "GenericContainer.h"
+
+/**
+ * An object that counts how often it is updated.
+ */
+struct CountingObject : public Object
+{
+    int updates = 0;
+
+    virtual void update() override {
+        updates++;
+    }
+};
+
+/**
+ * Checks that the free slot and iteration work the same for each container type.
+ */
+template <typename C>
+void check_slots(C& c, container_id capacity)
+{
+    WHEN("objects are added to the free slots")
+    {
+        CountingObject* objects[4];
+        for (int i=0; i<4; i++) {
+            container_id slot = c.next();
+            REQUIRE(slot==i);
+            objects[i] = new CountingObject();
+            REQUIRE(c.add(slot, objects[i]));
+        }
+
+        THEN("all objects are updated")
+        {
+            c.update();
+            for (int i=0; i<4; i++) {
+                REQUIRE(objects[i]->updates==1);
+            }
+        }
+
+        AND_WHEN("an object in the middle is removed")
+        {
+            c.remove(1);
+
+            THEN("its slot is the next free slot")
+            {
+                REQUIRE(c.next()==1);
+            }
+
+            THEN("the other objects are still updated")
+            {
+                c.update();
+                REQUIRE(objects[0]->updates==1);
+                REQUIRE(objects[2]->updates==1);
+                REQUIRE(objects[3]->updates==1);
+            }
+
+            AND_WHEN("the slot is used again")
+            {
+                REQUIRE(c.add(1, new CountingObject()));
+
+                THEN("the next free slot is after the last object")
+                {
+                    REQUIRE(c.next()==(capacity>4 ? 4 : -1));
+                }
+            }
+        }
+
+        AND_WHEN("the objects are removed from the end")
+        {
+            c.remove(3);
+            c.remove(2);
+
+            THEN("the lowest free slot is next")
+            {
+                REQUIRE(c.next()==2);
+            }
+        }
+    }
+
+    WHEN("an object is added after empty slots")
+    {
+        CountingObject* o = new CountingObject();
+        REQUIRE(c.add(2, o));
+
+        THEN("the first slot is still free")
+        {
+            REQUIRE(c.next()==0);
+        }
+
+        THEN("the object is updated")
+        {
+            c.update();
+            REQUIRE(o->updates==1);
+        }
+    }
+}
+
+SCENARIO("container slots")
+{
+    GIVEN("a dynamic container")
+    {
+        DynamicContainer c;
+        check_slots(c, MAX_CONTAINER_ID);
+
+        WHEN("many objects are added")
+        {
+            for (container_id i=0; i<100; i++) {
+                REQUIRE(c.add(c.next(), new CountingObject()));
+            }
+
+            THEN("the size is the number of used slots")
+            {
+                REQUIRE(c.size()==100);
+                REQUIRE(c.next()==100);
+            }
+        }
+    }
+
+    GIVEN("a static container")
+    {
+        StaticTemplateContainer<6> c;
+        check_slots(c, 6);
+    }
+
+    GIVEN("a fixed container")
+    {
+        Object* items[4] = { };
+        FixedContainer c(4, items);
+        check_slots(c, 4);
+    }
+
+    GIVEN("a fixed container with objects")
+    {
+        CountingObject first, last;
+        Object* items[4] = { &first, nullptr, nullptr, &last };
+        FixedContainer c(4, items);
+
+        THEN("the first empty slot is free")
+        {
+            REQUIRE(c.next()==1);
+        }
+
+        THEN("the objects are updated")
+        {
+            c.update();
+            REQUIRE(first.updates==1);
+            REQUIRE(last.updates==1);
+        }
+    }
+}
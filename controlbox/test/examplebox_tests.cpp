@@ -5,6 +5,8 @@
 #include "catch_output.h"
 
 #include <regex>
+#include <chrono>
+#include <iostream>
 
 SCENARIO("creating a profile is persisted")
 {
@@ -71,7 +73,7 @@ SCENARIO("logging values command")
             THEN("the log should list the created object")
             {
                 INFO("result " << result);
-                REQUIRE(std::regex_match(result, std::regex("00 06 ([[:xdigit:]]{2} ){4}01 00 ")));
+                REQUIRE(std::regex_match(result, std::regex("00 01 00 01 06 ([[:xdigit:]]{2} ){4}01 00 ")));
             }
         }
 
@@ -81,8 +83,407 @@ SCENARIO("logging values command")
             THEN("the log should list the created object")
             {
                 INFO("result " << result);
-                REQUIRE(std::regex_match(result, std::regex("00 06 ([[:xdigit:]]{2} ){4}01 00 ")));
+                REQUIRE(std::regex_match(result, std::regex("00 01 00 01 06 ([[:xdigit:]]{2} ){4}01 00 ")));
             }
         }
     }
 }
+
+SCENARIO("subscribing to values")
+{
+    GIVEN("a box with an int16 value")
+    {
+        ExampleBox box;
+        configure_ticks_example(box);
+        BoxApi api(box.get_box());
+        api.create_object(container_id(1), ExampleBox::as_int(ExampleBox::object_type::ValueInt16));
+
+        WHEN("the value is subscribed to with a deadband of 10")
+        {
+            REQUIRE(api.run_command("13 00 01 0a 00")=="00 ");
+
+            THEN("the value is logged the first time")
+            {
+                REQUIRE(api.run_command("15 00")=="00 01 01 02 02 00 00 ");
+                AND_THEN("it is not logged again when it did not change")
+                {
+                    REQUIRE(api.run_command("15 00")=="00 ");
+                }
+            }
+
+            AND_WHEN("the value changes")
+            {
+                api.run_command("15 00");
+
+                THEN("changes within the deadband are not logged")
+                {
+                    api.run_command("02 01 02 02 0a 00");
+                    REQUIRE(api.run_command("15 00")=="00 ");
+                    api.run_command("02 01 02 02 f6 ff");
+                    REQUIRE(api.run_command("15 00")=="00 ");
+                }
+
+                THEN("changes larger than the deadband are logged")
+                {
+                    api.run_command("02 01 02 02 0b 00");
+                    REQUIRE(api.run_command("15 00")=="00 01 01 02 02 0B 00 ");
+                    api.run_command("02 01 02 02 02 00");
+                    REQUIRE(api.run_command("15 00")=="00 ");	// the change is relative to the last logged value
+                    api.run_command("02 01 02 02 f5 ff");
+                    REQUIRE(api.run_command("15 00")=="00 01 01 02 02 F5 FF ");
+                }
+
+                THEN("all values are logged when requested")
+                {
+                    REQUIRE(api.run_command("15 01")=="00 01 01 02 02 00 00 ");
+                }
+            }
+
+            AND_WHEN("the value is unsubscribed")
+            {
+                REQUIRE(api.run_command("14 01 01")=="00 ");
+                api.run_command("02 01 02 02 64 00");
+
+                THEN("it is not logged")
+                {
+                    REQUIRE(api.run_command("15 00")=="00 ");
+                }
+                THEN("unsubscribing again fails")
+                {
+                    REQUIRE(api.run_command("14 01 01")=="FF ");
+                }
+            }
+
+            AND_WHEN("all values are unsubscribed")
+            {
+                REQUIRE(api.run_command("14 00")=="00 ");
+
+                THEN("nothing is logged")
+                {
+                    REQUIRE(api.run_command("15 01")=="00 ");
+                }
+            }
+        }
+
+        WHEN("an object that is not a value is subscribed to")
+        {
+            REQUIRE(api.run_command("13 00 05 00 00")=="00 ");
+
+            THEN("it is logged once with size 0")
+            {
+                REQUIRE(api.run_command("15 00")=="00 01 05 00 00 ");
+                REQUIRE(api.run_command("15 00")=="00 ");
+            }
+        }
+
+        WHEN("a value that is larger than the kept data is subscribed to")
+        {
+            REQUIRE(api.run_command("03 02 03 0a 00 01 02 03 04 05 06 07 08 09")=="00 ");
+            REQUIRE(api.run_command("13 00 02 00 00")=="00 ");
+
+            THEN("it is logged the first time")
+            {
+                REQUIRE(api.run_command("15 00")=="00 01 02 03 0A 00 01 02 03 04 05 06 07 08 09 ");
+                AND_THEN("it is not logged again when it did not change")
+                {
+                    REQUIRE(api.run_command("15 00")=="00 ");
+                }
+            }
+
+            THEN("every change is logged")
+            {
+                api.run_command("15 00");
+                api.run_command("02 02 03 0a 00 01 02 03 04 05 06 07 08 0a");
+                REQUIRE(api.run_command("15 00")=="00 01 02 03 0A 00 01 02 03 04 05 06 07 08 0A ");
+                api.run_command("02 02 03 0a 10 01 02 03 04 05 06 07 08 0a");
+                REQUIRE(api.run_command("15 00")=="00 01 02 03 0A 10 01 02 03 04 05 06 07 08 0A ");
+                REQUIRE(api.run_command("15 00")=="00 ");
+            }
+        }
+
+        WHEN("all subscriptions are used")
+        {
+            for (int i=0; i<CONTROLBOX_MAX_SUBSCRIPTIONS; i++) {
+                char cmd[20];
+                sprintf(cmd, "13 00 %02x 00 00", i);
+                REQUIRE(api.run_command(cmd)!="FF ");
+            }
+
+            THEN("subscribing to another value fails")
+            {
+                REQUIRE(api.run_command("13 00 7f 00 00")=="FF ");
+            }
+            THEN("subscribing to the same value again succeeds")
+            {
+                REQUIRE(api.run_command("13 00 01 05 00")=="01 ");
+            }
+        }
+    }
+}
+
+/**
+ * Runs a command and returns the complete response as hex text, including the echo of the request.
+ */
+std::string run_raw_command(Box& box, const std::string& cmd)
+{
+    std::stringstream input(cmd);
+    IStreamDataIn dataIn(input);
+    TextIn textIn(dataIn);
+    HexTextToBinaryIn hexIn(textIn);
+
+    std::stringstream output;
+    OStreamDataOut dataOut(output);
+    BinaryToHexTextOut hexOut(dataOut);
+    box.runCommand(hexIn, hexOut);
+    return output.str();
+}
+
+SCENARIO("batch and sequence commands")
+{
+    GIVEN("a box with an int16 value")
+    {
+        ExampleBox box;
+        box.initialize();
+        BoxApi api(box.get_box());
+        Profile p = api.create_profile();
+        api.activate_profile(p);
+        api.create_object(container_id(0), ExampleBox::as_int(ExampleBox::object_type::ValueInt16));
+
+        WHEN("a write and a read are sent in a batch")
+        {
+            std::string result = run_raw_command(box.get_box(), "16 02 06 02 00 02 02 34 12 04 01 00 02 00");
+
+            THEN("the response has the count and each response prefixed with its length")
+            {
+                REQUIRE(result=="16 02 09 02 00 02 02 34 12 02 34 12 07 01 00 02 00 02 34 12 ");
+            }
+        }
+
+        WHEN("a command in a batch does not read all its data")
+        {
+            std::string result = run_raw_command(box.get_box(), "16 02 06 01 00 02 00 ff ff 01 0e");
+
+            THEN("the next command is still found")
+            {
+                REQUIRE(result=="16 02 07 01 00 02 00 02 00 00 03 0E 00 00 ");
+            }
+        }
+
+        WHEN("a response in a batch is too large")
+        {
+            std::string cmd = "16 01 47";
+            for (int i=0; i<0x47; i++) {
+                cmd += " 00";
+            }
+            std::string result = run_raw_command(box.get_box(), cmd);
+
+            THEN("it is returned with length 0")
+            {
+                REQUIRE(result=="16 01 00 ");
+            }
+        }
+
+        WHEN("a command is tagged with a sequence number")
+        {
+            THEN("the response has the sequence number and the response of the command")
+            {
+                REQUIRE(api.run_command("17 05 0e")=="00 00 ");
+                REQUIRE(run_raw_command(box.get_box(), "17 a5 01 00 02 00")=="17 A5 01 00 02 00 02 00 00 ");
+            }
+        }
+    }
+}
+
+/**
+ * Creates a profile with two eeprom values after an object that is deleted, so they are moved by compaction.
+ */
+void configure_compaction_example(ExampleBox& box)
+{
+    box.initialize();
+    BoxApi api(box.get_box());
+    Profile p = api.create_profile();
+    api.activate_profile(p);
+    api.create_object(container_id(0), ExampleBox::as_int(ExampleBox::object_type::ValueInt16));
+    REQUIRE(api.run_command("03 01 03 02 34 12")=="00 ");
+    REQUIRE(api.run_command("03 02 03 02 78 56")=="00 ");
+    REQUIRE(api.run_command("04 00")=="00 ");
+}
+
+SCENARIO("eeprom is compacted in the background")
+{
+    GIVEN("a profile where an object was deleted")
+    {
+        ExampleBox box;
+        configure_compaction_example(box);
+        BoxApi api(box.get_box());
+
+        WHEN("the box does its background work")
+        {
+            int steps = 0;
+            while (box.get_box().maintain())
+                steps++;
+
+            THEN("the work is spread over several steps")
+            {
+                REQUIRE(steps>1);
+            }
+
+            THEN("the moved eeprom values can still be read and written")
+            {
+                REQUIRE(api.run_command("01 01 03 00")=="02 34 12 ");
+                REQUIRE(api.run_command("02 02 03 02 bc 9a")=="02 BC 9A ");
+                REQUIRE(api.run_command("01 02 03 00")=="02 BC 9A ");
+            }
+
+            THEN("the remaining objects are listed")
+            {
+                REQUIRE(api.run_command("05 00")=="03 01 03 02 34 12 03 02 03 02 78 56 ");
+            }
+        }
+
+        WHEN("objects are created and deleted many times")
+        {
+            for (int i=0; i<200; i++) {
+                REQUIRE(api.run_command("03 00 03 04 01 02 03 04")=="00 ");
+                REQUIRE(api.run_command("04 00")=="00 ");
+                while (box.get_box().maintain()) {}
+            }
+
+            THEN("the space of the deleted objects is reused")
+            {
+                REQUIRE(api.run_command("03 00 03 04 01 02 03 04")=="00 ");
+                REQUIRE(api.run_command("01 00 03 00")=="04 01 02 03 04 ");
+            }
+        }
+    }
+
+    GIVEN("power is lost after any number of eeprom writes during compaction")
+    {
+        for (int limit=0; limit<40; limit++) {
+            std::stringstream eeprom;
+            {
+                ExampleBox box;
+                configure_compaction_example(box);
+                box.get_eeprom().setWriteLimit(limit);
+                while (box.get_box().maintain()) {}
+                box.get_eeprom().save(eeprom);
+            }
+
+            ExampleBox box;
+            box.get_eeprom().load(eeprom);
+            box.initialize();
+            BoxApi api(box.get_box());
+
+            INFO("write limit " << limit);
+            REQUIRE(api.run_command("01 01 03 00")=="02 34 12 ");
+            REQUIRE(api.run_command("01 02 03 00")=="02 78 56 ");
+            while (box.get_box().maintain()) {}
+            REQUIRE(api.run_command("05 00")=="03 01 03 02 34 12 03 02 03 02 78 56 ");
+            REQUIRE(api.run_command("02 02 03 02 bc 9a")=="02 BC 9A ");
+            REQUIRE(api.run_command("01 02 03 00")=="02 BC 9A ");
+        }
+    }
+}
+
+SCENARIO("version 1 eeprom is upgraded")
+{
+    GIVEN("a version 1 eeprom with a profile and old data where the compaction journal is now")
+    {
+        ExampleBox box;
+        configure_compaction_example(box);
+        auto& eeprom = box.get_eeprom();
+        eeprom.writeByte(1, 0x01);
+        for (eptr_t i = eeprom.length()-7; i<eeprom.length(); i++) {
+            eeprom.writeByte(i, 0x00);  // looks like a journal that moves 0 bytes from 0 to 0
+        }
+
+        WHEN("the box is started")
+        {
+            std::stringstream saved;
+            eeprom.save(saved);
+            ExampleBox box;
+            box.get_eeprom().load(saved);
+            box.initialize();
+            BoxApi api(box.get_box());
+            auto& eeprom = box.get_eeprom();
+
+            THEN("the profile and its objects are kept")
+            {
+                REQUIRE(api.active_profile().is_valid());
+                REQUIRE(api.run_command("01 01 03 00")=="02 34 12 ");
+                REQUIRE(api.run_command("01 02 03 00")=="02 78 56 ");
+            }
+
+            THEN("the journal is idle and the eeprom is version 2")
+            {
+                REQUIRE(eeprom.readByte(1)==SYSTEM_PROFILE_VERSION);
+                REQUIRE(eeprom.readByte(eeprom.length()-7)==0xFF);
+            }
+        }
+    }
+
+    GIVEN("a version 1 eeprom with a profile that reaches into the compaction journal")
+    {
+        ExampleBox box;
+        configure_compaction_example(box);
+        auto& eeprom = box.get_eeprom();
+        eeprom.writeByte(1, 0x01);
+        eeprom.writeByte(6, (eeprom.length()-3)>>8);    // end of the open profile
+        eeprom.writeByte(7, (eeprom.length()-3)&0xFF);
+
+        WHEN("the box is started")
+        {
+            std::stringstream saved;
+            eeprom.save(saved);
+            ExampleBox box;
+            box.get_eeprom().load(saved);
+            box.initialize();
+            BoxApi api(box.get_box());
+            auto& eeprom = box.get_eeprom();
+
+            THEN("the eeprom is re-initialized")
+            {
+                REQUIRE(api.active_profile().is_valid()==false);
+                REQUIRE(eeprom.readByte(1)==SYSTEM_PROFILE_VERSION);
+                REQUIRE(eeprom.readByte(eeprom.length()-7)==0xFF);
+            }
+        }
+    }
+}
+
+/**
+ * Measures how long it takes to activate a profile with a given number of objects.
+ * Hidden from the normal test run, use `cbtest [benchmark]` to run it.
+ */
+TEST_CASE("profile activation time", "[.][benchmark]")
+{
+    for (int count : { 10, 50, 100 }) {
+        ExampleBox box;
+        box.initialize();
+        BoxApi api(box.get_box());
+        Profile p = api.create_profile();
+        api.activate_profile(p);
+        for (int i=0; i<count; i++) {
+            char cmd[32];
+            snprintf(cmd, sizeof(cmd), "03 %02x 03 02 34 12", i);
+            REQUIRE(api.run_command(cmd)=="00 ");
+        }
+
+        const int repeats = 100;
+        uint32_t reads = box.get_eeprom().readCount();
+        auto start = std::chrono::steady_clock::now();
+        for (int i=0; i<repeats; i++) {
+            REQUIRE(api.run_command("09 ff")=="00 ");
+            REQUIRE(api.run_command("09 00")=="00 ");
+        }
+        auto elapsed = std::chrono::steady_clock::now()-start;
+        reads = box.get_eeprom().readCount()-reads;
+
+        std::cout << count << " objects: "
+            << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()/repeats << " us, "
+            << reads/repeats << " eeprom reads per activation" << std::endl;
+        char cmd[32];
+        snprintf(cmd, sizeof(cmd), "01 %02x 03 00", count-1);
+        REQUIRE(api.run_command(cmd)=="02 34 12 ");
+    }
+}
@@ -0,0 +1,153 @@
+#include "catch.hpp"
+#include "examplebox.h"
+#include "BoxApi.h"
+#include "Framing.h"
+
+#include <vector>
+#include <algorithm>
+
+/**
+ * Collects the written bytes.
+ */
+class VectorDataOut : public DataOut
+{
+public:
+    std::vector<uint8_t> data;
+
+    virtual bool write(uint8_t value) override {
+        data.push_back(value);
+        return true;
+    }
+};
+
+/**
+ * Provides the bytes of a vector as a DataIn.
+ */
+class VectorDataIn : public DataIn
+{
+    std::vector<uint8_t> data;
+    size_t pos;
+
+public:
+    VectorDataIn(const std::vector<uint8_t>& data_) : data(data_), pos(0) {}
+
+    virtual bool hasNext() override { return pos<data.size(); }
+    virtual uint8_t next() override { return data[pos++]; }
+    virtual uint8_t peek() override { return data[pos]; }
+    virtual unsigned available() override { return unsigned(data.size()-pos); }
+};
+
+std::vector<uint8_t> frame(const std::vector<uint8_t>& payload)
+{
+    VectorDataOut out;
+    FrameDataOut frameOut(out);
+    for (uint8_t b : payload) {
+        frameOut.write(b);
+    }
+    frameOut.close();
+    return out.data;
+}
+
+std::vector<uint8_t> unframe(const std::vector<uint8_t>& data, bool& valid)
+{
+    VectorDataIn in(data);
+    FrameDataIn frameIn(in);
+    valid = frameIn.readFrame();
+    std::vector<uint8_t> payload;
+    while (frameIn.hasNext()) {
+        payload.push_back(frameIn.next());
+    }
+    return payload;
+}
+
+SCENARIO("binary frames")
+{
+    GIVEN("a payload that contains the framing bytes")
+    {
+        std::vector<uint8_t> payload = { 0x01, framing::END, 0x02, framing::ESC, framing::ESC_END };
+
+        WHEN("it is framed")
+        {
+            std::vector<uint8_t> data = frame(payload);
+
+            THEN("the frame is delimited by END and contains no other END")
+            {
+                REQUIRE(data.front()==framing::END);
+                REQUIRE(data.back()==framing::END);
+                REQUIRE(std::count(data.begin(), data.end(), framing::END)==2);
+            }
+
+            THEN("reading the frame returns the payload")
+            {
+                bool valid;
+                REQUIRE(unframe(data, valid)==payload);
+                REQUIRE(valid);
+            }
+
+            AND_WHEN("a byte is corrupted")
+            {
+                data[1] ^= 0x10;
+
+                THEN("the frame is rejected")
+                {
+                    bool valid;
+                    REQUIRE(unframe(data, valid).empty());
+                    REQUIRE_FALSE(valid);
+                }
+            }
+
+            AND_WHEN("the frame is truncated")
+            {
+                data.pop_back();
+
+                THEN("the frame is rejected")
+                {
+                    bool valid;
+                    unframe(data, valid);
+                    REQUIRE_FALSE(valid);
+                }
+            }
+        }
+    }
+
+    GIVEN("a payload longer than the maximum frame size")
+    {
+        std::vector<uint8_t> payload(CONTROLBOX_MAX_FRAME_SIZE+1, 0x55);
+
+        THEN("the frame is rejected")
+        {
+            bool valid;
+            unframe(frame(payload), valid);
+            REQUIRE_FALSE(valid);
+        }
+    }
+
+    GIVEN("a command in a binary frame")
+    {
+        ExampleBox box;
+        box.initialize();
+        BoxApi api(box.get_box());
+        Profile p = api.create_profile();
+        api.activate_profile(p);
+
+        VectorDataIn in(frame({ 0x0E }));     // list profiles
+        FrameDataIn frameIn(in);
+        REQUIRE(frameIn.readFrame());
+
+        WHEN("the command is run")
+        {
+            VectorDataOut out;
+            FrameDataOut frameOut(out);
+            box.get_box().runCommand(frameIn, frameOut);
+            frameOut.close();
+
+            THEN("the response is a binary frame with the command, the active profile and the available profiles")
+            {
+                bool valid;
+                std::vector<uint8_t> response = unframe(out.data, valid);
+                REQUIRE(valid);
+                REQUIRE(response==std::vector<uint8_t>({ 0x0E, uint8_t(p.get_id()), uint8_t(p.get_id()) }));
+            }
+        }
+    }
+}
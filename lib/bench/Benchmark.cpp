@@ -0,0 +1,167 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+// Count heap allocations by replacing the global operator new. The control library should not allocate in its
+// update functions, so any allocation that shows up in a hot path is a regression.
+static uint64_t allocations = 0;
+
+void * operator new(size_t size){
+    allocations++;
+    void * p = malloc(size ? size : 1);
+    if(!p){
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void * operator new[](size_t size){
+    return operator new(size);
+}
+
+void operator delete(void * p) noexcept{
+    free(p);
+}
+
+void operator delete[](void * p) noexcept{
+    free(p);
+}
+
+void operator delete(void * p, size_t) noexcept{
+    free(p);
+}
+
+void operator delete[](void * p, size_t) noexcept{
+    free(p);
+}
+
+uint64_t allocationCount(){
+    return allocations;
+}
+
+struct BaselineResult {
+    double ns;
+    double allocs;
+};
+
+static bool json = false;
+static double tolerance = 20.0; // percent slower than baseline that is still accepted
+static std::vector<std::string> filters;
+static std::map<std::string, BaselineResult> baseline;
+static int regressions = 0;
+
+// reads a file written with --json, one result per line
+static bool loadBaseline(const char * fileName){
+    FILE * f = fopen(fileName, "r");
+    if(!f){
+        fprintf(stderr, "cannot open baseline %s\n", fileName);
+        return false;
+    }
+    char line[256];
+    while(fgets(line, sizeof(line), f)){
+        char name[128];
+        BaselineResult r;
+        if(sscanf(line, "{\"name\":\"%127[^\"]\",\"ns\":%lf,\"allocs\":%lf", name, &r.ns, &r.allocs) == 3){
+            baseline[name] = r;
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+bool parseBenchmarkOptions(int argc, char * argv[]){
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--json") == 0){
+            json = true;
+        }
+        else if(strcmp(argv[i], "--baseline") == 0 && i + 1 < argc){
+            if(!loadBaseline(argv[++i])){
+                return false;
+            }
+        }
+        else if(strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc){
+            tolerance = atof(argv[++i]);
+        }
+        else if(argv[i][0] == '-'){
+            fprintf(stderr, "usage: %s [--json] [--baseline file] [--tolerance percent] [name filter...]\n", argv[0]);
+            return false;
+        }
+        else{
+            filters.push_back(argv[i]);
+        }
+    }
+    return true;
+}
+
+bool benchmarkSelected(const char * name){
+    if(filters.empty()){
+        return true;
+    }
+    for(auto & filter : filters){
+        if(strstr(name, filter.c_str())){
+            return true;
+        }
+    }
+    return false;
+}
+
+bool machineReadable(){
+    return json;
+}
+
+int benchmarkRegressions(){
+    return regressions;
+}
+
+void report(const char * name, BenchmarkResult const & result){
+    if(json){
+        printf("{\"name\":\"%s\",\"ns\":%.3f,\"allocs\":%.3f,\"iterations\":%llu}\n",
+                name, result.nsPerIteration, result.allocationsPerIteration, (unsigned long long) result.iterations);
+    }
+    else{
+        printf("%-40s %12.2f ns/op %10.3f allocs/op", name, result.nsPerIteration, result.allocationsPerIteration);
+    }
+
+    auto it = baseline.find(name);
+    if(it != baseline.end()){
+        double change = (result.nsPerIteration / it->second.ns - 1.0) * 100.0;
+        bool slower = change > tolerance;
+        bool allocates = result.allocationsPerIteration > it->second.allocs + 0.001;
+        if(!json){
+            printf(" %+7.1f%%", change);
+        }
+        if(slower || allocates){
+            regressions++;
+            fprintf(stderr, "regression in %s: %.2f ns/op (baseline %.2f), %.3f allocs/op (baseline %.3f)\n",
+                    name, result.nsPerIteration, it->second.ns, result.allocationsPerIteration, it->second.allocs);
+        }
+    }
+    if(!json){
+        printf("\n");
+    }
+    fflush(stdout);
+}
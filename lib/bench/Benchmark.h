@@ -0,0 +1,91 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <stdint.h>
+
+struct BenchmarkResult {
+    double nsPerIteration;
+    double allocationsPerIteration;
+    uint64_t iterations;
+
+    // result per item, for benchmarks that process multiple items per iteration
+    BenchmarkResult per(double items) const {
+        BenchmarkResult r = {nsPerIteration / items, allocationsPerIteration / items, iterations};
+        return r;
+    }
+};
+
+// number of calls to operator new since the start of the program
+uint64_t allocationCount();
+
+/* Measures the time and number of heap allocations per iteration of op, which is called as op(iterations).
+ * The number of iterations is doubled until a run takes at least minSeconds, so the timer resolution and
+ * the loop overhead do not influence the result.
+ */
+template<typename Op>
+BenchmarkResult measure(Op && op, double minSeconds = 0.2){
+    uint64_t iterations = 1;
+    while(true){
+        uint64_t allocations = allocationCount();
+        auto start = std::chrono::steady_clock::now();
+        op(iterations);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        allocations = allocationCount() - allocations;
+        if(elapsed.count() >= minSeconds){
+            BenchmarkResult r = {elapsed.count() * 1e9 / iterations, double(allocations) / iterations, iterations};
+            return r;
+        }
+        iterations *= 2;
+    }
+}
+
+template<typename Op>
+double measureNsPerIteration(Op && op, double minSeconds = 0.2){
+    return measure(op, minSeconds).nsPerIteration;
+}
+
+// prevents the compiler from optimizing away a result that is not used otherwise
+template<typename T>
+inline void doNotOptimize(T const & value){
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/* Benchmarks are selected and reported through these functions, which are configured from the command line.
+ * Names are like "Pid::update" or "FilterCascadedBank::add/64" (parameter after the slash).
+ */
+
+// true when the benchmark with this name should run
+bool benchmarkSelected(const char * name);
+
+// true when results are printed as JSON lines instead of tables for humans
+bool machineReadable();
+
+// prints a result, in the format selected on the command line, and compares it to the baseline if one is loaded
+void report(const char * name, BenchmarkResult const & result);
+
+/* Parses the command line: bench [--json] [--baseline file] [--tolerance percent] [name filter...]
+ * Returns false when the arguments are invalid.
+ */
+bool parseBenchmarkOptions(int argc, char * argv[]);
+
+// number of results that were slower or allocated more than the baseline
+int benchmarkRegressions();
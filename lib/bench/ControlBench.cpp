@@ -0,0 +1,145 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "Pid.h"
+#include "FilterCascaded.h"
+#include "ActuatorPwm.h"
+#include "ActuatorMocks.h"
+#include "ActuatorMutexDriver.h"
+#include "ActuatorMutexGroup.h"
+#include "SetPoint.h"
+#include "TempSensorExternal.h"
+#include "Ticks.h"
+#include <cmath>
+#include <vector>
+
+static const uint32_t numInputs = 1024; // input values, reused when there are more iterations
+
+// slowly varying temperatures with DS18B20 resolution
+static std::vector<temp_t> makeTemperatures(){
+    std::vector<temp_t> temps(numInputs);
+    for(uint32_t i = 0; i < numInputs; i++){
+        double t = 20.0 + 2.0 * sin(i / 50.0);
+        temps[i] = temp_t(floor(t * 16.0) / 16.0);
+    }
+    return temps;
+}
+
+static void benchPidUpdate(std::vector<temp_t> const & temps){
+    if(!benchmarkSelected("Pid::update")){
+        return;
+    }
+    TempSensorExternal sensor(true);
+    sensor.setConnected(true);
+    sensor.setValue(20.0);
+    ActuatorValue actuator(0.0, 0.0, 100.0);
+    SetPointSimple setPoint(21.0);
+    Pid pid(&sensor, &actuator, &setPoint);
+    pid.setConstants(10.0, 600, 60);
+    pid.setInputFilter(1);
+    pid.setDerivativeFilter(2);
+
+    report("Pid::update", measure([&](uint64_t iterations){
+        for(uint64_t i = 0; i < iterations; i++){
+            sensor.setValue(temps[i % numInputs]);
+            pid.update();
+        }
+        doNotOptimize(actuator.getValue());
+    }));
+}
+
+static void benchFilterCascadedAdd(std::vector<temp_t> const & temps){
+    if(!benchmarkSelected("FilterCascaded::add")){
+        return;
+    }
+    std::vector<temp_precise_t> input(temps.begin(), temps.end());
+    FilterCascaded filter;
+    filter.setFiltering(3);
+    filter.init(input[0]);
+
+    report("FilterCascaded::add", measure([&](uint64_t iterations){
+        for(uint64_t i = 0; i < iterations; i++){
+            filter.add(input[i % numInputs]);
+        }
+        doNotOptimize(filter.readOutput());
+    }));
+}
+
+// one fast update per ms, which toggles the output a few times per period
+static void benchPwm(const char * name, ActuatorPwm & pwm){
+    pwm.setValue(37.0);
+    report(name, measure([&](uint64_t iterations){
+        for(uint64_t i = 0; i < iterations; i++){
+            ticks.incMillis(1);
+            pwm.fastUpdate();
+        }
+        doNotOptimize(pwm.readValue());
+    }));
+}
+
+static void benchPwmFastUpdate(){
+    if(benchmarkSelected("ActuatorPwm::fastUpdate")){
+        ActuatorBool pin;
+        ActuatorPwm pwm(&pin, 4);
+        benchPwm("ActuatorPwm::fastUpdate", pwm);
+    }
+    if(benchmarkSelected("ActuatorPwm::fastUpdate/mutex")){
+        // two PWM actuators sharing a mutex group, like heater and cooler
+        ActuatorMutexGroup mutex;
+        ActuatorBool pin1;
+        ActuatorBool pin2;
+        ActuatorMutexDriver driver1(&pin1, &mutex);
+        ActuatorMutexDriver driver2(&pin2, &mutex);
+        ActuatorPwm pwm1(&driver1, 4);
+        ActuatorPwm pwm2(&driver2, 4);
+        pwm2.setValue(20.0);
+        benchPwm("ActuatorPwm::fastUpdate/mutex", pwm1);
+    }
+}
+
+static void benchMutexGroupRequest(){
+    const uint8_t numActuators = 4;
+    if(!benchmarkSelected("ActuatorMutexGroup::request")){
+        return;
+    }
+    ActuatorMutexGroup mutex;
+    ActuatorBool pins[numActuators];
+    for(uint8_t n = 0; n < numActuators; n++){
+        mutex.registerActuator(&pins[n], 0);
+    }
+
+    report("ActuatorMutexGroup::request", measure([&](uint64_t iterations){
+        for(uint64_t i = 0; i < iterations; i++){
+            ActuatorBool & pin = pins[i % numActuators];
+            bool active = (i / numActuators) % 2 == 0;
+            pin.setActive(active && mutex.request(&pin, active, int8_t(i % 128)));
+        }
+        doNotOptimize(pins[0].isActive());
+    }));
+}
+
+void benchControl(){
+    ticks.reset();
+    std::vector<temp_t> temps = makeTemperatures();
+    benchPidUpdate(temps);
+    benchFilterCascadedAdd(temps);
+    benchPwmFastUpdate();
+    benchMutexGroupRequest();
+}
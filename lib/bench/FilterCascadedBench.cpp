@@ -0,0 +1,104 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "FilterCascaded.h"
+#include "FilterCascadedBank.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static const uint32_t numSamples = 1024; // input samples per channel, reused when there are more iterations
+
+// temperatures around 20 degrees with DS18B20 resolution
+static std::vector<temp_precise_t> makeInput(uint16_t channels){
+    std::vector<temp_precise_t> input(numSamples * channels);
+    for(auto & t : input){
+        t = temp_precise_t(temp_t(20.0 + (rand() % 64) / 16.0));
+    }
+    return input;
+}
+
+// time per channel per sample of FilterCascaded, one object per channel
+static BenchmarkResult benchScalar(uint16_t channels, std::vector<temp_precise_t> const & input){
+    std::vector<FilterCascaded> filters(channels);
+    return measure([&](uint64_t iterations){
+        for(uint64_t i = 0; i < iterations; i++){
+            temp_precise_t const * sample = &input[(i % numSamples) * channels];
+            for(uint16_t n = 0; n < channels; n++){
+                filters[n].add(sample[n]);
+            }
+        }
+        doNotOptimize(filters[0].readOutput());
+    }).per(channels);
+}
+
+// time per channel per sample of FilterCascadedBank
+static BenchmarkResult benchBank(uint16_t channels, std::vector<temp_precise_t> const & input){
+    FilterCascadedBank bank(channels);
+    return measure([&](uint64_t iterations){
+        for(uint64_t i = 0; i < iterations; i++){
+            bank.add(&input[(i % numSamples) * channels]);
+        }
+        doNotOptimize(bank.readOutput(0));
+    }).per(channels);
+}
+
+// time per channel per sample of FilterCascadedBank::addBlock, filtering all samples in one call
+static BenchmarkResult benchBankBlock(uint16_t channels, std::vector<temp_precise_t> const & input){
+    FilterCascadedBank bank(channels);
+    std::vector<temp_precise_t> output(input.size());
+    return measure([&](uint64_t iterations){
+        for(uint64_t i = 0; i < iterations; i++){
+            bank.addBlock(input.data(), output.data(), numSamples);
+        }
+        doNotOptimize(output[0]);
+    }).per(channels * double(numSamples));
+}
+
+void benchFilterCascadedBank(){
+    const uint16_t channelCounts[] = {1, 4, 16, 64, 256};
+
+    if(!benchmarkSelected("FilterCascadedBank")){
+        return;
+    }
+    if(!machineReadable()){
+        printf("FilterCascaded vs FilterCascadedBank, ns per channel per sample\n");
+        printf("%8s %10s %10s %10s %8s\n", "channels", "scalar", "bank", "block", "speedup");
+    }
+    for(uint16_t channels : channelCounts){
+        std::vector<temp_precise_t> input = makeInput(channels);
+        BenchmarkResult scalar = benchScalar(channels, input);
+        BenchmarkResult bank = benchBank(channels, input);
+        BenchmarkResult block = benchBankBlock(channels, input);
+        if(machineReadable()){
+            char name[64];
+            snprintf(name, sizeof(name), "FilterCascadedBank::scalar/%u", channels);
+            report(name, scalar);
+            snprintf(name, sizeof(name), "FilterCascadedBank::add/%u", channels);
+            report(name, bank);
+            snprintf(name, sizeof(name), "FilterCascadedBank::addBlock/%u", channels);
+            report(name, block);
+        }
+        else{
+            printf("%8u %10.2f %10.2f %10.2f %7.2fx\n", channels, scalar.nsPerIteration, bank.nsPerIteration,
+                    block.nsPerIteration, scalar.nsPerIteration / bank.nsPerIteration);
+        }
+    }
+}
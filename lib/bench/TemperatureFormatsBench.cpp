@@ -0,0 +1,131 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "temperatureFormats.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static const uint32_t numValues = 256; // operands, reused when there are more iterations
+
+// random temperatures between -50 and 100 degrees
+static std::vector<temp_t> makeTemperatures(){
+    std::vector<temp_t> temps(numValues);
+    for(auto & t : temps){
+        t = temp_t(-50.0 + (rand() % 15000) / 100.0);
+    }
+    return temps;
+}
+
+// benchmarks a binary operator on pairs of operands, the result is accumulated so it cannot be optimized away
+template<typename T, typename Op>
+static void benchOperator(const char * name, std::vector<T> const & a, std::vector<T> const & b, Op && op){
+    if(!benchmarkSelected(name)){
+        return;
+    }
+    report(name, measure([&](uint64_t iterations){
+        T sum = T(0.0);
+        for(uint64_t i = 0; i < iterations; i++){
+            sum += op(a[i % numValues], b[(i + 7) % numValues]);
+        }
+        doNotOptimize(sum);
+    }));
+}
+
+static void benchArithmetic(std::vector<temp_t> const & temps){
+    std::vector<temp_t> small(numValues); // second operand between 0.5 and 2.5, so products do not saturate
+    for(uint32_t i = 0; i < numValues; i++){
+        small[i] = temp_t(0.5 + (i % 200) / 100.0);
+    }
+    std::vector<temp_long_t> longTemps(temps.begin(), temps.end());
+    std::vector<temp_long_t> longSmall(small.begin(), small.end());
+    std::vector<temp_precise_t> preciseTemps(temps.begin(), temps.end());
+    std::vector<temp_precise_t> preciseSmall(small.begin(), small.end());
+
+    benchOperator("temp_t::operator+", temps, temps, [](temp_t a, temp_t b){ return a + b; });
+    benchOperator("temp_t::operator-", temps, temps, [](temp_t a, temp_t b){ return a - b; });
+    benchOperator("temp_t::operator*", temps, small, [](temp_t a, temp_t b){ return a * b; });
+    benchOperator("temp_t::operator/", temps, small, [](temp_t a, temp_t b){ return a / b; });
+    benchOperator("temp_long_t::operator*", longTemps, longSmall, [](temp_long_t a, temp_long_t b){ return a * b; });
+    benchOperator("temp_long_t::operator/", longTemps, longSmall, [](temp_long_t a, temp_long_t b){ return a / b; });
+    benchOperator("temp_precise_t::operator+", preciseTemps, preciseSmall,
+            [](temp_precise_t a, temp_precise_t b){ return a + b; });
+    benchOperator("temp_precise_t::operator*", preciseTemps, preciseSmall,
+            [](temp_precise_t a, temp_precise_t b){ return a * b; });
+}
+
+// raw values of a temperature format, for the string conversion benchmarks
+template<typename T>
+static std::vector<int32_t> rawValues(std::vector<temp_t> const & temps){
+    std::vector<int32_t> raws;
+    for(auto const & t : temps){
+        raws.push_back(T(t).getRaw());
+    }
+    return raws;
+}
+
+static void benchToString(const char * name, std::vector<int32_t> const & raws, unsigned char F,
+        uint8_t numDecimals, char format){
+    if(!benchmarkSelected(name)){
+        return;
+    }
+    char buf[16];
+    report(name, measure([&](uint64_t iterations){
+        for(uint64_t i = 0; i < iterations; i++){
+            toStringImpl(raws[i % numValues], F, buf, numDecimals, 15, format, true);
+        }
+        doNotOptimize(buf[0]);
+    }));
+}
+
+static void benchFromString(const char * name, std::vector<int32_t> const & raws, unsigned char F,
+        uint8_t numDecimals, char format, int32_t minimum, int32_t maximum){
+    if(!benchmarkSelected(name)){
+        return;
+    }
+    std::vector<char> strings(numValues * 16);
+    for(uint32_t i = 0; i < numValues; i++){
+        toStringImpl(raws[i], F, &strings[i * 16], numDecimals, 15, format, true);
+    }
+    report(name, measure([&](uint64_t iterations){
+        int32_t raw = 0;
+        for(uint64_t i = 0; i < iterations; i++){
+            fromStringImpl(&raw, F, &strings[(i % numValues) * 16], format, true, minimum, maximum);
+        }
+        doNotOptimize(raw);
+    }));
+}
+
+void benchTemperatureFormats(){
+    std::vector<temp_t> temps = makeTemperatures();
+    benchArithmetic(temps);
+
+    std::vector<int32_t> raws = rawValues<temp_t>(temps);
+    std::vector<int32_t> preciseRaws = rawValues<temp_precise_t>(temps);
+    const unsigned char F = temp_t::fractional_bit_count;
+    const unsigned char preciseF = temp_precise_t::fractional_bit_count;
+    benchToString("toStringImpl/C", raws, F, 2, 'C');
+    benchToString("toStringImpl/F", raws, F, 2, 'F');
+    benchToString("toStringImpl/precise", preciseRaws, preciseF, 8, 'C');
+    benchFromString("fromStringImpl/C", raws, F, 3, 'C', temp_t::min_val, temp_t::max_val);
+    benchFromString("fromStringImpl/F", raws, F, 3, 'F', temp_t::min_val, temp_t::max_val);
+    benchFromString("fromStringImpl/precise", preciseRaws, preciseF, 8, 'C',
+            temp_precise_t::min_val, temp_precise_t::max_val);
+}
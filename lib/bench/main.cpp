@@ -0,0 +1,44 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Platform.h"
+#include "Ticks.h"
+#include "Benchmark.h"
+
+ExternalTicks ticks;
+NoOpDelay wait;
+
+void benchFilterCascadedBank();
+void benchControl();
+void benchTemperatureFormats();
+
+/* Runs all benchmarks, or only those whose name contains one of the filters on the command line.
+ * Use --json to write one result per line. A file written with --json can be passed as --baseline to a later run,
+ * which then exits with status 1 when a benchmark is more than --tolerance percent (default 20) slower or
+ * allocates more than in the baseline.
+ */
+int main(int argc, char * argv[]){
+    if(!parseBenchmarkOptions(argc, argv)){
+        return 2;
+    }
+    benchControl();
+    benchTemperatureFormats();
+    benchFilterCascadedBank();
+    return benchmarkRegressions() ? 1 : 0;
+}
@@ -46,6 +46,7 @@ public:
     virtual uint8_t type() const = 0;
     virtual void update() = 0; // period update (every second)
     virtual void fastUpdate() = 0; // fast update (as often as possible)
+    virtual uint16_t fastUpdatePeriod() const { return 0; } // ms between fast updates, 0 is as often as possible
 
 	friend class ActuatorMixin;
 };
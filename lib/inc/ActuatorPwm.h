@@ -105,6 +105,15 @@ public:
      */
     void fastUpdate() override final;
 
+    /** Toggle times only need to be accurate to a fraction of the period.
+     * A 4s heater PWM is checked every 15 ms, a 20 minute cooler PWM once per second.
+     * @return time between fast updates in ms
+     */
+    uint16_t fastUpdatePeriod() const override final {
+        int32_t p = period_ms / 256;
+        return (p < 1000) ? p : 1000;
+    }
+
     /**
      * Periodic update (every second). Same as fast update, but calls periodic update on target too.
      */
@@ -202,10 +202,9 @@ class DallasTemperature
   
 #endif
   
-#if REQUIRESWHOLEBUSOPS
-  // sends command for all devices on the bus to perform a temperature conversion 
+  // sends command for all devices on the bus to perform a temperature conversion (Skip ROM + Convert T)
+  // always available, because OneWireBusScheduler uses it to start a conversion on all sensors at once
   void requestTemperatures(void);
-#endif  
    
   // sends command for one device to perform a temperature conversion by address
   void requestTemperaturesByAddress(const uint8_t*);
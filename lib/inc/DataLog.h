@@ -0,0 +1,145 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Persistent log of control values in flash, so the host can fill gaps in its history after a reboot or when it was
+ * disconnected.
+ *
+ * The storage is used as a ring of pages. Each page starts with a header with an increasing sequence number, so the
+ * newest page can be found after a reboot. When all pages are used, the oldest page is erased and reused. Every page
+ * is erased once per pass through the ring, which spreads the wear evenly over the flash.
+ *
+ * Page layout:
+ *   header     magic ('B', 'L'), version, reserved, sequence number (uint32, little endian)
+ *   records    type, payload length, payload
+ *
+ * Record payloads:
+ *   key frame  time (uint32, little endian), number of values, each value as zigzag encoded varint
+ *   delta      time since the previous record as varint, for each value the difference with the previous record
+ *              as zigzag encoded varint
+ *
+ * Each page starts with a key frame, so pages can be decoded on their own. The type byte of a record is written
+ * last. An erased type byte (0xFF) marks the end of the page, so a record that was interrupted by a reset is ignored.
+ */
+namespace DataLog {
+    static const uint8_t magic0 = 'B';
+    static const uint8_t magic1 = 'L';
+    static const uint8_t version = 1;
+    static const uint8_t headerLength = 8;
+    static const uint8_t recordKeyFrame = 'K';
+    static const uint8_t recordDelta = 'D';
+    static const uint8_t recordEnd = 0xFF; // erased flash
+    static const uint8_t maxValues = 32;
+    static const uint8_t maxRecordLength = 2 + 5 + 1 + 3 * maxValues; // a 16 bit delta needs at most 3 bytes
+}
+
+/*
+ * Interface to the flash that holds the log, with the same functions as a Flashee::FlashDevice.
+ * Like NOR flash, a write can only clear bits. Pages are erased to 0xFF before they are written.
+ */
+class DataLogStorage
+{
+public:
+    virtual ~DataLogStorage() = default;
+
+    virtual uint32_t pageSize() const = 0;
+    virtual uint32_t pageCount() const = 0;
+    virtual bool erasePage(uint32_t address) = 0;
+    virtual bool writePage(const void * data, uint32_t address, uint32_t length) = 0;
+    virtual bool readPage(void * data, uint32_t address, uint32_t length) const = 0;
+};
+
+struct DataLogSample
+{
+    uint32_t time; // seconds
+    uint8_t numValues;
+    int16_t values[DataLog::maxValues];
+};
+
+class DataLogger
+{
+public:
+    DataLogger(DataLogStorage & storage);
+    ~DataLogger() = default;
+
+    /*
+     * Finds the newest page after a reset. Logging continues on a new page, because the end of the newest page
+     * could have been written partially. Returns false if the log is empty.
+     */
+    bool begin();
+
+    /*
+     * Appends a sample. Time should not decrease, because the log is searched by time.
+     * Returns false if writing to the flash failed.
+     */
+    bool append(uint32_t time, const int16_t * values, uint8_t numValues);
+
+    // time of the newest sample in the log, 0 if the log is empty
+    uint32_t lastTime() const {
+        return previousTime;
+    }
+
+private:
+    bool startPage();
+    uint8_t encodeKeyFrame(uint8_t * record, uint32_t time, const int16_t * values, uint8_t numValues);
+    uint8_t encodeDelta(uint8_t * record, uint32_t time, const int16_t * values, uint8_t numValues);
+
+    DataLogStorage & storage;
+    uint32_t page;
+    uint32_t offset; // write position in page, 0 when the next record should start a new page
+    uint32_t sequence;
+    uint32_t previousTime;
+    int16_t previous[DataLog::maxValues];
+    uint8_t numPrevious;
+};
+
+/*
+ * Reads samples from the log, from oldest to newest.
+ */
+class DataLogReader
+{
+public:
+    DataLogReader(DataLogStorage & storage);
+    ~DataLogReader() = default;
+
+    // positions the reader at the first sample at or after time from. Only the page headers are read.
+    void seek(uint32_t from);
+
+    // reads the next sample, returns false at the end of the log
+    bool next(DataLogSample & sample);
+
+private:
+    bool openPage();
+    bool readRecord();
+    void nextPage();
+
+    DataLogStorage & storage;
+    uint32_t page;
+    uint32_t pagesLeft;
+    uint32_t offset; // read position in page, 0 when the page is not opened yet
+    uint32_t from;
+    DataLogSample current;
+};
+
+// finds the page with the highest sequence number, returns false if no page has a valid header
+bool findNewestDataLogPage(DataLogStorage const & storage, uint32_t & page, uint32_t & sequence);
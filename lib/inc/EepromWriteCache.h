@@ -0,0 +1,178 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "EepromTypes.h"
+#include "Ticks.h"
+
+struct EepromWriteStats
+{
+    uint32_t stores;   // number of times a block was marked as changed
+    uint32_t flushes;  // number of times changed blocks were written
+    uint32_t writes;   // number of writes to the EEPROM, one per run of changed bytes
+    uint32_t bytes;    // number of bytes written to the EEPROM
+};
+
+/*
+ * Coalesces writes of settings structs to EEPROM.
+ *
+ * Each block is a struct in RAM that is stored at a fixed offset in EEPROM. The cache keeps a shadow copy of what is
+ * in EEPROM for each block. Storing a block only marks it as changed. When the write window has passed since the
+ * first unwritten change, the block is compared with its shadow and only the runs of bytes that differ are written.
+ * Many changes in a short time, like a host sending all settings one by one, result in a single small write.
+ *
+ * The window starts at the first change, so changes that keep coming do not postpone writing forever.
+ *
+ * Access is an EepromAccess implementation, with readBlock(target, offset, size) and writeBlock(offset, source, size).
+ * The shadow buffers are provided by the caller, so no memory is allocated.
+ */
+template<class Access, uint8_t maxBlocks>
+class EepromWriteCache
+{
+public:
+    EepromWriteCache(Access & _access, ticks_millis_t _window) :
+        access(_access), numBlocks(0), dirty(0), firstChange(0), window(_window), stats()
+    {
+    }
+    ~EepromWriteCache() = default;
+
+    /*
+     * Adds a block of size bytes at object, which is stored at offset in EEPROM.
+     * The shadow should be size bytes. It is filled by sync().
+     * Returns false when all blocks are in use.
+     */
+    bool add(eptr_t offset, const void * object, uint8_t * shadow, uint16_t size){
+        if(numBlocks >= maxBlocks){
+            return false;
+        }
+        blocks[numBlocks].offset = offset;
+        blocks[numBlocks].object = static_cast<const uint8_t *>(object);
+        blocks[numBlocks].shadow = shadow;
+        blocks[numBlocks].size = size;
+        numBlocks++;
+        return true;
+    }
+
+    /*
+     * Reads the shadows from EEPROM. Call this after the EEPROM was written without the cache, for example when it is
+     * initialized. Changes that were not written yet are kept and will be compared with the new contents.
+     */
+    void sync(){
+        for(uint8_t i = 0; i < numBlocks; i++){
+            access.readBlock(blocks[i].shadow, blocks[i].offset, blocks[i].size);
+        }
+    }
+
+    // marks the block of object as changed. Returns false if object was not added.
+    bool store(const void * object, ticks_millis_t now){
+        for(uint8_t i = 0; i < numBlocks; i++){
+            if(blocks[i].object == object){
+                if(dirty == 0){
+                    firstChange = now;
+                }
+                dirty |= blockMask(i);
+                stats.stores++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // writes the changed blocks when the window has passed since the first change
+    void update(ticks_millis_t now){
+        if(dirty != 0 && timeSinceMillis(now, firstChange) >= window){
+            flush();
+        }
+    }
+
+    // writes the changed blocks now, for example before a reset
+    void flush(){
+        if(dirty == 0){
+            return;
+        }
+        for(uint8_t i = 0; i < numBlocks; i++){
+            if(dirty & blockMask(i)){
+                writeChanges(blocks[i]);
+            }
+        }
+        dirty = 0;
+        stats.flushes++;
+    }
+
+    bool pending() const {
+        return dirty != 0;
+    }
+
+    void setWindow(ticks_millis_t _window){
+        window = _window;
+    }
+
+    ticks_millis_t getWindow() const {
+        return window;
+    }
+
+    EepromWriteStats const & getStats() const {
+        return stats;
+    }
+
+private:
+    struct Block {
+        eptr_t offset;
+        const uint8_t * object;
+        uint8_t * shadow;
+        uint16_t size;
+    };
+
+    static uint32_t blockMask(uint8_t index){
+        return uint32_t(1) << index;
+    }
+
+    // writes each run of bytes that differs from the shadow
+    void writeChanges(Block & block){
+        uint16_t i = 0;
+        while(i < block.size){
+            if(block.object[i] == block.shadow[i]){
+                i++;
+                continue;
+            }
+            uint16_t start = i;
+            while(i < block.size && block.object[i] != block.shadow[i]){
+                i++;
+            }
+            uint16_t length = i - start;
+            access.writeBlock(block.offset + start, block.object + start, length);
+            memcpy(block.shadow + start, block.object + start, length);
+            stats.writes++;
+            stats.bytes += length;
+        }
+    }
+
+    static_assert(maxBlocks <= 32, "dirty flags are stored in 32 bits");
+
+    Access & access;
+    Block blocks[maxBlocks];
+    uint8_t numBlocks;
+    uint32_t dirty;
+    ticks_millis_t firstChange;
+    ticks_millis_t window;
+    EepromWriteStats stats;
+};
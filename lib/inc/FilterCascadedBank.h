@@ -0,0 +1,110 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+#include "temperatureFormats.h"
+#include "FilterCascaded.h"
+
+/*
+ * FilterCascadedBank is a FilterCascaded for many channels. Each call to add() adds one sample to every channel.
+ *
+ * The state of the channels is stored in blocks of 'lanes' channels and updated with GCC vector extensions,
+ * which compile to SIMD instructions on the host. Each block is stored as
+ * [section][x0, x1, x2, y0, y1, y2][lane], so each tap of a block is a single vector in memory.
+ *
+ * The saturating arithmetic of temp_precise_t is done with overflow masks instead of branches. The outputs are
+ * exactly the same as those of a FilterCascaded (and FixedFilter::add(temp_precise_t)) with the same b value.
+ * Shifts are fastest when all channels in a block have the same b value, which is the usual case.
+ */
+class FilterCascadedBank
+{
+public:
+    static const uint8_t lanes = 4; // 128 bit vectors, SSE2 on x86-64 and NEON on ARM
+
+    FilterCascadedBank(uint16_t numChannels = 0);
+    ~FilterCascadedBank() = default;
+
+    uint16_t size() const {
+        return channels;
+    }
+
+    // adds a channel with the defaults of FilterCascaded (b value 2, initialized at 0) and returns its index
+    uint16_t add();
+
+    void init(uint16_t n, temp_precise_t val = temp_precise_t(0.0));
+
+    void setFiltering(uint16_t n, uint8_t bValue);
+
+    uint8_t getFiltering(uint16_t n) const {
+        return b[n];
+    }
+
+    // adds input[n] to channel n for all channels
+    void add(temp_precise_t const * input);
+
+    // adds input[n] to channel n for all channels with mask[n] != 0, the other channels keep their state
+    void add(temp_precise_t const * input, uint8_t const * mask);
+
+    /* Filters a block of samples for all channels. Samples are interleaved: input[s * size() + n] is sample s
+     * of channel n. The filter outputs are written in the same layout to output, which can be the same as input.
+     */
+    void addBlock(temp_precise_t const * input, temp_precise_t * output, uint32_t samples);
+
+    temp_precise_t readInput(uint16_t n) const {
+        return value(n, 0, X0);  // return unfiltered input of first section
+    }
+
+    temp_precise_t readOutput(uint16_t n) const {
+        return value(n, NUM_SECTIONS - 1, Y0); // return output of last section (which is most filtered)
+    }
+
+    temp_precise_t readPrevOutput(uint16_t n) const {
+        return value(n, NUM_SECTIONS - 1, Y1); // return previous output of last section
+    }
+
+private:
+    enum Tap : uint8_t { X0, X1, X2, Y0, Y1, Y2, TAPS };
+    static const uint16_t blockSize = NUM_SECTIONS * TAPS * lanes; // number of int32_t values per block
+
+    temp_precise_t value(uint16_t n, uint8_t section, Tap tap) const {
+        temp_precise_t t;
+        t.setRaw(state[blockOffset(n) + (section * TAPS + tap) * lanes + n % lanes]);
+        return t;
+    }
+
+    static uint32_t blockOffset(uint16_t n) {
+        return uint32_t(n / lanes) * blockSize;
+    }
+
+    uint16_t numBlocks() const {
+        return (channels + lanes - 1) / lanes;
+    }
+
+    void updateBlockShift(uint16_t block);
+    void addToBlock(uint16_t block, int32_t const * input, int32_t const * mask);
+    void addRow(temp_precise_t const * input, temp_precise_t * output); // output is optional
+
+    uint16_t channels;
+    std::vector<int32_t> state;         // raw temp_precise_t values, in blocks of blockSize
+    std::vector<int32_t> shiftB;        // b value per channel, padded to whole blocks
+    std::vector<int8_t> blockB;         // b value shared by all channels in a block, or -1 if they differ
+    std::vector<uint8_t> b;             // b value per channel
+};
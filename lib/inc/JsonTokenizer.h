@@ -0,0 +1,94 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifndef JSON_TOKEN_MAX_LENGTH
+#ifdef ARDUINO
+#define JSON_TOKEN_MAX_LENGTH 29 // same as the old parser, to save RAM
+#else
+#define JSON_TOKEN_MAX_LENGTH 63
+#endif
+#endif
+
+/*
+ * Resumable tokenizer for the flat JSON objects sent by the host, like {"mode":"b","beerSet":20.0}.
+ *
+ * Characters are fed one at a time, as they are received. The tokenizer never waits for input, so a slow or
+ * partial write from the host cannot block the control loop. Nested objects and arrays are not supported.
+ *
+ * Outside quotes, spaces and quotes are skipped. Inside quotes, all characters are part of the key or value,
+ * including ',' ':' and '}'.
+ */
+class JsonTokenizer
+{
+public:
+    // feed() returns a combination of these flags
+    enum Result : uint8_t {
+        NONE = 0,
+        PAIR = 1,   // key() and value() hold a complete pair
+        END = 2,    // the closing brace was received
+        ERROR = 4   // the input is not a valid object or a token is too long, error() holds the offending character
+    };
+
+    static const uint8_t maxTokenLength = JSON_TOKEN_MAX_LENGTH;
+
+    JsonTokenizer(){
+        reset();
+    }
+    ~JsonTokenizer() = default;
+
+    // starts a new object
+    void reset();
+
+    uint8_t feed(char c);
+
+    const char * key() const {
+        return keyBuffer;
+    }
+
+    const char * value() const {
+        return valueBuffer;
+    }
+
+    char error() const {
+        return errorChar;
+    }
+
+private:
+    enum State : uint8_t {
+        OPEN,   // waiting for the opening brace
+        KEY,
+        VALUE,
+        CLOSED  // end or error, reset() must be called to start a new object
+    };
+
+    uint8_t fail(char c);
+    uint8_t endPair(uint8_t result);
+
+    char keyBuffer[maxTokenLength + 1];
+    char valueBuffer[maxTokenLength + 1];
+    uint8_t length;
+    State state;
+    bool quoted;
+    bool pairDone; // a pair was ended, buffers are cleared when the next character is fed
+    char errorChar;
+};
@@ -48,6 +48,7 @@
 
 #include <inttypes.h>
 #include "OneWireImpl.h"
+#include "OneWireProfiler.h"
 
 class OneWire {
 public:
@@ -91,6 +92,7 @@ public:
         return driver.pinNr(); // return pin number or lower bits of I2C address
     }
     bool reset(){
+        OneWireProfiler::Scope profile(OneWireProfiler::RESET);
         return driver.reset();
     }  
     
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+#include "Ticks.h"
+#include "DallasTemperature.h"
+
+class OneWire;
+class OneWireTempSensor;
+
+/*
+ * Schedules temperature conversions for all OneWireTempSensors on a bus.
+ *
+ * Instead of requesting a conversion for each sensor separately, one Skip ROM + Convert T command is broadcast
+ * to all sensors on the bus. When the conversion time has passed, the sensors are read one by one: each call to
+ * update() reads the scratchpad of a single sensor. A sensor that cannot be read is re-initialized in the next call
+ * to update(), so the main loop is never blocked for longer than reading or re-initializing a single sensor.
+ * Bus time scales with one conversion per period instead of one per sensor.
+ *
+ * Sensors that use a scheduler do not access the bus in update(). Their cached value is refreshed by the scheduler.
+ */
+class OneWireBusScheduler
+{
+public:
+    enum State : uint8_t {
+        IDLE,       // waiting for the next period
+        CONVERTING, // conversion requested, waiting until it is complete
+        READING     // reading or re-initializing one sensor per call to update()
+    };
+
+    static const ticks_millis_t conversionTime = 750; // DS18B20 conversion time at 12 bit resolution
+
+    OneWireBusScheduler(OneWire * bus, ticks_millis_t period = 1000);
+    ~OneWireBusScheduler(); // sensors that are still registered fall back to requesting their own conversions
+
+    void add(OneWireTempSensor * sensor);
+    void remove(OneWireTempSensor * sensor);
+
+    /*
+     * Advances the state machine. Should be called as often as possible, for example together with fastUpdate().
+     */
+    void update();
+
+    /*
+     * Returns the time in ms until update() has something to do, so the main loop knows how long it can be idle.
+     */
+    ticks_millis_t timeUntilNext() const;
+
+    State getState() const {
+        return state;
+    }
+
+    OneWire * getBus() const {
+        return bus;
+    }
+
+    /*
+     * Returns the scheduler for a bus. A scheduler is created the first time a bus is used and is never destroyed,
+     * just like the bus itself.
+     */
+    static OneWireBusScheduler * forBus(OneWire * bus);
+
+    /*
+     * Updates the schedulers of all buses.
+     */
+    static void updateAll();
+
+    /*
+     * Returns the time in ms until the scheduler of any bus has something to do.
+     */
+    static ticks_millis_t timeUntilNextAll();
+
+private:
+    OneWire * bus;
+    DallasTemperature dallas;
+    std::vector<OneWireTempSensor *> sensors;
+    ticks_millis_t period;
+    ticks_millis_t lastConversion;
+    uint8_t nextSensor;
+    OneWireTempSensor * reconnecting; // sensor that could not be read, re-initialized in the next update()
+    State state;
+
+    OneWireBusScheduler * nextScheduler; // all schedulers created by forBus() are kept in a linked list
+    static OneWireBusScheduler * schedulers;
+};
@@ -20,6 +20,12 @@ typedef DS248x OneWireDriver;
 
 typedef OneWirePin OneWireDriver;
 
+#elif defined(ONEWIRE_SIM)
+
+#include "OneWireSim.h"
+
+typedef OneWireSim OneWireDriver;
+
 #elif defined(ONEWIRE_NULL)
 
 #include "OneWireNull.h"
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "Ticks.h"
+#include "OneWireAddress.h"
+
+#ifndef ONEWIRE_PROFILE
+#ifdef ARDUINO
+#define ONEWIRE_PROFILE 0 // not enough RAM on AVR
+#else
+#define ONEWIRE_PROFILE 1
+#endif
+#endif
+
+/*
+ * Collects timing and error statistics for OneWire bus transactions, to find slow or flaky devices.
+ *
+ * Latency is recorded per operation type in a histogram with power of 2 buckets. CRC errors and retries are counted
+ * per device address, for a limited number of devices. Devices that do not fit in the table are not counted.
+ *
+ * All functions are static, so they can be called from the OneWire classes without passing a profiler around.
+ * When ONEWIRE_PROFILE is 0, all functions are empty and the statistics take no RAM.
+ */
+class OneWireProfiler
+{
+public:
+    enum Operation : uint8_t {
+        RESET,
+        SEARCH,
+        READ_SCRATCHPAD,
+        SWITCH_ACCESS_READ, // OneWireSwitch, DS2413 and DS2408
+        SWITCH_ACCESS_WRITE,
+        NUM_OPERATIONS
+    };
+
+    static const uint8_t numBuckets = 12;
+    static const uint8_t firstBucketBits = 6; // first bucket is below 64 us, last bucket is 65536 us and up
+    static const uint8_t maxDevices = 16;
+
+    struct OperationStats {
+        uint32_t count;
+        uint32_t maxMicros;
+        uint32_t buckets[numBuckets];
+    };
+
+    struct DeviceStats {
+        DeviceAddress address;
+        uint32_t transactions;
+        uint16_t crcErrors;
+        uint16_t retries;
+    };
+
+    /*
+     * Records the duration of an operation for as long as it is in scope.
+     */
+    class Scope {
+    public:
+#if ONEWIRE_PROFILE
+        Scope(Operation op) : op(op), start(ticks.micros()) {}
+        ~Scope() {
+            record(op, ticks.micros() - start);
+        }
+    private:
+        Operation op;
+        ticks_micros_t start;
+#else
+        Scope(Operation op) {}
+#endif
+    };
+
+#if ONEWIRE_PROFILE
+    static void record(Operation op, uint32_t micros);
+    static void countTransaction(const uint8_t * address);
+    static void countCrcError(const uint8_t * address);
+    static void countRetry(const uint8_t * address);
+    static void clear();
+
+    static uint8_t bucket(uint32_t micros);
+
+    static const OperationStats & getOperation(Operation op) {
+        return operations[op];
+    }
+    static uint8_t getDeviceCount() {
+        return deviceCount;
+    }
+    static const DeviceStats & getDevice(uint8_t i) {
+        return devices[i];
+    }
+    static const char * operationName(Operation op);
+
+private:
+    static DeviceStats * device(const uint8_t * address); // finds or adds a device, nullptr when the table is full
+
+    static OperationStats operations[NUM_OPERATIONS];
+    static DeviceStats devices[maxDevices];
+    static uint8_t deviceCount;
+#else
+    static void record(Operation op, uint32_t micros) {}
+    static void countTransaction(const uint8_t * address) {}
+    static void countCrcError(const uint8_t * address) {}
+    static void countRetry(const uint8_t * address) {}
+    static void clear() {}
+#endif
+};
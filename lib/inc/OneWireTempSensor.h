@@ -27,6 +27,7 @@
 
 class DallasTemperature;
 class OneWire;
+class OneWireBusScheduler;
 
 #define ONEWIRE_TEMP_SENSOR_PRECISION (4)
 
@@ -38,14 +39,11 @@ public:
 	 * /param address	The onewire address for this sensor. If all bytes are 0 in the address, the first temp sensor
 	 *    on the bus is used.
 	 * /param calibration	A temperature value that is added to all readings. This can be used to calibrate the sensor.	 
+	 * /param scheduler	Optional scheduler for the bus. When set, conversions are requested and read by the scheduler
+	 *    and the sensor never blocks waiting for a conversion. Without a scheduler, the sensor requests its own
+	 *    conversions.
 	 */
-	OneWireTempSensor(OneWire* bus, DeviceAddress address, temp_t calibrationOffset)
-	: oneWire(bus), sensor(NULL) {		
-		connected = true;  // assume connected. Transition from connected to disconnected prints a message.
-		memcpy(sensorAddress, address, sizeof(DeviceAddress));
-		this->calibrationOffset = calibrationOffset;
-		cachedValue = TEMP_SENSOR_DISCONNECTED;
-	};
+	OneWireTempSensor(OneWire* bus, DeviceAddress address, temp_t calibrationOffset, OneWireBusScheduler * scheduler = NULL);
 	
 	~OneWireTempSensor();
 	
@@ -55,10 +53,16 @@ public:
 	
 	bool init() override final ;
 	temp_t read() const override final ; // return cached value
-	void update() override final ; // read from hardware sensor
+	void update() override final ; // read from hardware sensor, does nothing when a scheduler reads the sensor
 	
 	private:
 
+	/**
+	 * Called by the scheduler when the broadcast conversion is complete. Reads the temperature.
+	 * @return false when the sensor could not be read, the scheduler then calls init() in a separate step.
+	 */
+	bool readScheduled();
+
 	void setConnected(bool connected);
 	void requestConversion();
 	void waitForConversion()
@@ -74,6 +78,7 @@ public:
 	
 	OneWire * oneWire;
 	DallasTemperature * sensor;
+	OneWireBusScheduler * scheduler;
 	DeviceAddress sensorAddress;
 
 	temp_t calibrationOffset;
@@ -81,4 +86,5 @@ public:
 	bool connected;
 	
 	friend class OneWireTempSensorMixin;
+	friend class OneWireBusScheduler;
 };
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2015 BrewPi / Elco Jacobs
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+#include "temperatureFormats.h"
+#include "FilterCascadedBank.h"
+#include "TempSensorBasic.h"
+#include "ActuatorInterfaces.h"
+#include "SetPoint.h"
+
+/*
+ * PidBank holds many PID loops in one object. Gains, filter state and integrators of all loops are stored in
+ * contiguous arrays (one array per field, indexed by loop) and update() processes all loops in one pass:
+ * first all inputs are read, then the filters of all loops are updated in a FilterCascadedBank, then the PID
+ * parts are calculated and the outputs are written.
+ *
+ * The calculations are the same as in Pid::update() and give bit-identical results, with one difference in timing:
+ * all inputs are read before any output is written. A vector of Pid objects gives the same results when no loop
+ * writes an output that is an input of a loop later in the bank, for example when a cascaded loop
+ * (a PID driving an ActuatorSetPoint) is added after the loops that use its set point, like in Control.
+ */
+class PidBank
+{
+public:
+    typedef uint16_t index_t;
+
+    PidBank() = default;
+    ~PidBank() = default;
+
+    // adds a loop with the same defaults as a new Pid and returns its index
+    index_t add(TempSensorBasic * input, ActuatorRange * output, SetPoint * setPoint);
+
+    index_t size() const {
+        return index_t(Kp.size());
+    }
+
+    // updates all loops, should be called every second like Pid::update()
+    void update();
+
+    void setConstants(index_t n, temp_long_t kp, uint16_t ti, uint16_t td){
+        Kp[n] = kp;
+        Ti[n] = ti;
+        Td[n] = td;
+    }
+
+    void setInputFilter(index_t n, uint8_t b){
+        inputFilter.setFiltering(n, b);
+    }
+
+    void setDerivativeFilter(index_t n, uint8_t b){
+        derivativeFilter.setFiltering(n, b);
+    }
+
+    bool setInputSensor(index_t n, TempSensorBasic * s);
+
+    void setOutputActuator(index_t n, ActuatorRange * a){
+        outputActuator[n] = a;
+    }
+
+    void setSetPoint(index_t n, SetPoint * s){
+        setPoint[n] = s;
+    }
+
+    void setActuatorIsNegative(index_t n, bool setting){
+        actuatorIsNegative[n] = setting;
+    }
+
+    void enable(index_t n){
+        enabled[n] = true;
+    }
+
+    void disable(index_t n, bool turnOffOutputActuator);
+
+    temp_t getInputError(index_t n) const {
+        return inputError[n];
+    }
+
+    temp_long_t getP(index_t n) const {
+        return p[n];
+    }
+
+    temp_long_t getI(index_t n) const {
+        return i[n];
+    }
+
+    temp_long_t getD(index_t n) const {
+        return d[n];
+    }
+
+    temp_long_t getIntegral(index_t n) const {
+        return integral[n];
+    }
+
+    temp_precise_t getDerivative(index_t n) const {
+        return derivative[n];
+    }
+
+protected:
+    // configuration
+    std::vector<TempSensorBasic *> inputSensor;
+    std::vector<ActuatorRange *>   outputActuator;
+    std::vector<SetPoint *>        setPoint;
+    std::vector<temp_long_t>       Kp;    // proportional gain
+    std::vector<uint16_t>          Ti;    // integral time constant
+    std::vector<uint16_t>          Td;    // derivative time constant
+    std::vector<bool>              actuatorIsNegative;
+    std::vector<bool>              enabled;
+
+    // state
+    std::vector<temp_t>            inputError;
+    std::vector<temp_long_t>       p;
+    std::vector<temp_long_t>       i;
+    std::vector<temp_long_t>       d;
+    std::vector<temp_precise_t>    derivative;
+    std::vector<temp_long_t>       integral;
+    std::vector<temp_t>            previousSetPoint;
+    std::vector<uint8_t>           failedReadCount;
+    FilterCascadedBank             inputFilter;
+    FilterCascadedBank             derivativeFilter;
+
+    // scratch space for update(), kept between updates to prevent allocations
+    std::vector<temp_t>            currentSetPoint;
+    std::vector<temp_precise_t>    filterInput;
+    std::vector<uint8_t>           validSetPoint; // not vector<bool>, to not pack the flags into bits
+    std::vector<uint8_t>           validSensor;
+};
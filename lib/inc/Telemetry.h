@@ -0,0 +1,108 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Compact binary frames for periodic telemetry, as an alternative to printing JSON.
+ *
+ * Each channel is a 16 bit value, usually the raw value of a temp_t. A frame only contains the channels that changed
+ * since the previous frame, as the difference with the previous value. Key frames contain all channels as absolute
+ * values, so a receiver can (re)synchronize.
+ *
+ * Frame layout:
+ *   start      frameStart (0xA5), which cannot occur as the first byte of a text line
+ *   length     number of payload bytes
+ *   payload    type ('T'), flags, sequence number, changed mask (uint16, little endian),
+ *              then for each channel in the mask: the delta as a zigzag encoded varint
+ *   crc        OneWire crc8 of length and payload
+ */
+namespace Telemetry {
+    static const uint8_t frameStart = 0xA5;
+    static const uint8_t frameType = 'T';
+    static const uint8_t flagKeyFrame = 0x01;
+    static const uint8_t maxChannels = 16;
+    static const uint8_t headerLength = 5;
+    static const uint8_t maxPayloadLength = headerLength + 3 * maxChannels; // a 16 bit delta needs at most 3 bytes
+    static const uint8_t maxFrameLength = maxPayloadLength + 3;
+}
+
+class TelemetryEncoder
+{
+public:
+    TelemetryEncoder(uint8_t numChannels);
+    ~TelemetryEncoder() = default;
+
+    /*
+     * Encodes the values of all channels into frame, which must hold Telemetry::maxFrameLength bytes.
+     * Returns the number of bytes to send.
+     */
+    uint8_t encode(const int16_t * values, uint8_t * frame);
+
+    // makes the next frame a key frame, for example when a receiver connects
+    void requestKeyFrame() {
+        framesUntilKeyFrame = 0;
+    }
+
+    uint8_t getNumChannels() const {
+        return numChannels;
+    }
+
+    static const uint8_t keyFrameInterval = 60; // also send a key frame periodically, to recover from lost frames
+
+private:
+    int16_t previous[Telemetry::maxChannels];
+    uint8_t numChannels;
+    uint8_t sequence;
+    uint8_t framesUntilKeyFrame;
+};
+
+/*
+ * Decodes frames created by TelemetryEncoder. Used by the tests and as a reference for the receiving side.
+ */
+class TelemetryDecoder
+{
+public:
+    TelemetryDecoder(uint8_t numChannels);
+    ~TelemetryDecoder() = default;
+
+    /*
+     * Decodes a complete frame. Returns false if the frame is corrupt or if it is a delta frame that cannot be applied,
+     * because no key frame has been received yet or a frame was lost. The values are only valid after true is returned.
+     */
+    bool decode(const uint8_t * frame, uint8_t length);
+
+    int16_t value(uint8_t channel) const {
+        return values[channel];
+    }
+
+    // the mask of channels that changed in the last decoded frame
+    uint16_t changed() const {
+        return changedMask;
+    }
+
+private:
+    int16_t values[Telemetry::maxChannels];
+    uint8_t numChannels;
+    uint8_t sequence;
+    uint16_t changedMask;
+    bool synchronized;
+};
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+#include "Ticks.h"
+
+/*
+ * Runs periodic updates when their deadline has passed, instead of every time the main loop runs.
+ *
+ * Each task has its own period. Tasks that are due are run in the order they were added, so a sensor that is added
+ * before a PID is always updated first when both are due. When a task is more than one period late, it is not run
+ * multiple times to catch up, but rescheduled one period from now.
+ *
+ * run() returns immediately when no task is due, so calling it often costs a single comparison.
+ */
+class UpdateScheduler
+{
+public:
+    typedef void (*UpdateFn)(void * object);
+    typedef ticks_millis_t (*PeriodFn)(void * object);
+
+    UpdateScheduler();
+    ~UpdateScheduler() = default;
+
+    // adds a task that is due immediately, period 0 runs the task every time run() is called
+    void add(UpdateFn fn, void * object, ticks_millis_t period);
+
+    // adds a task with a period that can change, periodFn is asked for the period each time the task is rescheduled
+    void addWithPeriodFn(UpdateFn fn, void * object, PeriodFn periodFn);
+
+    void clear();
+
+    size_t size() const {
+        return tasks.size();
+    }
+
+    /*
+     * Runs all tasks that are due and returns the time in ms until the next task is due.
+     * The main loop can use this to sleep or to do other work.
+     */
+    ticks_millis_t run();
+
+    // returns the time in ms until the next task is due, without running any tasks
+    ticks_millis_t timeUntilNext() const;
+
+private:
+    struct Task {
+        UpdateFn fn;
+        void * object;
+        ticks_millis_t period;
+        PeriodFn periodFn; // NULL for a fixed period
+        ticks_millis_t deadline;
+
+        ticks_millis_t getPeriod() const {
+            return periodFn ? periodFn(object) : period;
+        }
+    };
+
+    static bool isDue(ticks_millis_t now, ticks_millis_t deadline){
+        return int32_t(now - deadline) >= 0; // correct when millis wrap around
+    }
+
+    std::vector<Task> tasks;
+    ticks_millis_t nextDeadline;
+};
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Variable length encoding of integers, used by the telemetry frames and the data log.
+ * Small values take a single byte: each byte holds 7 bits, the high bit is set when more bytes follow.
+ */
+
+// zigzag encoding maps small negative and positive numbers to small unsigned numbers: 0, -1, 1, -2, 2 -> 0, 1, 2, 3, 4
+inline uint32_t zigzag(int32_t v){
+    return (uint32_t(v) << 1) ^ uint32_t(v >> 31);
+}
+
+inline int32_t unzigzag(uint32_t v){
+    return int32_t(v >> 1) ^ -int32_t(v & 1);
+}
+
+inline uint8_t * writeVarint(uint8_t * p, uint32_t v){
+    while(v >= 0x80){
+        *p++ = uint8_t(v) | 0x80;
+        v >>= 7;
+    }
+    *p++ = uint8_t(v);
+    return p;
+}
+
+// returns nullptr when the varint does not end before end
+inline const uint8_t * readVarint(const uint8_t * p, const uint8_t * end, uint32_t & v){
+    v = 0;
+    for(uint8_t shift = 0; p < end && shift < 32; shift += 7){
+        uint8_t b = *p++;
+        v |= uint32_t(b & 0x7F) << shift;
+        if(!(b & 0x80)){
+            return p;
+        }
+    }
+    return nullptr;
+}
@@ -185,11 +185,13 @@ class fixed_point_base: boost::ordered_field_operators<
         static const long long value = 1;
     };
 
+protected:
     /// Initializing constructor.
     //!
     //! This constructor takes a value of type B and initializes the internal
-    //! representation of fixed_point<B, I, F> with it.
-    fixed_point_base(
+    //! representation of fixed_point<B, I, F> with it. It is protected, so the
+    //! derived temperature types can use it in constexpr constructors.
+    constexpr fixed_point_base(
     /// The internal representation to use for initialization.
             B value,
             /// This value is not important, it's just here to differentiate from
@@ -239,7 +241,7 @@ public:
     //!
     //! This constructor takes a numeric value of type bool and converts it to
     //! this fixed_point type.
-    fixed_point_base(
+    constexpr fixed_point_base(
     /// The value to convert.
             bool value) :
             value_((B) (value * power2<F>::value)) {
@@ -252,7 +254,7 @@ public:
     //!
     //! The conversion is done by multiplication with 2^F and rounding to the
     //! next integer.
-    fixed_point_base(
+    constexpr fixed_point_base(
     /// The value to convert.
             float value) :
             value_((B) (value * power2<F>::value + (value >= 0 ? .5 : -.5))) {
@@ -262,7 +264,7 @@ public:
     //!
     //! This constructor takes a numeric value of type double and converts it to
     //! this fixed_point type.
-    fixed_point_base(
+    constexpr fixed_point_base(
     /// The value to convert.
             double value) :
             value_((B) (value * power2<F>::value + (value >= 0 ? .5 : -.5))) {
@@ -272,14 +274,14 @@ public:
     //!
     //! This constructor takes a numeric value of type long double and converts
     //! it to this fixed_point type.
-    fixed_point_base(
+    constexpr fixed_point_base(
     /// The value to convert.
             long double value) :
             value_((B) (value * power2<F>::value + (value >= 0 ? .5 : -.5))) {
     }
 
     /// Copy constructor.
-    fixed_point_base(
+    constexpr fixed_point_base(
     /// The right hand side.
             fixed_point_base<Derived, B, I, F> const& rhs) :
             value_(rhs.value_) {
@@ -289,8 +291,7 @@ public:
     fpml::fixed_point_base<Derived, B, I, F> & operator =(
     /// The right hand side.
             fpml::fixed_point_base<Derived, B, I, F> const& rhs) {
-        fpml::fixed_point_base<Derived, B, I, F> temp(rhs);
-        swap(temp);
+        value_ = rhs.value_;
         return *this;
     }
 
@@ -322,7 +323,7 @@ public:
     //! operator.
     //!
     //! /return true if less than, false otherwise.
-    bool operator <(
+    constexpr bool operator <(
     /// Right hand side.
             fpml::fixed_point_base<Derived, B, I, F> const& rhs) const {
         return value_ < rhs.value_;
@@ -334,7 +335,7 @@ public:
     //! defined and implemented by calling this operator.
     //!
     //! /return true if equal, false otherwise.
-    bool operator ==(
+    constexpr bool operator ==(
     /// Right hand side.
             fpml::fixed_point_base<Derived, B, I, F> const& rhs) const {
         return value_ == rhs.value_;
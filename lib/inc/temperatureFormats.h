@@ -69,25 +69,24 @@ public:
     temp_t(){}
 
     // copy constructor
-    temp_t(temp_t const & rhs){
-        value_ = rhs.value_;
+    constexpr temp_t(temp_t const & rhs) : base(rhs.value_, true){
     }
 
     temp_t(base::base_type value) : base(value){}
 
     // constructor from base class, needed for inherited operators to work
-    temp_t(fpml::fixed_point_base<temp_t, TEMP_TYPE, TEMP_INTBITS> const & rhs) :
+    constexpr temp_t(fpml::fixed_point_base<temp_t, TEMP_TYPE, TEMP_INTBITS> const & rhs) :
         fpml::fixed_point_base<temp_t, TEMP_TYPE, TEMP_INTBITS>(rhs){
     }
 
     // converting copy constructor which removes the extra precision bits
-    temp_t(temp_precise_t const & rhs);
+    constexpr temp_t(temp_precise_t const & rhs);
 
     // converting copy constructor which constrains to temp's limits
-    temp_t(temp_long_t const & rhs);
+    constexpr temp_t(temp_long_t const & rhs);
 
     // construction from double, use base class constructor
-    temp_t(double d) : fpml::fixed_point_base<temp_t, TEMP_TYPE, TEMP_INTBITS>(d){}
+    constexpr temp_t(double d) : fpml::fixed_point_base<temp_t, TEMP_TYPE, TEMP_INTBITS>(d){}
 
     // reserve lowest 5 values for special cases (invalid/disabled)
     static const fpml::fixed_point_base<temp_t, TEMP_TYPE, TEMP_INTBITS>::base_type min_val =
@@ -136,7 +135,11 @@ public:
         value_= val;
     }
 
-    bool isDisabledOrInvalid() const {
+    constexpr TEMP_TYPE getRaw() const {
+        return value_;
+    }
+
+    constexpr bool isDisabledOrInvalid() const {
         return (value_ < min_val);
     }
 
@@ -229,30 +232,33 @@ public:
     temp_precise_t(){}
 
     // copy constructor
-    temp_precise_t(temp_precise_t const & rhs){
-        value_ = rhs.value_;
+    constexpr temp_precise_t(temp_precise_t const & rhs) : base(rhs.value_, true){
     }
 
     temp_precise_t(base::base_type value) : base(value) {}
 
     // constructor from base class, needed for inherited operators to work
-    temp_precise_t(fpml::fixed_point_base<temp_precise_t, TEMP_PRECISE_TYPE, TEMP_PRECISE_INTBITS> const & rhs) :
+    constexpr temp_precise_t(fpml::fixed_point_base<temp_precise_t, TEMP_PRECISE_TYPE, TEMP_PRECISE_INTBITS> const & rhs) :
         fpml::fixed_point_base<temp_precise_t, TEMP_PRECISE_TYPE, TEMP_PRECISE_INTBITS>(rhs){
     }
 
     // converting copy constructor which shifts the value to have more fraction bits
-    temp_precise_t(temp_t const & rhs);
+    constexpr temp_precise_t(temp_t const & rhs);
 
     // converting copy constructor which shifts the value to have more fraction bits and constrains the result to fit
-    temp_precise_t(temp_long_t const & rhs);
+    constexpr temp_precise_t(temp_long_t const & rhs);
 
     // construction from double, use base class constructor
-    temp_precise_t(double d) : fpml::fixed_point_base<temp_precise_t, TEMP_PRECISE_TYPE, TEMP_PRECISE_INTBITS>(d){}
+    constexpr temp_precise_t(double d) : fpml::fixed_point_base<temp_precise_t, TEMP_PRECISE_TYPE, TEMP_PRECISE_INTBITS>(d){}
 
     void setRaw(TEMP_PRECISE_TYPE val){
         value_= val;
     }
 
+    constexpr TEMP_PRECISE_TYPE getRaw() const {
+        return value_;
+    }
+
     char * toString(char buf[], uint8_t numDecimals, uint8_t len) const {
         return toStringImpl(value_, fractional_bit_count, buf, numDecimals, len, 'C', false);
     }
@@ -328,30 +334,33 @@ public:
     temp_long_t(){}
 
     // copy constructor
-    temp_long_t(temp_long_t const & rhs){
-        value_ = rhs.value_;
+    constexpr temp_long_t(temp_long_t const & rhs) : base(rhs.value_, true){
     }
 
     temp_long_t(base::base_type value) : base(value) {}
 
     // constructor from base class, needed for inherited operators to work
-    temp_long_t(fpml::fixed_point_base<temp_long_t, TEMP_LONG_TYPE, TEMP_LONG_INTBITS> const & rhs) :
+    constexpr temp_long_t(fpml::fixed_point_base<temp_long_t, TEMP_LONG_TYPE, TEMP_LONG_INTBITS> const & rhs) :
         fpml::fixed_point_base<temp_long_t, TEMP_LONG_TYPE, TEMP_LONG_INTBITS>(rhs){
     }
 
     // converting copy constructor from normal temp format
-    temp_long_t(temp_t const & rhs);
+    constexpr temp_long_t(temp_t const & rhs);
 
     // converting copy constructor which removes extra precision bits
-    temp_long_t(temp_precise_t const & rhs);
+    constexpr temp_long_t(temp_precise_t const & rhs);
 
     // construction from double, use base class constructor
-    temp_long_t(double d) : fpml::fixed_point_base<temp_long_t, TEMP_LONG_TYPE, TEMP_LONG_INTBITS>(d){}
+    constexpr temp_long_t(double d) : fpml::fixed_point_base<temp_long_t, TEMP_LONG_TYPE, TEMP_LONG_INTBITS>(d){}
 
     void setRaw(TEMP_LONG_TYPE val){
         value_= val;
     }
 
+    constexpr TEMP_LONG_TYPE getRaw() const {
+        return value_;
+    }
+
     char * toString(char buf[], uint8_t numDecimals, uint8_t len) const {
         return toStringImpl(value_, fractional_bit_count, buf, numDecimals, len, 'C', false);
     }
@@ -416,3 +425,335 @@ public:
     friend class temp_t;
     friend class temp_precise_t;
 };
+
+/* Converting constructors and operators for mixed types.
+ * These are defined in the header so the compiler can inline them in the control loop.
+ */
+
+// Converting constructors, which shift and constrain the value.
+
+// temp and temp_long have same number of fraction bits, no shifting needed
+static_assert(temp_t::fractional_bit_count == temp_long_t::fractional_bit_count,
+        "temp and temp_long should have same number of fraction bits");
+
+// temp and temp_precise have same number of integer bits, so converting temp to temp_precise will not overflow
+static_assert(temp_t::integer_bit_count == temp_precise_t::integer_bit_count,
+        "temp and temp_precise should have same number of integer bits");
+
+// The constructors use the raw value constructor of the base class, so they can be used in constant expressions
+
+constexpr temp_t::temp_t(temp_precise_t const & rhs) :
+    base(base::base_type(rhs.value_ >> (temp_precise_t::fractional_bit_count - temp_t::fractional_bit_count)),
+            true) { // could result in a 1 bit error due to rounding
+}
+
+constexpr temp_t::temp_t(temp_long_t const & rhs) :
+    base(base::base_type((rhs.value_ < min_val) ? min_val : (rhs.value_ > max_val) ? max_val : rhs.value_), true) {
+}
+
+constexpr temp_precise_t::temp_precise_t(temp_t const & rhs) :
+    base(base::base_type(rhs.value_) * (1 << (temp_precise_t::fractional_bit_count - temp_t::fractional_bit_count)),
+            true) { // multiply instead of shift, because shifting a negative value left is not a constant expression
+
+}
+
+// convert to temp first to make sure it fits
+constexpr temp_precise_t::temp_precise_t(temp_long_t const & rhs) :
+    temp_precise_t(temp_t(rhs)) {
+}
+
+constexpr temp_long_t::temp_long_t(temp_t const & rhs) :
+    base(base::base_type(rhs.value_), true) {
+}
+
+constexpr temp_long_t::temp_long_t(temp_precise_t const & rhs) :
+    base(base::base_type(rhs.value_ >> (temp_precise_t::fractional_bit_count - temp_long_t::fractional_bit_count)),
+            true) { // could result in a 1 bit error due to rounding
+}
+
+// With operators for mixed types always returns the bigger type
+// which is automatically converted afterwards if assigned to a small type
+
+// Addition
+
+// this looks recursive, but it prevents ambiguity
+inline temp_t temp_t::operator+(temp_t const & rhs) {
+    temp_t result(*this);
+    result += rhs;
+    return result;
+}
+
+inline temp_precise_t temp_t::operator+(temp_precise_t const & rhs) {
+    temp_precise_t result(*this);
+    result += rhs;
+    return result;
+}
+
+inline temp_long_t temp_t::operator+(temp_long_t const & rhs) {
+    temp_long_t result(*this);
+    result += rhs;
+    return result;
+}
+
+inline temp_long_t temp_long_t::operator+(temp_long_t const & rhs) {
+    temp_long_t result(*this);
+    result += rhs;
+    return result;
+}
+
+inline temp_long_t temp_long_t::operator+(temp_precise_t const & rhs) {
+    temp_long_t result(*this);
+    result += temp_long_t(rhs);
+    return result;
+}
+
+inline temp_long_t temp_long_t::operator+(temp_t const & rhs) {
+    temp_long_t result(*this);
+    result += temp_long_t(rhs);
+    return result;
+}
+
+inline temp_precise_t temp_precise_t::operator+(temp_precise_t const & rhs) {
+    temp_precise_t result(*this);
+    result += rhs;
+    return result;
+}
+
+inline temp_precise_t temp_precise_t::operator+(temp_t const & rhs) {
+    temp_precise_t result(*this);
+    result += temp_precise_t(rhs);
+    return result;
+}
+
+inline temp_long_t temp_precise_t::operator+(temp_long_t const & rhs) {
+    temp_long_t result(*this);
+    result += temp_long_t(rhs);
+    return result;
+}
+
+// Unary Minus (change sign)
+inline temp_t temp_t::operator-() const{
+    temp_t result(*this);
+    result.value_ = -result.value_;
+    return result;
+}
+
+inline temp_long_t temp_long_t::operator-() const{
+    temp_long_t result(*this);
+    result.value_ = -result.value_;
+    return result;
+}
+
+inline temp_precise_t temp_precise_t::operator-() const{
+    temp_precise_t result(*this);
+    result.value_ = -result.value_;
+    return result;
+}
+
+
+// Subtraction
+
+// this looks recursive, but it prevents ambiguity
+inline temp_t temp_t::operator-(temp_t const & rhs) {
+    temp_t result(*this);
+    result -= rhs;
+    return result;
+}
+
+inline temp_precise_t temp_t::operator-(temp_precise_t const & rhs) {
+    temp_precise_t result(*this);
+    result -= rhs;
+    return result;
+}
+
+inline temp_long_t temp_t::operator-(temp_long_t const & rhs) {
+    temp_long_t result(*this);
+    result -= rhs;
+    return result;
+}
+
+inline temp_long_t temp_long_t::operator-(temp_long_t const & rhs) {
+    temp_long_t result(*this);
+    result -= rhs;
+    return result;
+}
+
+inline temp_long_t temp_long_t::operator-(temp_precise_t const & rhs) {
+    temp_long_t result(*this);
+    result -= temp_long_t(rhs);
+    return result;
+}
+
+inline temp_long_t temp_long_t::operator-(temp_t const & rhs) {
+    temp_long_t result(*this);
+    result -= temp_long_t(rhs);
+    return result;
+}
+
+inline temp_precise_t temp_precise_t::operator-(temp_precise_t const & rhs) {
+    temp_precise_t result(*this);
+    result -= rhs;
+    return result;
+}
+
+inline temp_precise_t temp_precise_t::operator-(temp_t const & rhs) {
+    temp_precise_t result(*this);
+    result -= temp_precise_t(rhs);
+    return result;
+}
+
+inline temp_long_t temp_precise_t::operator-(temp_long_t const & rhs) {
+    temp_long_t result(*this);
+    result -= temp_long_t(rhs);
+    return result;
+}
+
+// Multiplication
+
+inline temp_t temp_t::operator*(temp_t const & rhs) {
+    temp_t result(*this);
+    result *= rhs;
+    return result;
+}
+
+inline temp_precise_t temp_t::operator*(temp_precise_t const & rhs) {
+    temp_precise_t result(*this);
+    result *= rhs;
+    return result;
+}
+
+inline temp_long_t temp_t::operator*(temp_long_t const & rhs) {
+    temp_long_t result(*this);
+    result *= rhs;
+    return result;
+}
+
+inline temp_long_t temp_long_t::operator*(temp_long_t const & rhs) {
+    temp_long_t result(*this);
+    result *= rhs;
+    return result;
+}
+
+inline temp_long_t temp_long_t::operator*(temp_precise_t const & rhs) {
+    temp_long_t result(*this);
+    result *= temp_long_t(rhs);
+    return result;
+}
+
+inline temp_long_t temp_long_t::operator*(temp_t const & rhs) {
+    temp_long_t result(*this);
+    result *= temp_long_t(rhs);
+    return result;
+}
+
+inline temp_precise_t temp_precise_t::operator*(temp_precise_t const & rhs) {
+    temp_precise_t result(*this);
+    result *= rhs;
+    return result;
+}
+
+inline temp_precise_t temp_precise_t::operator*(temp_t const & rhs) {
+    temp_precise_t result(*this);
+    result *= temp_precise_t(rhs);
+    return result;
+}
+
+inline temp_long_t temp_precise_t::operator*(temp_long_t const & rhs) {
+    temp_long_t result(*this);
+    result *= temp_long_t(rhs);
+    return result;
+}
+
+// multiplication with uint16_t returns long temperature. Will be constrained later if assigned to temp_t
+inline temp_long_t temp_t::operator*(uint16_t const rhs) {
+    temp_long_t result(*this);
+    result.value_ *= rhs;
+    return result;
+}
+
+inline temp_long_t temp_precise_t::operator*(uint16_t const rhs) {
+    temp_long_t resultUpper(*this); // lower precision bits will be discarded
+    temp_precise_t resultLower(*this);
+    uint8_t const duplicatedBits = temp_precise_t::fractional_bit_count - temp_long_t::fractional_bit_count;
+
+    resultLower.value_ = resultLower.value_ & ((0x1 << duplicatedBits) - 1); // discard upper bits from lower, which are already in upper
+    resultUpper.value_ *= rhs;
+    resultLower.value_ *= rhs;
+
+    return resultUpper + resultLower;
+}
+
+// Division
+
+inline temp_t temp_t::operator/(temp_t const & rhs) {
+    temp_t result(*this);
+    result /= rhs;
+    return result;
+}
+
+inline temp_precise_t temp_t::operator/(temp_precise_t const & rhs) {
+    temp_precise_t result(*this);
+    result /= rhs;
+    return result;
+}
+
+inline temp_long_t temp_t::operator/(temp_long_t const & rhs) {
+    temp_long_t result(*this);
+    result /= rhs;
+    return result;
+}
+
+inline temp_long_t temp_long_t::operator/(temp_long_t const & rhs) {
+    temp_long_t result(*this);
+    result /= rhs;
+    return result;
+}
+
+inline temp_long_t temp_long_t::operator/(temp_precise_t const & rhs) {
+    temp_long_t result(*this);
+    result /= temp_long_t(rhs);
+    return result;
+}
+
+inline temp_long_t temp_long_t::operator/(temp_t const & rhs) {
+    temp_long_t result(*this);
+    result /= temp_long_t(rhs);
+    return result;
+}
+
+inline temp_precise_t temp_precise_t::operator/(temp_precise_t const & rhs) {
+    temp_precise_t result(*this);
+    result /= rhs;
+    return result;
+}
+
+inline temp_precise_t temp_precise_t::operator/(temp_t const & rhs) {
+    temp_precise_t result(*this);
+    result /= temp_precise_t(rhs);
+    return result;
+}
+
+inline temp_long_t temp_precise_t::operator/(temp_long_t const & rhs) {
+    temp_long_t result(*this);
+    result /= temp_long_t(rhs);
+    return result;
+}
+
+inline temp_t temp_t::operator/(uint16_t const rhs) {
+    temp_t result(*this);
+    result.value_ = (result.value_ + (rhs >> 1) ) / rhs; // rounded divide
+    return result;
+}
+
+inline temp_precise_t temp_precise_t::operator/(uint16_t const rhs) {
+    temp_precise_t result(*this);
+    result.value_ = (result.value_ + (rhs >> 1) ) / rhs; // rounded divide
+    return result;
+}
+
+inline temp_long_t temp_long_t::operator/(uint16_t const rhs) {
+    temp_long_t result(*this);
+    result.value_ = (result.value_ + (rhs >> 1) ) / rhs; // rounded divide
+    return result;
+}
+
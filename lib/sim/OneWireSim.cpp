@@ -0,0 +1,183 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "OneWireSim.h"
+#include "OneWireSimPlant.h"
+#include "OneWire.h"
+#include <string.h>
+
+OneWireSimDevice::OneWireSimDevice(uint8_t family, uint8_t serial)
+{
+    memset(address, 0, sizeof(address));
+    address[0] = family;
+    address[1] = serial;
+    address[7] = OneWire::crc8(address, 7);
+}
+
+OneWireSimBus::OneWireSimBus() : plant(nullptr), state(IDLE), bitIndex(0)
+{
+}
+
+void OneWireSimBus::add(OneWireSimDevice * device)
+{
+    devices.push_back(device);
+    participating.push_back(false);
+}
+
+void OneWireSimBus::remove(OneWireSimDevice * device)
+{
+    for (uint8_t i = 0; i < devices.size(); i++){
+        if(devices[i] == device){
+            devices.erase(devices.begin() + i);
+            participating.erase(participating.begin() + i);
+            return;
+        }
+    }
+}
+
+bool OneWireSimBus::addressBit(OneWireSimDevice * device, uint8_t bit) const
+{
+    return (device->getAddress()[bit / 8] >> (bit % 8)) & 1;
+}
+
+bool OneWireSimBus::reset()
+{
+    if(plant){
+        plant->update();
+    }
+    for (uint8_t i = 0; i < devices.size(); i++){
+        devices[i]->reset();
+        participating[i] = true;
+    }
+    state = ROM_COMMAND;
+    bitIndex = 0;
+    return !devices.empty(); // presence pulse
+}
+
+void OneWireSimBus::write(uint8_t b)
+{
+    switch(state){
+    case ROM_COMMAND:
+        switch(b){
+        case 0xCC: // skip ROM, all devices are selected
+            state = FUNCTION;
+            break;
+        case 0x55: // match ROM
+            state = MATCH_ROM;
+            break;
+        case 0xF0: // search ROM
+            state = SEARCH;
+            break;
+        default: // alarm search and other ROM commands are not simulated, no device responds
+            state = IDLE;
+            break;
+        }
+        break;
+    case MATCH_ROM:
+        matchRom[bitIndex / 8] = b;
+        bitIndex += 8;
+        if(bitIndex == 64){
+            for (uint8_t i = 0; i < devices.size(); i++){
+                participating[i] = memcmp(devices[i]->getAddress(), matchRom, 8) == 0;
+            }
+            state = FUNCTION;
+        }
+        break;
+    case FUNCTION:
+        for (uint8_t i = 0; i < devices.size(); i++){
+            if(participating[i]){
+                devices[i]->write(b);
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+uint8_t OneWireSimBus::read()
+{
+    uint8_t result = 0xFF;
+    if(state == FUNCTION){
+        for (uint8_t i = 0; i < devices.size(); i++){
+            if(participating[i]){
+                result &= devices[i]->read(); // devices pull the bus low, so the result is the wired AND
+            }
+        }
+    }
+    return result;
+}
+
+void OneWireSimBus::write_bit(uint8_t v)
+{
+    // single bit writes are not used by the simulated devices
+}
+
+uint8_t OneWireSimBus::read_bit()
+{
+    // the only single bit read is for the power supply, simulated devices are never parasite powered
+    return 1;
+}
+
+void OneWireSimBus::search_triplet(uint8_t * search_direction, uint8_t * id_bit, uint8_t * cmp_id_bit)
+{
+    if(state != SEARCH || bitIndex >= 64){
+        *id_bit = 1;
+        *cmp_id_bit = 1;
+        return;
+    }
+    // all participating devices send their address bit, then its complement
+    bool anyZero = false;
+    bool anyOne = false;
+    for (uint8_t i = 0; i < devices.size(); i++){
+        if(participating[i]){
+            if(addressBit(devices[i], bitIndex)){
+                anyOne = true;
+            }
+            else {
+                anyZero = true;
+            }
+        }
+    }
+    *id_bit = !anyZero;
+    *cmp_id_bit = !anyOne;
+    if(anyZero && !anyOne){
+        *search_direction = 0;
+    }
+    else if (anyOne && !anyZero){
+        *search_direction = 1;
+    }
+    // devices that do not match the chosen direction stop participating
+    for (uint8_t i = 0; i < devices.size(); i++){
+        if(participating[i] && addressBit(devices[i], bitIndex) != bool(*search_direction)){
+            participating[i] = false;
+        }
+    }
+    bitIndex++;
+    if(bitIndex == 64){
+        state = FUNCTION; // the device that was found is selected
+    }
+}
+
+OneWireSimBus & OneWireSimBus::forAddress(uint8_t address)
+{
+    static OneWireSimBus buses[4];
+    return buses[address & 0x3];
+}
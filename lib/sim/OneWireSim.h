@@ -0,0 +1,148 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+class OneWireSimPlant;
+
+/*
+ * A simulated OneWire device. The bus handles the ROM commands, the device only sees the bytes of a transaction
+ * after it has been selected: first the function command, then its data.
+ */
+class OneWireSimDevice
+{
+public:
+    OneWireSimDevice(uint8_t family, uint8_t serial);
+    virtual ~OneWireSimDevice(){}
+
+    const uint8_t * getAddress() const {
+        return address;
+    }
+
+    // called on a bus reset, which ends the transaction
+    virtual void reset(){}
+
+    virtual void write(uint8_t b) = 0;
+
+    // reading without anything to send leaves the bus high
+    virtual uint8_t read(){
+        return 0xFF;
+    }
+
+private:
+    uint8_t address[8];
+};
+
+/*
+ * A simulated OneWire bus with the devices connected to it. It implements the ROM commands, including search.
+ * Bytes written to a selected device are passed on to it, bytes read are the wired AND of all selected devices.
+ */
+class OneWireSimBus
+{
+public:
+    OneWireSimBus();
+
+    void add(OneWireSimDevice * device);
+    void remove(OneWireSimDevice * device);
+
+    bool reset();
+    void write(uint8_t b);
+    uint8_t read();
+    void write_bit(uint8_t v);
+    uint8_t read_bit();
+    void search_triplet(uint8_t * search_direction, uint8_t * id_bit, uint8_t * cmp_id_bit);
+
+    /*
+     * Sets the hardware model that is updated on each bus reset, before the devices respond.
+     */
+    void setPlant(OneWireSimPlant * p){
+        plant = p;
+    }
+
+    /*
+     * Returns the simulated bus for a OneWire address or pin. Buses are created on first use.
+     */
+    static OneWireSimBus & forAddress(uint8_t address);
+
+private:
+    enum State : uint8_t {
+        ROM_COMMAND,    // waiting for the ROM command after a reset
+        MATCH_ROM,      // receiving the address of the device to select
+        SEARCH,         // search in progress, bits are exchanged with search_triplet
+        FUNCTION,       // devices are selected and receive function commands
+        IDLE            // transaction was not for any device, waiting for a reset
+    };
+
+    bool addressBit(OneWireSimDevice * device, uint8_t bit) const;
+
+    OneWireSimPlant * plant;
+    std::vector<OneWireSimDevice *> devices;
+    std::vector<bool> participating; // devices still selected by a match or search
+    State state;
+    uint8_t bitIndex;    // bit of the ROM that is matched or searched
+    uint8_t matchRom[8];
+};
+
+/*
+ * OneWire driver that talks to a simulated bus, so the application can run without hardware.
+ */
+class OneWireSim
+{
+public:
+    OneWireSim(uint8_t address) : address(address), bus(OneWireSimBus::forAddress(address)){}
+
+    bool init(){
+        return true;
+    }
+
+    uint8_t pinNr(){
+        return address;
+    }
+
+    bool reset(){
+        return bus.reset();
+    }
+
+    void write(uint8_t b, uint8_t power = 0){
+        bus.write(b);
+    }
+
+    uint8_t read(){
+        return bus.read();
+    }
+
+    void write_bit(uint8_t v){
+        bus.write_bit(v);
+    }
+
+    uint8_t read_bit(){
+        return bus.read_bit();
+    }
+
+    void search_triplet(uint8_t * search_direction, uint8_t * id_bit, uint8_t * cmp_id_bit){
+        bus.search_triplet(search_direction, id_bit, cmp_id_bit);
+    }
+
+private:
+    uint8_t address;
+    OneWireSimBus & bus;
+};
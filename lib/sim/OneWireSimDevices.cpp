@@ -0,0 +1,164 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "OneWireSimDevices.h"
+#include "OneWire.h"
+#include "DallasTemperature.h"
+#include "DS2413.h"
+#include "DS2408.h"
+#include <math.h>
+
+#define ACCESS_READ 0xF5
+#define ACCESS_WRITE 0x5A
+#define ACK_SUCCESS 0xAA
+#define ACK_ERROR 0xFF
+
+DS18B20Sim::DS18B20Sim(uint8_t serial) :
+    OneWireSimDevice(DS18B20MODEL, serial),
+    temperature(20.0),
+    command(0),
+    index(0)
+{
+    scratchpad[HIGH_ALARM_TEMP] = 0x4B;
+    scratchpad[LOW_ALARM_TEMP] = 0x46;
+    scratchpad[CONFIGURATION] = TEMP_12_BIT;
+    scratchpad[INTERNAL_BYTE] = 0xFF;
+    scratchpad[COUNT_REMAIN] = 0x0C;
+    scratchpad[COUNT_PER_C] = 0x10;
+    setScratchpadTemperature(85.0); // power on reset value
+}
+
+void DS18B20Sim::setScratchpadTemperature(double temp)
+{
+    temp = temp < -55.0 ? -55.0 : (temp > 125.0 ? 125.0 : temp);
+    int16_t raw = int16_t(lround(temp * 16));
+    uint8_t unusedBits = 3 - ((scratchpad[CONFIGURATION] >> 5) & 0x3); // low bits are undefined at lower resolution
+    raw &= ~((1 << unusedBits) - 1);
+    scratchpad[TEMP_LSB] = uint8_t(raw);
+    scratchpad[TEMP_MSB] = uint8_t(raw >> 8);
+    scratchpad[SCRATCHPAD_CRC] = OneWire::crc8(scratchpad, 8);
+}
+
+void DS18B20Sim::reset()
+{
+    command = 0;
+    index = 0;
+}
+
+void DS18B20Sim::write(uint8_t b)
+{
+    if(!command){
+        command = b;
+        if(command == STARTCONVO){
+            setScratchpadTemperature(temperature); // conversion is instant
+        }
+        else if(command == WRITESCRATCH){
+            index = HIGH_ALARM_TEMP;
+        }
+        return;
+    }
+    if(command == WRITESCRATCH && index <= CONFIGURATION){
+        scratchpad[index++] = b;
+        scratchpad[SCRATCHPAD_CRC] = OneWire::crc8(scratchpad, 8);
+    }
+}
+
+uint8_t DS18B20Sim::read()
+{
+    if(command == READSCRATCH && index < 9){
+        return scratchpad[index++];
+    }
+    if(command == STARTCONVO){
+        return 0xFF; // conversion is done
+    }
+    return OneWireSimDevice::read();
+}
+
+OneWireSwitchSim::OneWireSwitchSim(uint8_t family, uint8_t serial, uint8_t channels) :
+    OneWireSimDevice(family, serial),
+    mask(uint8_t((1 << channels) - 1)),
+    latches(0xFF),
+    pulledLow(0),
+    command(0),
+    received(0),
+    written(0),
+    acknowledged(false)
+{
+}
+
+void OneWireSwitchSim::reset()
+{
+    command = 0;
+    received = 0;
+    acknowledged = false;
+}
+
+void OneWireSwitchSim::write(uint8_t b)
+{
+    if(!command){
+        command = b;
+        return;
+    }
+    if(command == ACCESS_WRITE){
+        received++;
+        if(received == 1){
+            written = b;
+        }
+        else if(received == 2 && b == uint8_t(~written)){
+            latches = (latches & ~mask) | (written & mask);
+        }
+    }
+}
+
+uint8_t OneWireSwitchSim::read()
+{
+    if(command == ACCESS_READ){
+        return status();
+    }
+    if(command == ACCESS_WRITE && received >= 2){
+        if(!acknowledged){
+            acknowledged = true;
+            return received == 2 && (latches & mask) == (written & mask) ? ACK_SUCCESS : ACK_ERROR;
+        }
+        return status();
+    }
+    return OneWireSimDevice::read();
+}
+
+DS2413Sim::DS2413Sim(uint8_t serial) : OneWireSwitchSim(DS2413_FAMILY_ID, serial, 2)
+{
+}
+
+uint8_t DS2413Sim::status() const
+{
+    uint8_t pins = pinState();
+    uint8_t latches = latchState();
+    uint8_t s = (pins & 0x1) | ((latches & 0x1) << 1) | ((pins & 0x2) << 1) | ((latches & 0x2) << 2);
+    return s | ((~s & 0x0F) << 4);
+}
+
+DS2408Sim::DS2408Sim(uint8_t serial) : OneWireSwitchSim(DS2408_FAMILY_ID, serial, 8)
+{
+}
+
+uint8_t DS2408Sim::status() const
+{
+    return pinState();
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "OneWireSim.h"
+
+/*
+ * Simulated DS18B20 temperature sensor. A conversion copies the current temperature to the scratchpad.
+ * Like the real sensor, the scratchpad reads 85 degrees until the first conversion.
+ */
+class DS18B20Sim : public OneWireSimDevice
+{
+public:
+    DS18B20Sim(uint8_t serial);
+
+    void setTemperature(double temp){
+        temperature = temp;
+    }
+
+    double getTemperature() const {
+        return temperature;
+    }
+
+    void reset() override final;
+    void write(uint8_t b) override final;
+    uint8_t read() override final;
+
+private:
+    void setScratchpadTemperature(double temp);
+
+    double temperature;
+    uint8_t scratchpad[9];
+    uint8_t command;
+    uint8_t index; // byte of the scratchpad that is read or written next
+};
+
+/*
+ * Simulated switch with a number of PIO channels. Each channel has an output latch that pulls the pin low when
+ * it is active, and senses the pin level, which is high unless the latch or the connected hardware pulls it low.
+ */
+class OneWireSwitchSim : public OneWireSimDevice
+{
+public:
+    OneWireSwitchSim(uint8_t family, uint8_t serial, uint8_t channels);
+
+    bool latchActive(uint8_t pio) const {
+        return !(latches & (1 << pio));
+    }
+
+    // simulates external hardware pulling the pin low
+    void setPulledLow(uint8_t pio, bool low){
+        if(low){
+            pulledLow |= (1 << pio);
+        }
+        else {
+            pulledLow &= ~(1 << pio);
+        }
+    }
+
+    void reset() override final;
+    void write(uint8_t b) override final;
+    uint8_t read() override final;
+
+protected:
+    uint8_t pinState() const {
+        return latches & ~pulledLow;
+    }
+
+    uint8_t latchState() const {
+        return latches;
+    }
+
+    // the byte returned by a channel access read
+    virtual uint8_t status() const = 0;
+
+private:
+    uint8_t mask;
+    uint8_t latches;    // written latch state, 0 is active
+    uint8_t pulledLow;
+    uint8_t command;
+    uint8_t received;   // number of bytes received after the command
+    uint8_t written;
+    bool acknowledged;
+};
+
+/*
+ * Simulated DS2413 dual channel switch. A channel access read returns the pin and latch states of both channels
+ * in the lower nibble and their complement in the upper nibble.
+ */
+class DS2413Sim : public OneWireSwitchSim
+{
+public:
+    DS2413Sim(uint8_t serial);
+
+protected:
+    uint8_t status() const override final;
+};
+
+/*
+ * Simulated DS2408 eight channel switch. A channel access read returns the pin states.
+ */
+class DS2408Sim : public OneWireSwitchSim
+{
+public:
+    DS2408Sim(uint8_t serial);
+
+protected:
+    uint8_t status() const override final;
+};
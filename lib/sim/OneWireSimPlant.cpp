@@ -0,0 +1,149 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "OneWireSimPlant.h"
+#include <string.h>
+
+OneWireSimPlant::OneWireSimPlant(OneWireSimBus & bus) :
+    bus(bus),
+    lastUpdate(ticks.millis())
+{
+    bus.setPlant(this);
+}
+
+OneWireSimPlant::~OneWireSimPlant()
+{
+    bus.setPlant(nullptr);
+    for (auto & d : devices){
+        bus.remove(d.get());
+    }
+}
+
+bool OneWireSimPlant::parseRole(const char * name, Role & role)
+{
+    static const char * const names[] = { "-", "beer", "fridge", "room", "heater", "cooler" };
+    for (uint8_t i = 0; i < sizeof(names) / sizeof(names[0]); i++){
+        if(strcmp(name, names[i]) == 0){
+            role = Role(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool OneWireSimPlant::addDevice(const char * line)
+{
+    char buffer[80];
+    strncpy(buffer, line, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    const char * separators = " \t\r\n";
+    char * type = strtok(buffer, separators);
+    if(!type){
+        return false;
+    }
+    Role roles[8];
+    uint8_t numRoles = 0;
+    while (char * name = strtok(nullptr, separators)){
+        if(numRoles == 8 || !parseRole(name, roles[numRoles])){
+            return false;
+        }
+        numRoles++;
+    }
+
+    uint8_t serial = devices.size() + 1;
+    if(strcmp(type, "ds18b20") == 0){
+        if(numRoles > 1 || (numRoles == 1 && roles[0] > ROOM)){
+            return false;
+        }
+        DS18B20Sim * sensor = new DS18B20Sim(serial);
+        devices.emplace_back(sensor);
+        sensors.push_back({sensor, numRoles ? roles[0] : NONE});
+    }
+    else {
+        OneWireSwitchSim * device;
+        uint8_t numChannels;
+        if(strcmp(type, "ds2413") == 0){
+            device = new DS2413Sim(serial);
+            numChannels = 2;
+        }
+        else if(strcmp(type, "ds2408") == 0){
+            device = new DS2408Sim(serial);
+            numChannels = 8;
+        }
+        else {
+            return false;
+        }
+        devices.emplace_back(device);
+        if(numRoles > numChannels){
+            devices.pop_back();
+            return false;
+        }
+        for (uint8_t pio = 0; pio < numRoles; pio++){
+            if(roles[pio] != NONE){
+                channels.push_back({device, pio, roles[pio]});
+            }
+        }
+    }
+    bus.add(devices.back().get());
+    return true;
+}
+
+void OneWireSimPlant::addDefaultDevices()
+{
+    addDevice("ds18b20 beer");
+    addDevice("ds18b20 fridge");
+    addDevice("ds18b20 room");
+    addDevice("ds2413 cooler heater");
+}
+
+bool OneWireSimPlant::active(Role role) const
+{
+    for (auto & c : channels){
+        if(c.role == role && c.device->latchActive(c.pio)){
+            return true;
+        }
+    }
+    return false;
+}
+
+double OneWireSimPlant::temperature(Role role) const
+{
+    switch(role){
+    case BEER:
+        return model.beerTemp;
+    case FRIDGE:
+        return model.airTemp;
+    default:
+        return model.envTemp;
+    }
+}
+
+void OneWireSimPlant::update()
+{
+    ticks_millis_t now = ticks.millis();
+    while (now - lastUpdate >= 1000){
+        model.update(active(HEATER), active(COOLER));
+        lastUpdate += 1000;
+    }
+    for (auto & s : sensors){
+        s.device->setTemperature(temperature(s.role));
+    }
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "OneWireSimDevices.h"
+#include "SimulationModels.h"
+#include "Ticks.h"
+
+/*
+ * Simulated brewing hardware on a OneWire bus: temperature sensors and switches that are connected to the fridge
+ * model from SimulationModels.h. The switch channels drive the heater and cooler of the model and the sensors read
+ * its temperatures, so the complete firmware can be run against it without hardware.
+ *
+ * The model is advanced in steps of one second, each time the bus is reset. It follows ticks, so it runs as fast
+ * as a virtual clock.
+ */
+class OneWireSimPlant
+{
+public:
+    enum Role : uint8_t {
+        NONE,
+        BEER,       // sensor in the beer
+        FRIDGE,     // sensor in the fridge air
+        ROOM,       // sensor outside the fridge
+        HEATER,     // switch channel that turns the heater on
+        COOLER      // switch channel that turns the cooler on
+    };
+
+    OneWireSimPlant(OneWireSimBus & bus);
+    ~OneWireSimPlant();
+
+    /*
+     * Adds a device from a line of text: the device type, followed by the role of the sensor or of each channel.
+     * For example "ds18b20 beer" or "ds2413 cooler heater". Unused channels are "-".
+     * Returns false when the line is not understood.
+     */
+    bool addDevice(const char * line);
+
+    /*
+     * Adds a fridge with a beer, fridge and room sensor, and a DS2413 for the cooler and heater.
+     */
+    void addDefaultDevices();
+
+    /*
+     * Advances the model to the current time and updates the sensors.
+     */
+    void update();
+
+    Simulation & getModel(){
+        return model;
+    }
+
+    const std::vector<std::unique_ptr<OneWireSimDevice>> & getDevices() const {
+        return devices;
+    }
+
+private:
+    struct Sensor {
+        DS18B20Sim * device;
+        Role role;
+    };
+
+    struct Channel {
+        OneWireSwitchSim * device;
+        uint8_t pio;
+        Role role;
+    };
+
+    bool active(Role role) const;
+    double temperature(Role role) const;
+    static bool parseRole(const char * name, Role & role);
+
+    OneWireSimBus & bus;
+    Simulation model;
+    std::vector<std::unique_ptr<OneWireSimDevice>> devices;
+    std::vector<Sensor> sensors;
+    std::vector<Channel> channels;
+    ticks_millis_t lastUpdate;
+};
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "temperatureFormats.h"
+
+/* Thermal models used by the simulation tests.
+ * Each model is updated once per simulated second with the state of the actuators acting on it.
+ */
+
+/* This class simulates a fridge is a simple way:
+ * There are 3 heat capacities: the beer itself, the air in the fridge and the fridge walls.
+ * The heater heats the air in the fridge directly.
+ * The cooler cools the fridge walls, which in turn cool the fridge air.
+ * This causes an extra delay when cooling and a potential source of overshoot
+ */
+
+
+struct Simulation{
+    Simulation(){
+        beerTemp = 20.0;
+        airTemp = 20.0;
+        wallTemp = 20.0;
+        envTemp = 20.0;
+        heaterTemp = 20.0;
+
+        beerCapacity = 4.2 * 1.0 * 20; // heat capacity water * density of water * 20L volume (in kJ per kelvin).
+        airCapacity = 1.005 * 1.225 * 0.200; // heat capacity of dry air * density of air * 200L volume (in kJ per kelvin).
+        // Moist air has only slightly higher heat capacity, 1.02 when saturated at 20C.
+        wallCapacity = 5.0; // just a guess
+        heaterCapacity = 1.0; // also a guess, to simulate that heater first heats itself, then starts heating the air
+
+        heaterPower = 0.1; // 100W, in kW.
+        coolerPower = 0.1; // 100W, in kW. Assuming 200W at 50% efficiency
+
+        airBeerTransfer= 1.0/300;
+        wallAirTransfer= 1.0/300;
+        heaterAirTransfer= 1.0/30;
+        envWallTransfer = 0.001; // losses to environment
+
+        heaterToBeer = 0.0; // ratio of heater transfered directly to beer instead of fridge air
+        heaterToAir = 1.0 - heaterToBeer;
+
+    }
+    virtual ~Simulation(){}
+
+    void update(bool heaterActive, bool coolerActive){
+        double beerTempNew = beerTemp;
+        double airTempNew = airTemp;
+        double wallTempNew = wallTemp;
+        double heaterTempNew = heaterTemp;
+
+        beerTempNew += (airTemp - beerTemp) * airBeerTransfer / beerCapacity;
+
+        if(heaterActive){
+            heaterTempNew += heaterPower / heaterCapacity;
+        }
+        if(coolerActive){
+            wallTempNew -= coolerPower / wallCapacity;
+        }
+
+        airTempNew += (heaterTemp - airTemp) * heaterAirTransfer / airCapacity;
+        airTempNew += (wallTemp - airTemp) * wallAirTransfer / airCapacity;
+        airTempNew += (beerTemp - airTemp) * airBeerTransfer / airCapacity;
+
+
+        beerTempNew += (airTemp - beerTemp) * airBeerTransfer / beerCapacity;
+
+        heaterTempNew += (airTemp - heaterTemp) * heaterAirTransfer / heaterCapacity;
+
+        wallTempNew += (envTemp - wallTemp) * envWallTransfer / wallCapacity;
+        wallTempNew += (airTemp - wallTemp) * wallAirTransfer/ wallCapacity;
+
+        airTemp = airTempNew;
+        beerTemp = beerTempNew;
+        wallTemp = wallTempNew;
+        heaterTemp = heaterTempNew;
+    }
+
+    double beerTemp;
+    double airTemp;
+    double wallTemp;
+    double envTemp;
+    double heaterTemp;
+
+    double beerCapacity;
+    double airCapacity;
+    double wallCapacity;
+    double heaterCapacity;
+
+    double heaterPower;
+    double coolerPower;
+
+    double airBeerTransfer;
+    double wallAirTransfer;
+    double envWallTransfer;
+    double heaterAirTransfer;
+
+    double heaterToBeer;
+    double heaterToAir;
+};
+
+/* This class simulates a mashing process.
+ * There are 3 heat capacities: the beer itself, the air in the fridge and the fridge walls.
+ * The heater heats the air in the fridge directly.
+ * The cooler cools the fridge walls, which in turn cool the fridge air.
+ * This causes an extra delay when cooling and a potential source of overshoot
+ */
+
+
+struct MashSimulation{
+    MashSimulation(){
+        mashTemp = 60.0;
+        hltTemp = 60.0;
+        envTemp = 20.0;
+        coilInTemp = 20;
+        coilOutTemp = 20;
+        mashInTemp = 20;
+
+        mashVolume = 18;
+        hltVolume = 36;
+
+        hltCapacity = 4.2 * 1.0 * hltVolume; // heat capacity water * density of water * 20L volume (in kJ per degree C).
+        mashCapacity = 4.2 * 1.0 * mashVolume;
+
+        hltHeaterPower = 3.5; // 3500W, in kW.
+
+        coilTransfer = 0.8; // percentage of temperature difference picked up in HLT coil
+        flowRate = 10.0/60; // 5 liter per minute, in L/s.
+        kettleEnvTransfer = 0.01; // losses to environment
+        mashToCoilLoss = 0.05; // losses between mash tun and coil
+        coilToMashLoss = 0.03; // losses between mash tun and coil
+
+        mashPumping = true;
+    }
+
+    virtual ~MashSimulation(){}
+
+    void update(temp_t heaterValue){
+        double mashTempNew = mashTemp;
+        double hltTempNew = hltTemp;
+
+        if(mashPumping){
+            coilInTemp = mashTemp - (mashTemp - envTemp) * mashToCoilLoss;
+            coilOutTemp = coilInTemp + (hltTemp - coilInTemp) * coilTransfer;
+            mashInTemp = coilOutTemp - (coilOutTemp - envTemp) * coilToMashLoss;
+
+            // coil transfer
+            mashTempNew = (mashTemp * (mashVolume - flowRate) + mashInTemp*flowRate) / mashVolume;
+            hltTempNew -= (coilOutTemp - coilInTemp) * flowRate / hltCapacity;
+        }
+
+        // heater
+        hltTempNew += hltHeaterPower * double(heaterValue) / (100.0 * hltCapacity);
+
+        // environment loss
+        mashTempNew -= (mashTemp - envTemp) * kettleEnvTransfer / mashCapacity;
+        hltTempNew -= (hltTemp - envTemp) * kettleEnvTransfer / hltCapacity;
+
+        hltTemp = hltTempNew;
+        mashTemp = mashTempNew;
+    }
+
+    double mashVolume;
+    double hltVolume;
+
+    double mashTemp;
+    double hltTemp;
+    double envTemp;
+    double coilInTemp;
+    double coilOutTemp;
+    double mashInTemp;
+
+    double hltCapacity;
+    double mashCapacity;
+
+    double hltHeaterPower;
+
+    double coilTransfer;
+    double flowRate;
+    double kettleEnvTransfer;
+    double mashToCoilLoss;
+    double coilToMashLoss;
+    bool mashPumping;
+};
+
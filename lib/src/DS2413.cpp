@@ -106,6 +106,9 @@ void DS2413::update()
 {
     cachedState = accessRead();
     bool success = cacheIsValid();
+    if(!success){
+        OneWireProfiler::countCrcError(address); // the complement check of the access read failed
+    }
     if(connected && !success){
         connected = false;
         char addressString[17];
@@ -153,12 +153,17 @@ bool DallasTemperature::getAddress(uint8_t* deviceAddress, uint8_t index) {
 // return 1 on success
 #define DALLAS_CRC_RETRIES 2
 bool DallasTemperature::readScratchPadCRC(const uint8_t* deviceAddress, uint8_t* scratchPad) {
+    OneWireProfiler::countTransaction(deviceAddress);
     for (uint8_t i = 0; i < DALLAS_CRC_RETRIES; i++) {
+        if (i > 0) {
+            OneWireProfiler::countRetry(deviceAddress);
+        }
         readScratchPad(deviceAddress, scratchPad);
         bool crcMatch = _wire->crc8(scratchPad, 8) == scratchPad[SCRATCHPAD_CRC];
         if (crcMatch) {
             return true;
         }
+        OneWireProfiler::countCrcError(deviceAddress);
     }
     return false;
 }
@@ -172,6 +177,7 @@ void DallasTemperature::sendCommand(const uint8_t* deviceAddress, uint8_t comman
 // read device's scratch pad
 
 void DallasTemperature::readScratchPad(const uint8_t* deviceAddress, uint8_t* scratchPad) {
+    OneWireProfiler::Scope profile(OneWireProfiler::READ_SCRATCHPAD);
     // send the command
     sendCommand(deviceAddress, READSCRATCH);
 
@@ -419,7 +425,6 @@ bool DallasTemperature::isConversionAvailable(const uint8_t* deviceAddress) {
 }
 #endif
 
-#if REQUIRESWHOLEBUSOPS
 // sends command for all devices on the bus to perform a temperature conversion
 
 void DallasTemperature::requestTemperatures() {
@@ -434,7 +439,6 @@ void DallasTemperature::requestTemperatures() {
 #endif
 
 }
-#endif // REQUIRESWHOLEBUSOPS
 
 // sends command for one device to perform a temperature by address
 
@@ -0,0 +1,316 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DataLog.h"
+#include "Varint.h"
+
+using namespace DataLog;
+
+static void writeUint32(uint8_t * p, uint32_t v){
+    for(uint8_t i = 0; i < 4; i++){
+        p[i] = uint8_t(v >> (8 * i));
+    }
+}
+
+static uint32_t readUint32(const uint8_t * p){
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+// reads the header of a page, returns false if the page does not contain a log page
+static bool readHeader(DataLogStorage const & storage, uint32_t page, uint32_t & sequence){
+    uint8_t header[headerLength];
+    if(!storage.readPage(header, page * storage.pageSize(), headerLength)){
+        return false;
+    }
+    if(header[0] != magic0 || header[1] != magic1 || header[2] != version){
+        return false;
+    }
+    sequence = readUint32(header + 4);
+    return true;
+}
+
+// reads the time of the key frame at the start of a page, returns false if the page does not contain a log page
+static bool readFirstTime(DataLogStorage const & storage, uint32_t page, uint32_t & time){
+    uint32_t sequence;
+    if(!readHeader(storage, page, sequence)){
+        return false;
+    }
+    uint8_t record[6];
+    if(!storage.readPage(record, page * storage.pageSize() + headerLength, sizeof(record))){
+        return false;
+    }
+    if(record[0] != recordKeyFrame){
+        return false;
+    }
+    time = readUint32(record + 2);
+    return true;
+}
+
+bool findNewestDataLogPage(DataLogStorage const & storage, uint32_t & page, uint32_t & sequence){
+    bool found = false;
+    uint32_t count = storage.pageCount();
+    for(uint32_t p = 0; p < count; p++){
+        uint32_t s;
+        if(readHeader(storage, p, s) && (!found || s > sequence)){
+            page = p;
+            sequence = s;
+            found = true;
+        }
+    }
+    return found;
+}
+
+DataLogger::DataLogger(DataLogStorage & storage) :
+    storage(storage),
+    page(0),
+    offset(0),
+    sequence(0),
+    previousTime(0),
+    numPrevious(0)
+{
+}
+
+bool DataLogger::begin()
+{
+    offset = 0;
+    numPrevious = 0;
+    previousTime = 0;
+    if(!findNewestDataLogPage(storage, page, sequence)){
+        page = storage.pageCount() - 1; // first page will be page 0
+        sequence = 0;
+        return false;
+    }
+    // find the time of the last sample, by reading the newest page
+    uint32_t firstTime = 0;
+    readFirstTime(storage, page, firstTime);
+    DataLogReader reader(storage);
+    reader.seek(firstTime);
+    DataLogSample sample;
+    while(reader.next(sample)){
+        previousTime = sample.time;
+    }
+    return true;
+}
+
+bool DataLogger::startPage()
+{
+    offset = 0;
+    page = (page + 1) % storage.pageCount();
+    uint32_t address = page * storage.pageSize();
+    if(!storage.erasePage(address)){
+        return false;
+    }
+    uint8_t header[headerLength] = {magic0, magic1, version, 0xFF};
+    writeUint32(header + 4, ++sequence);
+    if(!storage.writePage(header, address, headerLength)){
+        return false;
+    }
+    offset = headerLength;
+    return true;
+}
+
+uint8_t DataLogger::encodeKeyFrame(uint8_t * record, uint32_t time, const int16_t * values, uint8_t numValues)
+{
+    uint8_t * p = record + 2;
+    writeUint32(p, time);
+    p += 4;
+    *p++ = numValues;
+    for(uint8_t i = 0; i < numValues; i++){
+        p = writeVarint(p, zigzag(values[i]));
+    }
+    record[0] = recordKeyFrame;
+    record[1] = p - record - 2;
+    return p - record;
+}
+
+uint8_t DataLogger::encodeDelta(uint8_t * record, uint32_t time, const int16_t * values, uint8_t numValues)
+{
+    uint8_t * p = record + 2;
+    p = writeVarint(p, time - previousTime);
+    for(uint8_t i = 0; i < numValues; i++){
+        p = writeVarint(p, zigzag(int32_t(values[i]) - previous[i]));
+    }
+    record[0] = recordDelta;
+    record[1] = p - record - 2;
+    return p - record;
+}
+
+bool DataLogger::append(uint32_t time, const int16_t * values, uint8_t numValues)
+{
+    if(numValues > maxValues){
+        numValues = maxValues;
+    }
+    uint8_t record[maxRecordLength];
+    uint8_t length = 0;
+    if(offset != 0 && numValues == numPrevious && time >= previousTime){
+        length = encodeDelta(record, time, values, numValues);
+        if(offset + length > storage.pageSize()){
+            length = 0; // does not fit, start a new page with a key frame
+        }
+    }
+    if(length == 0){
+        length = encodeKeyFrame(record, time, values, numValues);
+        if(offset == 0 || offset + length > storage.pageSize()){
+            if(!startPage()){
+                return false;
+            }
+        }
+    }
+
+    // write the type byte last, so the record is only valid when it is complete
+    uint32_t address = page * storage.pageSize() + offset;
+    if(!storage.writePage(record + 1, address + 1, length - 1) || !storage.writePage(record, address, 1)){
+        offset = 0; // continue on a new page
+        numPrevious = 0;
+        return false;
+    }
+    offset += length;
+    for(uint8_t i = 0; i < numValues; i++){
+        previous[i] = values[i];
+    }
+    numPrevious = numValues;
+    previousTime = time;
+    return true;
+}
+
+DataLogReader::DataLogReader(DataLogStorage & storage) :
+    storage(storage),
+    page(0),
+    pagesLeft(0),
+    offset(0),
+    from(0)
+{
+    current.time = 0;
+    current.numValues = 0;
+}
+
+void DataLogReader::seek(uint32_t from)
+{
+    this->from = from;
+    pagesLeft = 0;
+    offset = 0;
+    uint32_t newest;
+    uint32_t sequence;
+    if(!findNewestDataLogPage(storage, newest, sequence)){
+        return;
+    }
+    // pages are written in order, so the oldest page follows the newest page.
+    // Start at the last page that begins at or before from, or at the oldest page.
+    uint32_t count = storage.pageCount();
+    page = (newest + 1) % count;
+    pagesLeft = count;
+    for(uint32_t i = 0; i < count; i++){
+        uint32_t p = (newest + 1 + i) % count;
+        uint32_t time;
+        if(readFirstTime(storage, p, time) && time <= from){
+            page = p;
+            pagesLeft = count - i;
+        }
+    }
+}
+
+bool DataLogReader::openPage()
+{
+    uint32_t sequence;
+    if(!readHeader(storage, page, sequence)){
+        return false;
+    }
+    offset = headerLength;
+    current.numValues = 0; // a page starts with a key frame
+    return true;
+}
+
+void DataLogReader::nextPage()
+{
+    page = (page + 1) % storage.pageCount();
+    pagesLeft--;
+    offset = 0;
+}
+
+// reads the record at offset into current, returns false at the end of the page
+bool DataLogReader::readRecord()
+{
+    uint32_t address = page * storage.pageSize() + offset;
+    uint8_t record[2 + 255];
+    if(offset + 2 > storage.pageSize() || !storage.readPage(record, address, 2)){
+        return false;
+    }
+    uint8_t type = record[0];
+    uint8_t length = record[1];
+    if(type == recordEnd || offset + 2 + length > storage.pageSize()
+            || !storage.readPage(record + 2, address + 2, length)){
+        return false;
+    }
+    const uint8_t * p = record + 2;
+    const uint8_t * end = p + length;
+    uint32_t v;
+    if(type == recordKeyFrame){
+        if(length < 5){
+            return false;
+        }
+        current.time = readUint32(p);
+        current.numValues = p[4] > maxValues ? maxValues : p[4];
+        p += 5;
+        for(uint8_t i = 0; i < current.numValues; i++){
+            p = readVarint(p, end, v);
+            if(!p){
+                return false;
+            }
+            current.values[i] = unzigzag(v);
+        }
+    }
+    else if(type == recordDelta && current.numValues > 0){
+        p = readVarint(p, end, v);
+        if(!p){
+            return false;
+        }
+        current.time += v;
+        for(uint8_t i = 0; i < current.numValues; i++){
+            p = readVarint(p, end, v);
+            if(!p){
+                return false;
+            }
+            current.values[i] += unzigzag(v);
+        }
+    }
+    else{
+        return false; // unknown record or delta without key frame
+    }
+    offset += 2 + length;
+    return true;
+}
+
+bool DataLogReader::next(DataLogSample & sample)
+{
+    while(pagesLeft > 0){
+        if(offset == 0 && !openPage()){
+            nextPage();
+            continue;
+        }
+        if(!readRecord()){
+            nextPage();
+            continue;
+        }
+        if(current.time >= from){
+            sample = current;
+            return true;
+        }
+    }
+    return false;
+}
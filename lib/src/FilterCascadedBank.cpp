@@ -0,0 +1,217 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FilterCascadedBank.h"
+#include <string.h>
+
+// one block of channels
+typedef int32_t lanes_t __attribute__((vector_size(FilterCascadedBank::lanes * sizeof(int32_t))));
+typedef uint32_t ulanes_t __attribute__((vector_size(FilterCascadedBank::lanes * sizeof(int32_t))));
+
+static inline lanes_t load(int32_t const * p){
+    lanes_t v;
+    memcpy(&v, p, sizeof(v)); // state is not guaranteed to be aligned to the vector size
+    return v;
+}
+
+static inline void store(int32_t * p, lanes_t v){
+    memcpy(p, &v, sizeof(v));
+}
+
+// returns new where mask is all ones, old where mask is zero
+static inline lanes_t select(lanes_t mask, lanes_t newValue, lanes_t oldValue){
+    return (newValue & mask) | (oldValue & ~mask);
+}
+
+// the value to saturate to when a result overflows: max for positive a, min for negative a
+static inline lanes_t saturated(lanes_t a){
+    return (a >> 31) ^ INT32_MAX;
+}
+
+// a + b, constrained to the int32_t range like temp_precise_t::operator+=
+static inline lanes_t satAdd(lanes_t a, lanes_t b){
+    lanes_t sum = lanes_t(ulanes_t(a) + ulanes_t(b));
+    lanes_t overflow = ((a ^ sum) & (b ^ sum)) >> 31; // a and b have the same sign and sum has a different one
+    return select(overflow, saturated(a), sum);
+}
+
+// a - b, constrained to the int32_t range like temp_precise_t::operator-=
+static inline lanes_t satSub(lanes_t a, lanes_t b){
+    lanes_t diff = lanes_t(ulanes_t(a) - ulanes_t(b));
+    lanes_t overflow = ((a ^ b) & (a ^ diff)) >> 31; // a and b have a different sign and diff has the sign of b
+    return select(overflow, saturated(a), diff);
+}
+
+/* Adds one sample to all sections of a block of channels.
+ * Shift is int when all channels in the block have the same b value and lanes_t with a b value per lane otherwise.
+ */
+template<typename Shift>
+static inline void filterBlock(int32_t * block, lanes_t input, lanes_t mask, Shift b){
+    const uint8_t lanes = FilterCascadedBank::lanes;
+    Shift a = b * 2 + 4;
+
+    for (uint8_t s = 0; s < NUM_SECTIONS; s++){
+        int32_t * section = block + s * 6 * lanes; // 6 taps per section: x0, x1, x2, y0, y1, y2
+        lanes_t x0 = load(section);
+        lanes_t x1 = load(section + lanes);
+        lanes_t x2 = load(section + 2 * lanes);
+        lanes_t y0 = load(section + 3 * lanes);
+        lanes_t y1 = load(section + 4 * lanes);
+        lanes_t y2 = load(section + 5 * lanes);
+
+        lanes_t nx0 = input;
+        lanes_t nx1 = x0;
+        lanes_t nx2 = x1;
+        lanes_t ny1 = y0;
+        lanes_t ny2 = y1;
+
+        // same order of operations as FixedFilter::add, to get the same rounding and saturation
+        lanes_t ny0 = satAdd(satSub(ny1, ny2), ny1);
+        ny0 = satSub(ny0, ny1 >> b);
+        ny0 = satAdd(ny0, ny2 >> b);
+        lanes_t temporary = satAdd(satAdd(nx0 >> a, nx1 >> (a - 1)), nx2 >> a);
+        temporary = satSub(temporary, ny2 >> (a - 2));
+        ny0 = satAdd(ny0, temporary);
+
+        store(section, select(mask, nx0, x0));
+        store(section + lanes, select(mask, nx1, x1));
+        store(section + 2 * lanes, select(mask, nx2, x2));
+        store(section + 3 * lanes, select(mask, ny0, y0));
+        store(section + 4 * lanes, select(mask, ny1, y1));
+        store(section + 5 * lanes, select(mask, ny2, y2));
+
+        input = ny0; // output of this section is input for the next section
+    }
+}
+
+FilterCascadedBank::FilterCascadedBank(uint16_t numChannels) : channels(0)
+{
+    for (uint16_t n = 0; n < numChannels; n++){
+        add();
+    }
+}
+
+uint16_t FilterCascadedBank::add()
+{
+    uint16_t n = channels++;
+    if(n % lanes == 0){
+        state.resize(state.size() + blockSize, 0);
+        shiftB.resize(shiftB.size() + lanes, 2);
+        blockB.push_back(2);
+    }
+    b.push_back(2);
+    setFiltering(n, 2); // default to a b value of 2
+    return n;
+}
+
+void FilterCascadedBank::init(uint16_t n, temp_precise_t val)
+{
+    int32_t * block = &state[blockOffset(n)];
+    for (uint8_t s = 0; s < NUM_SECTIONS; s++){
+        for (uint8_t t = 0; t < TAPS; t++){
+            block[(s * TAPS + t) * lanes + n % lanes] = val.getRaw();
+        }
+    }
+}
+
+void FilterCascadedBank::setFiltering(uint16_t n, uint8_t bValue)
+{
+    b[n] = bValue;
+    shiftB[n] = bValue;
+    updateBlockShift(n / lanes);
+}
+
+void FilterCascadedBank::updateBlockShift(uint16_t block)
+{
+    uint16_t first = block * lanes;
+    uint16_t last = (first + lanes < channels) ? first + lanes : channels;
+    int8_t shared = b[first];
+    for (uint16_t n = first + 1; n < last; n++){
+        if(b[n] != shared){
+            shared = -1;
+        }
+    }
+    blockB[block] = shared;
+    for (uint16_t n = last; n < first + lanes; n++){
+        shiftB[n] = b[first]; // unused lanes, keep shifts in range
+    }
+}
+
+void FilterCascadedBank::addToBlock(uint16_t block, int32_t const * input, int32_t const * mask)
+{
+    int32_t * blockState = &state[uint32_t(block) * blockSize];
+    if(blockB[block] >= 0){
+        filterBlock(blockState, load(input), load(mask), int(blockB[block]));
+    }
+    else{
+        filterBlock(blockState, load(input), load(mask), load(&shiftB[block * lanes]));
+    }
+}
+
+void FilterCascadedBank::add(temp_precise_t const * input)
+{
+    addRow(input, nullptr);
+}
+
+void FilterCascadedBank::addRow(temp_precise_t const * input, temp_precise_t * output)
+{
+    int32_t raw[lanes];
+    int32_t all[lanes];
+    for (uint8_t l = 0; l < lanes; l++){
+        all[l] = -1;
+    }
+    uint16_t blocks = numBlocks();
+    for (uint16_t block = 0; block < blocks; block++){
+        uint16_t first = block * lanes;
+        uint8_t used = (channels - first < lanes) ? channels - first : lanes;
+        for (uint8_t l = 0; l < lanes; l++){
+            raw[l] = (l < used) ? input[first + l].getRaw() : 0;
+        }
+        addToBlock(block, raw, all);
+        if(output){
+            int32_t const * y0 = &state[uint32_t(block) * blockSize + ((NUM_SECTIONS - 1) * TAPS + Y0) * lanes];
+            for (uint8_t l = 0; l < used; l++){
+                output[first + l].setRaw(y0[l]);
+            }
+        }
+    }
+}
+
+void FilterCascadedBank::add(temp_precise_t const * input, uint8_t const * mask)
+{
+    int32_t raw[lanes];
+    int32_t laneMask[lanes];
+    uint16_t blocks = numBlocks();
+    for (uint16_t block = 0; block < blocks; block++){
+        uint16_t first = block * lanes;
+        for (uint8_t l = 0; l < lanes; l++){
+            bool used = (first + l < channels);
+            raw[l] = used ? input[first + l].getRaw() : 0;
+            laneMask[l] = (used && mask[first + l]) ? -1 : 0;
+        }
+        addToBlock(block, raw, laneMask);
+    }
+}
+
+void FilterCascadedBank::addBlock(temp_precise_t const * input, temp_precise_t * output, uint32_t samples)
+{
+    for (uint32_t s = 0; s < samples; s++){
+        addRow(input + s * channels, output + s * channels);
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "JsonTokenizer.h"
+
+static bool isSpace(char c){
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+void JsonTokenizer::reset()
+{
+    keyBuffer[0] = 0;
+    valueBuffer[0] = 0;
+    length = 0;
+    state = OPEN;
+    quoted = false;
+    pairDone = false;
+    errorChar = 0;
+}
+
+uint8_t JsonTokenizer::fail(char c)
+{
+    errorChar = c;
+    state = CLOSED;
+    return ERROR;
+}
+
+// ends the current pair, result is PAIR when both key and value are not empty
+uint8_t JsonTokenizer::endPair(uint8_t result)
+{
+    if(state == VALUE && keyBuffer[0] && valueBuffer[0]){
+        result |= PAIR;
+    }
+    return result;
+}
+
+uint8_t JsonTokenizer::feed(char c)
+{
+    switch(state){
+    case OPEN:
+        if(c == '{'){
+            state = KEY;
+            length = 0;
+            keyBuffer[0] = 0;
+            valueBuffer[0] = 0;
+            return NONE;
+        }
+        if(isSpace(c)){
+            return NONE;
+        }
+        return fail(c);
+    case KEY:
+    case VALUE:
+        if(pairDone){
+            // the buffers kept the previous pair until the next character was fed
+            keyBuffer[0] = 0;
+            valueBuffer[0] = 0;
+            pairDone = false;
+        }
+        break;
+    case CLOSED:
+        return ERROR;
+    }
+
+    char * buffer = (state == KEY) ? keyBuffer : valueBuffer;
+    if(quoted){
+        if(c == '"'){
+            quoted = false;
+            return NONE;
+        }
+    }
+    else{
+        if(c == '"'){
+            quoted = true;
+            return NONE;
+        }
+        if(isSpace(c)){
+            return NONE;
+        }
+        if(c == ':' && state == KEY){
+            state = VALUE;
+            length = 0;
+            valueBuffer[0] = 0;
+            return NONE;
+        }
+        if(c == ',' || c == '}'){
+            uint8_t result = endPair((c == '}') ? END : NONE);
+            if(c == '}'){
+                state = CLOSED;
+            }
+            else{
+                state = KEY;
+                length = 0;
+                pairDone = true;
+            }
+            return result;
+        }
+    }
+    if(length >= maxTokenLength){
+        return fail(c);
+    }
+    buffer[length++] = c;
+    buffer[length] = 0;
+    return NONE;
+}
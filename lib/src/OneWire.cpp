@@ -198,6 +198,7 @@ void OneWire::target_search(uint8_t family_code) {
 //
 
 uint8_t OneWire::search(uint8_t *newAddr) {
+    OneWireProfiler::Scope profile(OneWireProfiler::SEARCH);
     uint8_t id_bit_number;
     uint8_t last_zero, rom_byte_number, search_result;
     uint8_t id_bit, cmp_id_bit;
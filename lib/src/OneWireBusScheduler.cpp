@@ -0,0 +1,156 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OneWireBusScheduler.h"
+#include "OneWireTempSensor.h"
+#include "OneWire.h"
+
+OneWireBusScheduler * OneWireBusScheduler::schedulers = nullptr;
+
+OneWireBusScheduler::OneWireBusScheduler(OneWire * bus, ticks_millis_t period) :
+    bus(bus),
+    dallas(bus),
+    period(period),
+    lastConversion(ticks.millis() - period), // start the first conversion immediately
+    nextSensor(0),
+    reconnecting(nullptr),
+    state(IDLE),
+    nextScheduler(nullptr)
+{
+#if REQUIRESWAITFORCONVERSION
+    dallas.setWaitForConversion(false);
+#endif
+}
+
+OneWireBusScheduler::~OneWireBusScheduler()
+{
+    for (auto s : sensors){
+        s->scheduler = nullptr;
+    }
+}
+
+void OneWireBusScheduler::add(OneWireTempSensor * sensor)
+{
+    for (auto s : sensors){
+        if(s == sensor){
+            return;
+        }
+    }
+    sensors.push_back(sensor);
+}
+
+void OneWireBusScheduler::remove(OneWireTempSensor * sensor)
+{
+    if(reconnecting == sensor){
+        reconnecting = nullptr;
+    }
+    for (uint8_t i = 0; i < sensors.size(); i++){
+        if(sensors[i] == sensor){
+            sensors.erase(sensors.begin() + i);
+            if(i < nextSensor){
+                nextSensor--; // keep pointing at the same next sensor
+            }
+            return;
+        }
+    }
+}
+
+void OneWireBusScheduler::update()
+{
+    ticks_millis_t now = ticks.millis();
+    switch(state){
+        case IDLE:
+            if(!sensors.empty() && (now - lastConversion >= period)){
+                dallas.requestTemperatures(); // broadcast to all sensors, returns without waiting
+                lastConversion = now;
+                state = CONVERTING;
+            }
+            break;
+        case CONVERTING:
+            if(now - lastConversion >= conversionTime){
+                nextSensor = 0;
+                state = READING;
+            }
+            break;
+        case READING:
+            if(reconnecting){
+                reconnecting->init(); // reconnect in its own step, init() does several bus transactions
+                reconnecting = nullptr;
+            }
+            else if(nextSensor < sensors.size()){
+                OneWireTempSensor * sensor = sensors[nextSensor++];
+                if(!sensor->readScheduled()){
+                    reconnecting = sensor;
+                }
+            }
+            if(!reconnecting && nextSensor >= sensors.size()){
+                state = IDLE;
+            }
+            break;
+    }
+}
+
+ticks_millis_t OneWireBusScheduler::timeUntilNext() const
+{
+    ticks_millis_t elapsed = ticks.millis() - lastConversion;
+    switch(state){
+        case IDLE:
+            if(sensors.empty()){
+                return UINT32_MAX; // nothing to convert until a sensor is added
+            }
+            return (elapsed >= period) ? 0 : period - elapsed;
+        case CONVERTING:
+            return (elapsed >= conversionTime) ? 0 : conversionTime - elapsed;
+        default:
+            return 0; // the next sensor can be read right away
+    }
+}
+
+OneWireBusScheduler * OneWireBusScheduler::forBus(OneWire * bus)
+{
+    if(bus == nullptr){
+        return nullptr;
+    }
+    for (OneWireBusScheduler * s = schedulers; s != nullptr; s = s->nextScheduler){
+        if(s->bus == bus){
+            return s;
+        }
+    }
+    OneWireBusScheduler * s = new OneWireBusScheduler(bus);
+    s->nextScheduler = schedulers;
+    schedulers = s;
+    return s;
+}
+
+void OneWireBusScheduler::updateAll()
+{
+    for (OneWireBusScheduler * s = schedulers; s != nullptr; s = s->nextScheduler){
+        s->update();
+    }
+}
+
+ticks_millis_t OneWireBusScheduler::timeUntilNextAll()
+{
+    ticks_millis_t next = UINT32_MAX;
+    for (OneWireBusScheduler * s = schedulers; s != nullptr; s = s->nextScheduler){
+        ticks_millis_t t = s->timeUntilNext();
+        next = (t < next) ? t : next;
+    }
+    return next;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OneWireProfiler.h"
+
+#if ONEWIRE_PROFILE
+
+#include <string.h>
+
+const uint8_t OneWireProfiler::numBuckets;
+const uint8_t OneWireProfiler::firstBucketBits;
+const uint8_t OneWireProfiler::maxDevices;
+
+OneWireProfiler::OperationStats OneWireProfiler::operations[OneWireProfiler::NUM_OPERATIONS];
+OneWireProfiler::DeviceStats OneWireProfiler::devices[OneWireProfiler::maxDevices];
+uint8_t OneWireProfiler::deviceCount = 0;
+
+uint8_t OneWireProfiler::bucket(uint32_t micros)
+{
+    uint8_t b = 0;
+    micros >>= firstBucketBits;
+    while(micros > 0 && b < numBuckets - 1){
+        micros >>= 1;
+        b++;
+    }
+    return b;
+}
+
+void OneWireProfiler::record(Operation op, uint32_t micros)
+{
+    OperationStats & stats = operations[op];
+    stats.count++;
+    if(micros > stats.maxMicros){
+        stats.maxMicros = micros;
+    }
+    stats.buckets[bucket(micros)]++;
+}
+
+OneWireProfiler::DeviceStats * OneWireProfiler::device(const uint8_t * address)
+{
+    for(uint8_t i = 0; i < deviceCount; i++){
+        if(memcmp(devices[i].address, address, sizeof(DeviceAddress)) == 0){
+            return &devices[i];
+        }
+    }
+    if(deviceCount >= maxDevices){
+        return nullptr;
+    }
+    DeviceStats * d = &devices[deviceCount++];
+    memcpy(d->address, address, sizeof(DeviceAddress));
+    d->transactions = 0;
+    d->crcErrors = 0;
+    d->retries = 0;
+    return d;
+}
+
+void OneWireProfiler::countTransaction(const uint8_t * address)
+{
+    DeviceStats * d = device(address);
+    if(d){
+        d->transactions++;
+    }
+}
+
+void OneWireProfiler::countCrcError(const uint8_t * address)
+{
+    DeviceStats * d = device(address);
+    if(d && d->crcErrors < UINT16_MAX){
+        d->crcErrors++;
+    }
+}
+
+void OneWireProfiler::countRetry(const uint8_t * address)
+{
+    DeviceStats * d = device(address);
+    if(d && d->retries < UINT16_MAX){
+        d->retries++;
+    }
+}
+
+void OneWireProfiler::clear()
+{
+    memset(operations, 0, sizeof(operations));
+    deviceCount = 0;
+}
+
+const char * OneWireProfiler::operationName(Operation op)
+{
+    switch(op){
+        case RESET: return "reset";
+        case SEARCH: return "search";
+        case READ_SCRATCHPAD: return "readScratchPad";
+        case SWITCH_ACCESS_READ: return "accessRead";
+        case SWITCH_ACCESS_WRITE: return "accessWrite";
+        default: return "";
+    }
+}
+
+#endif
@@ -35,6 +35,8 @@ bool OneWireSwitch::validAddress(OneWire *     oneWire,
 uint8_t OneWireSwitch::accessRead()    /* const */
 {
 #define ACCESS_READ 0xF5
+    OneWireProfiler::Scope profile(OneWireProfiler::SWITCH_ACCESS_READ);
+    OneWireProfiler::countTransaction(address);
     oneWire -> reset();
     oneWire -> select(address);
     oneWire -> write(ACCESS_READ);
@@ -60,6 +62,8 @@ bool OneWireSwitch::accessWrite(uint8_t b,
 
     // b |= 0xFC;        /* Upper 6 bits should be set to 1's */
     uint8_t ack = 0;
+    OneWireProfiler::Scope profile(OneWireProfiler::SWITCH_ACCESS_WRITE);
+    OneWireProfiler::countTransaction(address);
 
     do{
         oneWire -> reset();
@@ -76,6 +80,9 @@ bool OneWireSwitch::accessWrite(uint8_t b,
         if (ack == ACK_SUCCESS){
             oneWire -> read();    // status byte sent after ack
         }
+        if (ack != ACK_SUCCESS && maxTries > 0) {
+            OneWireProfiler::countRetry(address);
+        }
     } while ((ack != ACK_SUCCESS) && (maxTries-- > 0));
 
     oneWire -> reset();
@@ -23,10 +23,25 @@
 #include "OneWireAddress.h"
 #include "DallasTemperature.h"
 #include "OneWire.h"
+#include "OneWireBusScheduler.h"
 #include "Ticks.h"
 #include "Logger.h"
 
+OneWireTempSensor::OneWireTempSensor(OneWire* bus, DeviceAddress address, temp_t calibrationOffset, OneWireBusScheduler * scheduler)
+: oneWire(bus), sensor(NULL), scheduler(scheduler) {
+    connected = true;  // assume connected. Transition from connected to disconnected prints a message.
+    memcpy(sensorAddress, address, sizeof(DeviceAddress));
+    this->calibrationOffset = calibrationOffset;
+    cachedValue = TEMP_SENSOR_DISCONNECTED;
+    if (scheduler) {
+        scheduler->add(this);
+    }
+}
+
 OneWireTempSensor::~OneWireTempSensor() {
+    if (scheduler) {
+        scheduler->remove(this);
+    }
     delete sensor;
 };
 
@@ -63,14 +78,20 @@ bool OneWireTempSensor::init() {
         if(temp == DEVICE_DISCONNECTED_RAW){
             // Device was just powered on and should be initialized
             if(sensor->initConnection(sensorAddress)){
-                requestConversion();
-                waitForConversion();
-                temp = sensor->getTempRaw(sensorAddress);            
+                if (scheduler) {
+                    // Don't block until the conversion is done. The sensor is read after the next scheduled conversion.
+                    success = true;
+                }
+                else {
+                    requestConversion();
+                    waitForConversion();
+                    temp = sensor->getTempRaw(sensorAddress);
+                }
             }
         }        
         DEBUG_ONLY(logInfoIntStringTemp(INFO_TEMP_SENSOR_INITIALIZED, pinNr, addressString, temp));
-        success = temp != DEVICE_DISCONNECTED_RAW;
-        if(success){
+        success = success || temp != DEVICE_DISCONNECTED_RAW;
+        if(success && !scheduler){
             requestConversion(); // piggyback request for a new conversion
         }
     }
@@ -106,6 +127,9 @@ temp_t OneWireTempSensor::read() const {
 }
 
 void OneWireTempSensor::update(){
+    if (scheduler) {
+        return; // cachedValue is updated by the scheduler
+    }
     cachedValue = readAndConstrainTemp();
 
     if(cachedValue.isDisabledOrInvalid()){
@@ -118,6 +142,14 @@ void OneWireTempSensor::update(){
     requestConversion();
 }
 
+bool OneWireTempSensor::readScheduled(){
+    if (sensor == NULL) {
+        return false; // not initialized yet, the next scheduled conversion gives a value
+    }
+    cachedValue = readAndConstrainTemp();
+    return !cachedValue.isDisabledOrInvalid();
+}
+
 temp_t OneWireTempSensor::readAndConstrainTemp() {
     int16_t tempRaw = sensor->getTempRaw(sensorAddress);
     if (tempRaw == DEVICE_DISCONNECTED_RAW) {
@@ -0,0 +1,231 @@
+/*
+ * Copyright 2015 BrewPi / Elco Jacobs
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "PidBank.h"
+
+PidBank::index_t PidBank::add(TempSensorBasic * input, ActuatorRange * output, SetPoint * sp)
+{
+    inputSensor.push_back(input);
+    outputActuator.push_back(output);
+    setPoint.push_back(sp);
+    Kp.push_back(temp_long_t(0.0));
+    Ti.push_back(0);
+    Td.push_back(0);
+    actuatorIsNegative.push_back(false);
+    enabled.push_back(true);
+
+    inputError.push_back(temp_t(0.0));
+    p.push_back(temp_long_t(0.0));
+    i.push_back(temp_long_t(0.0));
+    d.push_back(temp_long_t(0.0));
+    derivative.push_back(temp_precise_t(0.0));
+    integral.push_back(temp_long_t(0.0));
+    previousSetPoint.push_back(temp_t::invalid());
+    failedReadCount.push_back(255); // start at 255, so inputFilter is refreshed at first valid read
+    inputFilter.add();
+    derivativeFilter.add();
+
+    currentSetPoint.push_back(temp_t::invalid());
+    filterInput.push_back(temp_precise_t(0.0));
+    validSetPoint.push_back(false);
+    validSensor.push_back(false);
+
+    index_t n = size() - 1;
+    setInputSensor(n, input);
+    setInputFilter(n, 0);
+    // some filtering necessary due to quantization causing steps in the temperature
+    setDerivativeFilter(n, 2);
+    return n;
+}
+
+bool PidBank::setInputSensor(index_t n, TempSensorBasic * s)
+{
+    inputSensor[n] = s;
+    temp_t t = s -> read();
+
+    if (t.isDisabledOrInvalid()){
+        return false;    // could not read from sensor
+    }
+
+    inputFilter.init(n, t);
+    derivativeFilter.init(n, 0.0);
+
+    return true;
+}
+
+void PidBank::disable(index_t n, bool turnOffOutputActuator)
+{
+    enabled[n] = false;
+    inputError[n] = temp_t::base_type(0);
+    p[n] = temp_long_t::base_type(0);
+    i[n] = temp_long_t::base_type(0);
+    d[n] = temp_long_t::base_type(0);
+    if(turnOffOutputActuator){
+        outputActuator[n] -> setValue(0.0);
+    }
+}
+
+void PidBank::update()
+{
+    index_t size = this->size();
+
+    // read all inputs
+    for (index_t n = 0; n < size; n++){
+        currentSetPoint[n] = setPoint[n]->read();
+        validSetPoint[n] = !currentSetPoint[n].isDisabledOrInvalid();
+
+        temp_t inputVal = inputSensor[n]->read();
+        validSensor[n] = !inputVal.isDisabledOrInvalid();
+
+        if (!validSensor[n]){
+            // Could not read from input sensor
+            if (failedReadCount[n] < 255){    // limit
+                failedReadCount[n]++;
+            }
+        }
+        else{
+            if (failedReadCount[n] > 60){ // filters are stale, re-initialize them
+                inputFilter.init(n, inputVal);
+                derivativeFilter.init(n, temp_precise_t(0.0));
+            }
+            failedReadCount[n] = 0;
+        }
+        filterInput[n] = inputVal;
+    }
+
+    // only update internal filters and inputError if input sensor is valid
+    inputFilter.add(filterInput.data(), validSensor.data());
+
+    for (index_t n = 0; n < size; n++){
+        if(!validSensor[n]){
+            continue;
+        }
+        if(validSetPoint[n]){
+            if(previousSetPoint[n].isDisabledOrInvalid()){
+                previousSetPoint[n] = currentSetPoint[n];
+            }
+            temp_precise_t previousError = inputFilter.readPrevOutput(n) - previousSetPoint[n];
+            temp_precise_t currentError = inputFilter.readOutput(n) - currentSetPoint[n];
+            temp_precise_t delta = currentError - previousError;
+            previousSetPoint[n] = currentSetPoint[n];
+
+            inputError[n] = currentError; // store input error, as temp_t, instead of temp_precise_t
+
+            // Limit to 0.125 degree per second and shift, like in Pid::update()
+            temp_precise_t deltaClipped = delta;
+            temp_precise_t max = temp_precise_t::max() >> uint8_t(10);
+            temp_precise_t min = temp_precise_t::min() >> uint8_t(10);
+            if(deltaClipped > max){
+                deltaClipped = max;
+            }
+            else if(deltaClipped < min){
+                deltaClipped = min;
+            }
+            filterInput[n] = deltaClipped << uint8_t(10);
+        }
+        else{
+            filterInput[n] = temp_precise_t(0.0);
+        }
+    }
+
+    derivativeFilter.add(filterInput.data(), validSensor.data());
+
+    // calculate PID parts and write all outputs
+    for (index_t n = 0; n < size; n++){
+        if(validSensor[n] && validSetPoint[n]){
+            derivative[n] = derivativeFilter.readOutput(n) >> uint8_t(10);
+        }
+
+        bool tooManyFailedReads = !validSensor[n] && failedReadCount[n] > 10; // after 10 failed reads, disable pid
+
+        if(!enabled[n] || tooManyFailedReads || !validSetPoint[n]){
+            inputError[n] = temp_t::invalid();
+            p[n] = temp_long_t(0.0);
+            i[n] = temp_long_t(0.0);
+            d[n] = temp_long_t(0.0);
+        }
+        else{
+            p[n] = Kp[n] * -inputError[n];
+            i[n] = (Ti[n] != 0) ? (integral[n]/Ti[n]) : temp_long_t(0.0);
+            d[n] = -Kp[n] * (derivative[n] * Td[n]);
+        }
+
+        if(!enabled[n]){
+            continue;
+        }
+
+        bool negative = actuatorIsNegative[n];
+        ActuatorRange * actuator = outputActuator[n];
+        temp_long_t pidResult = temp_long_t(p[n]) + temp_long_t(i[n]) + temp_long_t(d[n]);
+
+        // Get output to send to actuator. When actuator is a 'cooler', invert the result
+        temp_t output = (negative) ? -pidResult : pidResult;
+
+        actuator -> setValue(output);
+
+        // get the value that is clipped to the actuator's range
+        output = actuator->getValue();
+        // When actuator is a 'cooler', invert the output again
+        output = (negative) ? -output : output;
+
+        if(Ti[n] == 0){ // integrator disabled
+            integral[n] = temp_long_t::base_type(0);
+            continue;
+        }
+
+        // update integral with anti-windup back calculation, see Pid::update() for details
+        integral[n] = integral[n] + p[n];
+
+        temp_long_t antiWindup(temp_long_t::base_type(0));
+        if(pidResult != temp_long_t(output)){ // clipped to actuator min or max set in target actuator
+            antiWindup = pidResult - output;
+            antiWindup *= 5; // Anti windup gain is 5 when clipping to min/max
+        }
+        else{
+            temp_t achievedOutput = actuator->readValue();
+            if(!achievedOutput.isDisabledOrInvalid()){
+                temp_long_t achievedOutputWithCorrectSign = (negative) ? -achievedOutput : achievedOutput;
+
+                if(negative){
+                    if(p[n] < achievedOutputWithCorrectSign){
+                        antiWindup = (p[n] - achievedOutputWithCorrectSign);
+                    }
+                }
+                else{
+                    if(p[n] > achievedOutputWithCorrectSign){
+                        antiWindup = (p[n] - achievedOutputWithCorrectSign);
+                    }
+                }
+                antiWindup *= 3; // Anti windup gain is 3 for this kind of windup
+            }
+        }
+
+        // only apply anti-windup if it will decrease the integral and prevent crossing through zero
+        if(integral[n].sign() * antiWindup.sign() == 1){
+            if((integral[n] - antiWindup).sign() != integral[n].sign()){
+                integral[n] = temp_long_t::base_type(0);
+            }
+            else{
+                integral[n] -= antiWindup;
+            }
+        }
+    }
+}
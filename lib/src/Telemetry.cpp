@@ -0,0 +1,120 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Telemetry.h"
+#include "OneWire.h"
+#include "Varint.h"
+
+using namespace Telemetry;
+
+TelemetryEncoder::TelemetryEncoder(uint8_t numChannels) :
+    numChannels(numChannels > maxChannels ? maxChannels : numChannels),
+    sequence(0),
+    framesUntilKeyFrame(0)
+{
+    for(uint8_t i = 0; i < maxChannels; i++){
+        previous[i] = 0;
+    }
+}
+
+uint8_t TelemetryEncoder::encode(const int16_t * values, uint8_t * frame)
+{
+    bool keyFrame = framesUntilKeyFrame == 0;
+    framesUntilKeyFrame = keyFrame ? keyFrameInterval - 1 : framesUntilKeyFrame - 1;
+
+    uint8_t * payload = frame + 2;
+    uint8_t * p = payload + headerLength;
+    uint16_t mask = 0;
+    for(uint8_t i = 0; i < numChannels; i++){
+        int32_t base = keyFrame ? 0 : previous[i];
+        if(keyFrame || values[i] != previous[i]){
+            mask |= uint16_t(1) << i;
+            p = writeVarint(p, zigzag(int32_t(values[i]) - base));
+            previous[i] = values[i];
+        }
+    }
+    payload[0] = frameType;
+    payload[1] = keyFrame ? flagKeyFrame : 0;
+    payload[2] = sequence++;
+    payload[3] = uint8_t(mask);
+    payload[4] = uint8_t(mask >> 8);
+
+    uint8_t length = p - payload;
+    frame[0] = frameStart;
+    frame[1] = length;
+    *p++ = OneWire::crc8(frame + 1, length + 1);
+    return p - frame;
+}
+
+TelemetryDecoder::TelemetryDecoder(uint8_t numChannels) :
+    numChannels(numChannels > maxChannels ? maxChannels : numChannels),
+    sequence(0),
+    changedMask(0),
+    synchronized(false)
+{
+    for(uint8_t i = 0; i < maxChannels; i++){
+        values[i] = 0;
+    }
+}
+
+bool TelemetryDecoder::decode(const uint8_t * frame, uint8_t length)
+{
+    if(length < headerLength + 3 || frame[0] != frameStart || frame[1] != length - 3){
+        return false;
+    }
+    if(OneWire::crc8(frame + 1, length - 2) != frame[length - 1]){
+        return false;
+    }
+    const uint8_t * payload = frame + 2;
+    const uint8_t * end = frame + length - 1;
+    if(payload[0] != frameType){
+        return false;
+    }
+    bool keyFrame = payload[1] & flagKeyFrame;
+    uint8_t seq = payload[2];
+    if(!keyFrame && (!synchronized || seq != uint8_t(sequence + 1))){
+        synchronized = false; // a frame was lost, wait for the next key frame
+        return false;
+    }
+    uint16_t mask = payload[3] | (uint16_t(payload[4]) << 8);
+
+    int16_t decoded[maxChannels];
+    const uint8_t * p = payload + headerLength;
+    for(uint8_t i = 0; i < numChannels; i++){
+        decoded[i] = keyFrame ? 0 : values[i];
+        if(mask & (uint16_t(1) << i)){
+            uint32_t v;
+            p = readVarint(p, end, v);
+            if(p == nullptr){
+                return false;
+            }
+            decoded[i] = int16_t(decoded[i] + unzigzag(v));
+        }
+    }
+    if(p != end){
+        return false;
+    }
+    for(uint8_t i = 0; i < numChannels; i++){
+        values[i] = decoded[i];
+    }
+    sequence = seq;
+    changedMask = mask;
+    synchronized = true;
+    return true;
+}
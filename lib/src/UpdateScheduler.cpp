@@ -0,0 +1,82 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "UpdateScheduler.h"
+
+UpdateScheduler::UpdateScheduler() : nextDeadline(0)
+{
+}
+
+void UpdateScheduler::add(UpdateFn fn, void * object, ticks_millis_t period)
+{
+    ticks_millis_t now = ticks.millis();
+    Task task = {fn, object, period, NULL, now};
+    tasks.push_back(task);
+    nextDeadline = now;
+}
+
+void UpdateScheduler::addWithPeriodFn(UpdateFn fn, void * object, PeriodFn periodFn)
+{
+    ticks_millis_t now = ticks.millis();
+    Task task = {fn, object, 0, periodFn, now};
+    tasks.push_back(task);
+    nextDeadline = now;
+}
+
+void UpdateScheduler::clear()
+{
+    tasks.clear();
+}
+
+ticks_millis_t UpdateScheduler::timeUntilNext() const
+{
+    ticks_millis_t now = ticks.millis();
+    if(tasks.empty()){
+        return UINT32_MAX; // nothing will ever be due
+    }
+    return isDue(now, nextDeadline) ? 0 : nextDeadline - now;
+}
+
+ticks_millis_t UpdateScheduler::run()
+{
+    ticks_millis_t now = ticks.millis();
+    if(tasks.empty()){
+        return UINT32_MAX;
+    }
+    if(!isDue(now, nextDeadline)){
+        return nextDeadline - now;
+    }
+
+    ticks_millis_t earliest = now + UINT32_MAX / 2;
+    for (auto & task : tasks){
+        if(isDue(now, task.deadline)){
+            task.fn(task.object);
+            ticks_millis_t period = task.getPeriod();
+            task.deadline += period;
+            if(isDue(now, task.deadline)){
+                task.deadline = now + period; // fell behind, do not try to catch up
+            }
+        }
+        if(int32_t(task.deadline - earliest) < 0){
+            earliest = task.deadline;
+        }
+    }
+    nextDeadline = earliest;
+    return isDue(now, nextDeadline) ? 0 : nextDeadline - now;
+}
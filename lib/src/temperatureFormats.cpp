@@ -19,341 +19,62 @@
 
 #include "temperatureFormats.h"
 
-// Converting constructors, which shift and constrain the value.
-
-temp_t::temp_t(temp_precise_t const & rhs) {
-    unsigned char const shift = temp_precise_t::fractional_bit_count
-            - temp_t::fractional_bit_count;
-    this->value_ = rhs.value_ >> shift; // could result in a 1 bit error due to rounding
-}
-
-temp_t::temp_t(temp_long_t const & rhs) {
-    // temp and temp_long have same number of fraction bits, no shifting needed
-    static_assert(temp_t::fractional_bit_count == temp_long_t::fractional_bit_count,
-            "temp and temp_long should have same number of fraction bits");
-
-    if (rhs.value_ < min_val) {
-        this->value_ = min_val;
-    } else if (rhs.value_ > max_val) {
-        this->value_ = max_val;
-    } else {
-        this->value_ = rhs.value_;
+// all pairs of decimal digits, so two digits can be converted at once
+static char const digitPairs[] =
+        "0001020304050607080910111213141516171819"
+        "2021222324252627282930313233343536373839"
+        "4041424344454647484950515253545556575859"
+        "6061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+// powers of 5 that fit in 32 bits, used to multiply by 10^numDecimals / 2^numDecimals
+static uint32_t const powersOfFive[] = {
+        1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125, 9765625, 48828125, 244140625, 1220703125
+};
+
+// powers of 10 up to the maximum number of digits that is parsed without strtol
+static uint32_t const powersOfTen[] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+static uint8_t const maxFastDigits = 9; // 10^9 fits in 32 bits
+
+// writes two digits of a number below 100, least significant first
+static inline char * writeDigitPair(char * digits, uint32_t value){
+    *digits++ = digitPairs[2 * value + 1];
+    *digits++ = digitPairs[2 * value];
+    return digits;
+}
+
+/* Writes the decimal digits of value to digits, least significant first, and returns the number of digits.
+ * Nothing is written for zero. The divisions are by constants, which the compiler replaces with multiplications.
+ */
+static uint8_t decimalDigits(uint64_t value, char * digits){
+    char * p = digits;
+    while (value > UINT32_MAX) {
+        // split off 8 digits, so the rest can be done with 32 bit arithmetic
+        uint64_t high = value / 100000000;
+        uint32_t low = value - high * 100000000;
+        for (uint8_t i = 0; i < 4; i++) {
+            uint32_t quotient = low / 100;
+            p = writeDigitPair(p, low - quotient * 100);
+            low = quotient;
+        }
+        value = high;
     }
-}
-
-temp_precise_t::temp_precise_t(temp_t const & rhs) {
-    // temp and temp_precise have same number of integer bits, so this will not overflow
-    static_assert(temp_t::integer_bit_count == temp_precise_t::integer_bit_count,
-            "temp and temp_long should have same number of integer bits");
-
-    unsigned char shift = temp_precise_t::fractional_bit_count
-            - temp_t::fractional_bit_count;
-    this->value_ = temp_precise_t::base_type(rhs.value_) << shift;
-}
-
-temp_precise_t::temp_precise_t(temp_long_t const & rhs) {
-    unsigned char const shift = temp_precise_t::fractional_bit_count
-            - temp_long_t::fractional_bit_count;
-
-    // convert to temp first to make sure it fits
-    temp_t t = rhs;
-    this->value_ = temp_precise_t::base_type(t.value_) << shift;
-}
-
-temp_long_t::temp_long_t(temp_t const & rhs) {
-    this->value_ = rhs.value_;
-}
-
-temp_long_t::temp_long_t(temp_precise_t const & rhs) {
-    unsigned char const shift = temp_precise_t::fractional_bit_count
-            - temp_long_t::fractional_bit_count;
-    this->value_ = rhs.value_ >> shift; //// could result in a 1 bit error due to rounding
-}
-
-// With operators for mixed types always returns the bigger type
-// which is automatically converted afterwards if assigned to a small type
-
-// Addition
-
-// this looks recursive, but it prevents ambiguity
-temp_t temp_t::operator+(temp_t const & rhs) {
-    temp_t result(*this);
-    result += rhs;
-    return result;
-}
-
-temp_precise_t temp_t::operator+(temp_precise_t const & rhs) {
-    temp_precise_t result(*this);
-    result += rhs;
-    return result;
-}
-
-temp_long_t temp_t::operator+(temp_long_t const & rhs) {
-    temp_long_t result(*this);
-    result += rhs;
-    return result;
-}
-
-temp_long_t temp_long_t::operator+(temp_long_t const & rhs) {
-    temp_long_t result(*this);
-    result += rhs;
-    return result;
-}
-
-temp_long_t temp_long_t::operator+(temp_precise_t const & rhs) {
-    temp_long_t result(*this);
-    result += temp_long_t(rhs);
-    return result;
-}
-
-temp_long_t temp_long_t::operator+(temp_t const & rhs) {
-    temp_long_t result(*this);
-    result += temp_long_t(rhs);
-    return result;
-}
-
-temp_precise_t temp_precise_t::operator+(temp_precise_t const & rhs) {
-    temp_precise_t result(*this);
-    result += rhs;
-    return result;
-}
-
-temp_precise_t temp_precise_t::operator+(temp_t const & rhs) {
-    temp_precise_t result(*this);
-    result += temp_precise_t(rhs);
-    return result;
-}
-
-temp_long_t temp_precise_t::operator+(temp_long_t const & rhs) {
-    temp_long_t result(*this);
-    result += temp_long_t(rhs);
-    return result;
-}
-
-// Unary Minus (change sign)
-temp_t temp_t::operator-() const{
-    temp_t result(*this);
-    result.value_ = -result.value_;
-    return result;
-}
-
-temp_long_t temp_long_t ::operator-() const{
-    temp_long_t result(*this);
-    result.value_ = -result.value_;
-    return result;
-}
-
-temp_precise_t temp_precise_t::operator-() const{
-    temp_precise_t result(*this);
-    result.value_ = -result.value_;
-    return result;
-}
-
-
-// Subtraction
-
-// this looks recursive, but it prevents ambiguity
-temp_t temp_t::operator-(temp_t const & rhs) {
-    temp_t result(*this);
-    result -= rhs;
-    return result;
-}
-
-temp_precise_t temp_t::operator-(temp_precise_t const & rhs) {
-    temp_precise_t result(*this);
-    result -= rhs;
-    return result;
-}
-
-temp_long_t temp_t::operator-(temp_long_t const & rhs) {
-    temp_long_t result(*this);
-    result -= rhs;
-    return result;
-}
-
-temp_long_t temp_long_t::operator-(temp_long_t const & rhs) {
-    temp_long_t result(*this);
-    result -= rhs;
-    return result;
-}
-
-temp_long_t temp_long_t::operator-(temp_precise_t const & rhs) {
-    temp_long_t result(*this);
-    result -= temp_long_t(rhs);
-    return result;
-}
-
-temp_long_t temp_long_t::operator-(temp_t const & rhs) {
-    temp_long_t result(*this);
-    result -= temp_long_t(rhs);
-    return result;
-}
-
-temp_precise_t temp_precise_t::operator-(temp_precise_t const & rhs) {
-    temp_precise_t result(*this);
-    result -= rhs;
-    return result;
-}
-
-temp_precise_t temp_precise_t::operator-(temp_t const & rhs) {
-    temp_precise_t result(*this);
-    result -= temp_precise_t(rhs);
-    return result;
-}
-
-temp_long_t temp_precise_t::operator-(temp_long_t const & rhs) {
-    temp_long_t result(*this);
-    result -= temp_long_t(rhs);
-    return result;
-}
-
-// Multiplication
-
-temp_t temp_t::operator*(temp_t const & rhs) {
-    temp_t result(*this);
-    result *= rhs;
-    return result;
-}
-
-temp_precise_t temp_t::operator*(temp_precise_t const & rhs) {
-    temp_precise_t result(*this);
-    result *= rhs;
-    return result;
-}
-
-temp_long_t temp_t::operator*(temp_long_t const & rhs) {
-    temp_long_t result(*this);
-    result *= rhs;
-    return result;
-}
-
-temp_long_t temp_long_t::operator*(temp_long_t const & rhs) {
-    temp_long_t result(*this);
-    result *= rhs;
-    return result;
-}
-
-temp_long_t temp_long_t::operator*(temp_precise_t const & rhs) {
-    temp_long_t result(*this);
-    result *= temp_long_t(rhs);
-    return result;
-}
-
-temp_long_t temp_long_t::operator*(temp_t const & rhs) {
-    temp_long_t result(*this);
-    result *= temp_long_t(rhs);
-    return result;
-}
-
-temp_precise_t temp_precise_t::operator*(temp_precise_t const & rhs) {
-    temp_precise_t result(*this);
-    result *= rhs;
-    return result;
-}
-
-temp_precise_t temp_precise_t::operator*(temp_t const & rhs) {
-    temp_precise_t result(*this);
-    result *= temp_precise_t(rhs);
-    return result;
-}
-
-temp_long_t temp_precise_t::operator*(temp_long_t const & rhs) {
-    temp_long_t result(*this);
-    result *= temp_long_t(rhs);
-    return result;
-}
-
-// multiplication with uint16_t returns long temperature. Will be constrained later if assigned to temp_t
-temp_long_t temp_t::operator*(uint16_t const rhs) {
-    temp_long_t result(*this);
-    result.value_ *= rhs;
-    return result;
-}
-
-temp_long_t temp_precise_t::operator*(uint16_t const rhs) {
-    temp_long_t resultUpper(*this); // lower precision bits will be discarded
-    temp_precise_t resultLower(*this);
-    uint8_t const duplicatedBits = temp_precise_t::fractional_bit_count - temp_long_t::fractional_bit_count;
-
-    resultLower.value_ = resultLower.value_ & ((0x1 << duplicatedBits) - 1); // discard upper bits from lower, which are already in upper
-    resultUpper.value_ *= rhs;
-    resultLower.value_ *= rhs;
-
-    return resultUpper + resultLower;
-}
-
-// Division
-
-temp_t temp_t::operator/(temp_t const & rhs) {
-    temp_t result(*this);
-    result /= rhs;
-    return result;
-}
-
-temp_precise_t temp_t::operator/(temp_precise_t const & rhs) {
-    temp_precise_t result(*this);
-    result /= rhs;
-    return result;
-}
-
-temp_long_t temp_t::operator/(temp_long_t const & rhs) {
-    temp_long_t result(*this);
-    result /= rhs;
-    return result;
-}
-
-temp_long_t temp_long_t::operator/(temp_long_t const & rhs) {
-    temp_long_t result(*this);
-    result /= rhs;
-    return result;
-}
-
-temp_long_t temp_long_t::operator/(temp_precise_t const & rhs) {
-    temp_long_t result(*this);
-    result /= temp_long_t(rhs);
-    return result;
-}
-
-temp_long_t temp_long_t::operator/(temp_t const & rhs) {
-    temp_long_t result(*this);
-    result /= temp_long_t(rhs);
-    return result;
-}
-
-temp_precise_t temp_precise_t::operator/(temp_precise_t const & rhs) {
-    temp_precise_t result(*this);
-    result /= rhs;
-    return result;
-}
-
-temp_precise_t temp_precise_t::operator/(temp_t const & rhs) {
-    temp_precise_t result(*this);
-    result /= temp_precise_t(rhs);
-    return result;
-}
-
-temp_long_t temp_precise_t::operator/(temp_long_t const & rhs) {
-    temp_long_t result(*this);
-    result /= temp_long_t(rhs);
-    return result;
-}
-
-temp_t temp_t::operator/(uint16_t const rhs) {
-    temp_t result(*this);
-    result.value_ = (result.value_ + (rhs >> 1) ) / rhs; // rounded divide
-    return result;
-}
-
-temp_precise_t temp_precise_t::operator/(uint16_t const rhs) {
-    temp_precise_t result(*this);
-    result.value_ = (result.value_ + (rhs >> 1) ) / rhs; // rounded divide
-    return result;
-}
-
-temp_long_t temp_long_t::operator/(uint16_t const rhs) {
-    temp_long_t result(*this);
-    result.value_ = (result.value_ + (rhs >> 1) ) / rhs; // rounded divide
-    return result;
+    uint32_t remaining = value;
+    while (remaining >= 100) {
+        uint32_t quotient = remaining / 100;
+        p = writeDigitPair(p, remaining - quotient * 100);
+        remaining = quotient;
+    }
+    if (remaining >= 10) {
+        p = writeDigitPair(p, remaining);
+    }
+    else if (remaining > 0) {
+        *p++ = '0' + remaining;
+    }
+    return p - digits;
 }
 
 // converts fixed point value to string, without using double/float
@@ -367,7 +88,6 @@ char * toStringImpl(const int32_t raw, // raw value of fixed point
         bool absolute) // is this an absolute temperature? need to subtract 32 for F
         {
 
-    char const digit[] = "0123456789";
     char* p;
     bool negative = false;
 
@@ -387,31 +107,33 @@ char * toStringImpl(const int32_t raw, // raw value of fixed point
         negative = true;
     }
     // code below looks a bit cryptic, but what it does is * 10^numDecimals / 2^F
-    for (uint8_t i = 0; i < numDecimals; i++) {
-        shifter = shifter * 5; // *5 instead of 10, combined with reduced shift below. Less chance of overflow
+    // *5 instead of 10, combined with reduced shift below. Less chance of overflow
+    uint8_t i = (numDecimals < 13) ? numDecimals : 13;
+    shifter = shifter * powersOfFive[i];
+    for (; i < numDecimals; i++) {
+        shifter = shifter * 5;
     }
     shifter = (shifter + (1 << (F - numDecimals - 1))) >> (F - numDecimals); // divide rounded by fixed point scale
 
+    char digits[20]; // enough for all 64 bit values
+    uint8_t numDigits = decimalDigits(shifter, digits);
+    uint8_t nextDigit = 0;
+
     p = &buf[len - 1]; // start at the end of buffer
     *p = '\0';
-    lldiv_t dv { };
-    dv.quot = shifter;
     do { //Move back, inserting digits as u go
         if (p == &buf[len - 1 - numDecimals]) {
             *--p = '.'; // insert decimal point at right moment
+        } else if (nextDigit < numDigits) { // check if end of digits
+            *--p = digits[nextDigit++];
+        } else if ((p - buf) > (len - numDecimals - 3)) { // still need to print some leading zeros
+            *--p = '0';
+        } else if (negative) {
+            // print minus sign if needed as last digit to print
+            *--p = '-';
+            break;
         } else {
-            dv = lldiv(dv.quot, 10);
-            if ((dv.quot || dv.rem)) { // check if end of digits
-                *--p = digit[std::abs(dv.rem)];
-            } else if ((p - buf) > (len - numDecimals - 3)) { // still need to print some leading zeros
-                *--p = '0';
-            } else if (negative) {
-                // print minus sign if needed as last digit to print
-                *--p = '-';
-                break;
-            } else {
-                break;
-            }
+            break;
         }
     } while (p > buf);
     char * pWithoutSpaces = p;
@@ -423,16 +145,8 @@ char * toStringImpl(const int32_t raw, // raw value of fixed point
     return pWithoutSpaces;
 }
 
-// Converts string into fixed point and returns bool on success.
-bool fromStringImpl(int32_t * raw, // result is put in this variable upon success
-        unsigned char F, // number of fraction bits
-        char const * const s, // the string to convert
-        char format,
-        bool absolute,
-        int32_t minimum, // minimum value for result
-        int32_t maximum) // maximum value for result
-        {
-    // receive new value as null terminated string: "19.20"
+// parses a string with strtol, which accepts all the variations that the fast parser below does not handle
+static bool parseFixedPointStrtol(int64_t * result, unsigned char F, char const * const s){
     int64_t newValue;
 
     // larger type to prevent overflow
@@ -465,7 +179,74 @@ bool fromStringImpl(int32_t * raw, // result is put in this variable upon succes
             decimalValue = (decimalValue + 5) / 10;
         }
     }
-    newValue = positive ? newValue + decimalValue : newValue - decimalValue;
+    *result = positive ? newValue + decimalValue : newValue - decimalValue;
+    return true;
+}
+
+// reads up to maxFastDigits digits and returns the number of digits read
+static inline uint8_t parseDigits(char const ** s, uint32_t * value){
+    char const * p = *s;
+    uint32_t v = 0;
+    while (*p >= '0' && *p <= '9' && p - *s < maxFastDigits) {
+        v = v * 10 + (*p - '0');
+        p++;
+    }
+    uint8_t count = p - *s;
+    *s = p;
+    *value = v;
+    return count;
+}
+
+/* Parses the strings that toStringImpl writes, which covers almost all input: spaces, an optional minus sign,
+ * digits and optional decimals. For all other strings the strtol parser is used, so the result is always the same.
+ */
+static bool parseFixedPoint(int64_t * result, unsigned char F, char const * const s){
+    char const * p = s;
+    while (*p == ' ') {
+        p++;
+    }
+    bool negative = (*p == '-');
+    if (negative) {
+        p++;
+    }
+    uint32_t integerPart;
+    uint32_t decimals = 0;
+    uint8_t numDecimals = 0;
+    bool valid = parseDigits(&p, &integerPart) > 0;
+    if (valid && *p == '.') {
+        p++;
+        numDecimals = parseDigits(&p, &decimals);
+        valid = numDecimals > 0;
+    }
+    if (!valid || *p != '\0') {
+        return parseFixedPointStrtol(result, F, s);
+    }
+
+    // The strtol parser rounds after each decimal with (x + 5) / 10. Doing this n times is the same as adding
+    // 5 * 111..1 (n ones) and dividing by 10^n once. The decimals are scaled to 9 digits to divide by a constant.
+    uint32_t scale = powersOfTen[maxFastDigits - numDecimals];
+    uint64_t rounder = uint64_t(powersOfTen[numDecimals] - 1) / 9 * 5 * scale;
+    uint64_t decimalValue = ((uint64_t(decimals) * scale << F) + rounder) / 1000000000;
+
+    int64_t magnitude = (int64_t(integerPart) << F) + decimalValue;
+    *result = negative ? -magnitude : magnitude;
+    return true;
+}
+
+// Converts string into fixed point and returns bool on success.
+bool fromStringImpl(int32_t * raw, // result is put in this variable upon success
+        unsigned char F, // number of fraction bits
+        char const * const s, // the string to convert
+        char format,
+        bool absolute,
+        int32_t minimum, // minimum value for result
+        int32_t maximum) // maximum value for result
+        {
+    // receive new value as null terminated string: "19.20"
+    int64_t newValue;
+    if (!parseFixedPoint(&newValue, F, s)) {
+        return false;
+    }
     if(format == 'F'){
         if(absolute){
             newValue -= 32 << F;
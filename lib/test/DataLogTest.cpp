@@ -0,0 +1,227 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "DataLog.h"
+#include <cstring>
+#include <vector>
+
+// flash in RAM, writes can only clear bits like real NOR flash
+class MockDataLogStorage : public DataLogStorage {
+public:
+    MockDataLogStorage(uint32_t pageSize, uint32_t pageCount) :
+        size(pageSize), count(pageCount), data(pageSize * pageCount, 0xFF), erases(pageCount, 0), writesLeft(-1){}
+
+    uint32_t pageSize() const override final { return size; }
+    uint32_t pageCount() const override final { return count; }
+
+    bool erasePage(uint32_t address) override final {
+        std::memset(&data[address], 0xFF, size);
+        erases[address / size]++;
+        return true;
+    }
+    bool writePage(const void * source, uint32_t address, uint32_t length) override final {
+        if(writesLeft == 0){
+            return false;
+        }
+        if(writesLeft > 0){
+            writesLeft--;
+        }
+        for(uint32_t i = 0; i < length; i++){
+            data[address + i] &= static_cast<const uint8_t*>(source)[i];
+        }
+        return true;
+    }
+    bool readPage(void * target, uint32_t address, uint32_t length) const override final {
+        std::memcpy(target, &data[address], length);
+        return true;
+    }
+
+    uint32_t size;
+    uint32_t count;
+    std::vector<uint8_t> data;
+    std::vector<uint32_t> erases;
+    int32_t writesLeft; // number of writes before writing fails, to simulate a reset. Negative for no limit.
+};
+
+// values of a sample at a certain time: slowly changing temperatures and an actuator that toggles
+static void makeValues(uint32_t time, int16_t * values, uint8_t numValues){
+    for(uint8_t i = 0; i < numValues; i++){
+        values[i] = 20 * 256 + int16_t((time * (i + 1)) % 512) - 256;
+    }
+    values[numValues - 1] = (time / 60) % 2 ? 100 * 256 : 0;
+}
+
+static void appendSamples(DataLogger & logger, uint32_t first, uint32_t last, uint8_t numValues){
+    int16_t values[DataLog::maxValues];
+    for(uint32_t t = first; t <= last; t++){
+        makeValues(t, values, numValues);
+        BOOST_REQUIRE(logger.append(t, values, numValues));
+    }
+}
+
+// reads the log from time from and checks that it contains all samples from first to last
+static void checkSamples(DataLogStorage & storage, uint32_t from, uint32_t first, uint32_t last, uint8_t numValues){
+    DataLogReader reader(storage);
+    reader.seek(from);
+    DataLogSample sample;
+    int16_t expected[DataLog::maxValues];
+    uint32_t t = first;
+    while(reader.next(sample)){
+        BOOST_TEST_CONTEXT("time " << t){
+            BOOST_REQUIRE_EQUAL(sample.time, t);
+            BOOST_REQUIRE_EQUAL(sample.numValues, numValues);
+            makeValues(t, expected, numValues);
+            for(uint8_t i = 0; i < numValues; i++){
+                BOOST_REQUIRE_EQUAL(sample.values[i], expected[i]);
+            }
+        }
+        t++;
+    }
+    BOOST_CHECK_EQUAL(t, last + 1);
+}
+
+BOOST_AUTO_TEST_SUITE(DataLogTest)
+
+BOOST_AUTO_TEST_CASE(empty_log_has_no_samples){
+    MockDataLogStorage storage(256, 8);
+    DataLogger logger(storage);
+    BOOST_CHECK(!logger.begin());
+    BOOST_CHECK_EQUAL(logger.lastTime(), 0);
+
+    DataLogReader reader(storage);
+    reader.seek(0);
+    DataLogSample sample;
+    BOOST_CHECK(!reader.next(sample));
+}
+
+BOOST_AUTO_TEST_CASE(samples_are_read_back_in_order){
+    MockDataLogStorage storage(4096, 16);
+    DataLogger logger(storage);
+    logger.begin();
+    appendSamples(logger, 1000, 3000, 11);
+    BOOST_CHECK_EQUAL(logger.lastTime(), 3000);
+    checkSamples(storage, 0, 1000, 3000, 11);
+}
+
+BOOST_AUTO_TEST_CASE(deltas_are_compact){
+    MockDataLogStorage storage(4096, 16);
+    DataLogger logger(storage);
+    logger.begin();
+    appendSamples(logger, 0, 999, 11);
+
+    uint32_t pagesUsed = 0;
+    for(uint32_t erases : storage.erases){
+        pagesUsed += erases;
+    }
+    // a sample with 11 slowly changing values takes about 15 bytes, the same data as JSON is over 100 bytes
+    BOOST_CHECK_LE(pagesUsed, 5);
+}
+
+BOOST_AUTO_TEST_CASE(log_is_continued_after_reset){
+    MockDataLogStorage storage(256, 32);
+    {
+        DataLogger logger(storage);
+        logger.begin();
+        appendSamples(logger, 0, 100, 6);
+    }
+    DataLogger logger(storage);
+    BOOST_CHECK(logger.begin());
+    BOOST_CHECK_EQUAL(logger.lastTime(), 100);
+    appendSamples(logger, 101, 200, 6);
+    checkSamples(storage, 0, 0, 200, 6);
+}
+
+BOOST_AUTO_TEST_CASE(oldest_pages_are_reused_with_even_wear){
+    MockDataLogStorage storage(256, 8);
+    DataLogger logger(storage);
+    logger.begin();
+    appendSamples(logger, 0, 20000, 6);
+
+    uint32_t minErases = UINT32_MAX;
+    uint32_t maxErases = 0;
+    for(uint32_t erases : storage.erases){
+        minErases = std::min(minErases, erases);
+        maxErases = std::max(maxErases, erases);
+    }
+    BOOST_CHECK_GT(minErases, 10);
+    BOOST_CHECK_LE(maxErases - minErases, 1);
+
+    // the log contains the newest samples without gaps
+    DataLogReader reader(storage);
+    reader.seek(0);
+    DataLogSample sample;
+    BOOST_REQUIRE(reader.next(sample));
+    uint32_t oldest = sample.time;
+    BOOST_CHECK_GT(oldest, 19000);
+    checkSamples(storage, 0, oldest, 20000, 6);
+}
+
+BOOST_AUTO_TEST_CASE(seek_starts_at_requested_time){
+    MockDataLogStorage storage(256, 64);
+    DataLogger logger(storage);
+    logger.begin();
+    appendSamples(logger, 0, 2000, 6);
+
+    checkSamples(storage, 1234, 1234, 2000, 6);
+    checkSamples(storage, 2000, 2000, 2000, 6);
+
+    DataLogReader reader(storage);
+    reader.seek(2001);
+    DataLogSample sample;
+    BOOST_CHECK(!reader.next(sample));
+}
+
+BOOST_AUTO_TEST_CASE(record_interrupted_by_reset_is_ignored){
+    MockDataLogStorage storage(256, 16);
+    {
+        DataLogger logger(storage);
+        logger.begin();
+        appendSamples(logger, 0, 50, 6);
+        storage.writesLeft = 1; // the payload is written, but not the type byte
+        int16_t values[6] = {1, 2, 3, 4, 5, 6};
+        BOOST_CHECK(!logger.append(51, values, 6));
+        storage.writesLeft = -1;
+    }
+    checkSamples(storage, 0, 0, 50, 6);
+
+    DataLogger logger(storage);
+    BOOST_CHECK(logger.begin());
+    BOOST_CHECK_EQUAL(logger.lastTime(), 50);
+    appendSamples(logger, 51, 100, 6);
+    checkSamples(storage, 0, 0, 100, 6);
+}
+
+BOOST_AUTO_TEST_CASE(number_of_values_can_change){
+    MockDataLogStorage storage(256, 16);
+    DataLogger logger(storage);
+    logger.begin();
+    appendSamples(logger, 0, 10, 4);
+    appendSamples(logger, 11, 20, 7);
+    checkSamples(storage, 11, 11, 20, 7);
+
+    DataLogReader reader(storage);
+    reader.seek(0);
+    DataLogSample sample;
+    BOOST_REQUIRE(reader.next(sample));
+    BOOST_CHECK_EQUAL(sample.numValues, 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "EepromWriteCache.h"
+#include <cstring>
+#include <vector>
+
+// EEPROM in RAM that records every write
+class MockEepromAccess {
+public:
+    MockEepromAccess(uint16_t size) : data(size, 0){}
+
+    void readBlock(void * target, eptr_t offset, uint16_t size){
+        std::memcpy(target, &data[offset], size);
+    }
+    void writeBlock(eptr_t offset, const void * source, uint16_t size){
+        std::memcpy(&data[offset], source, size);
+        writes.push_back(Write{offset, size});
+    }
+
+    struct Write {
+        eptr_t offset;
+        uint16_t size;
+    };
+    std::vector<uint8_t> data;
+    std::vector<Write> writes;
+};
+
+struct TestSettings {
+    uint8_t mode;
+    int16_t beerSetting;
+    int16_t fridgeSetting;
+    uint8_t padding[11];
+};
+
+struct TestConstants {
+    int32_t values[8];
+};
+
+struct EepromWriteCacheFixture {
+    EepromWriteCacheFixture() : eeprom(256), cache(eeprom, 5000), settings(), constants(){
+        BOOST_REQUIRE(cache.add(settingsOffset, &settings, settingsShadow, sizeof(settings)));
+        BOOST_REQUIRE(cache.add(constantsOffset, &constants, constantsShadow, sizeof(constants)));
+        cache.sync();
+    }
+
+    void checkStored(){
+        BOOST_CHECK(std::memcmp(&eeprom.data[settingsOffset], &settings, sizeof(settings)) == 0);
+        BOOST_CHECK(std::memcmp(&eeprom.data[constantsOffset], &constants, sizeof(constants)) == 0);
+    }
+
+    static const eptr_t settingsOffset = 10;
+    static const eptr_t constantsOffset = 100;
+    MockEepromAccess eeprom;
+    EepromWriteCache<MockEepromAccess, 2> cache;
+    TestSettings settings;
+    TestConstants constants;
+    uint8_t settingsShadow[sizeof(TestSettings)];
+    uint8_t constantsShadow[sizeof(TestConstants)];
+};
+
+BOOST_FIXTURE_TEST_SUITE(EepromWriteCacheTest, EepromWriteCacheFixture)
+
+BOOST_AUTO_TEST_CASE(store_is_written_after_window){
+    settings.mode = 'b';
+    BOOST_CHECK(cache.store(&settings, 1000));
+    BOOST_CHECK(cache.pending());
+
+    cache.update(5999);
+    BOOST_CHECK(eeprom.writes.empty());
+
+    cache.update(6000);
+    BOOST_CHECK(!cache.pending());
+    BOOST_REQUIRE_EQUAL(eeprom.writes.size(), 1u);
+    checkStored();
+}
+
+BOOST_AUTO_TEST_CASE(only_changed_bytes_are_written){
+    settings.fridgeSetting = 0x1234;
+    constants.values[5] = 0x00ABCDEF; // 3 changed bytes
+    cache.store(&settings, 0);
+    cache.store(&constants, 0);
+    cache.flush();
+
+    BOOST_REQUIRE_EQUAL(eeprom.writes.size(), 2u);
+    BOOST_CHECK_EQUAL(eeprom.writes[0].offset, settingsOffset + offsetof(TestSettings, fridgeSetting));
+    BOOST_CHECK_EQUAL(eeprom.writes[0].size, 2u);
+    BOOST_CHECK_EQUAL(eeprom.writes[1].offset, constantsOffset + 5 * sizeof(int32_t));
+    BOOST_CHECK_EQUAL(eeprom.writes[1].size, 3u);
+    BOOST_CHECK_EQUAL(cache.getStats().bytes, 5u);
+    checkStored();
+}
+
+BOOST_AUTO_TEST_CASE(changes_in_window_are_coalesced){
+    // a host sending all settings one by one
+    for(int16_t i = 1; i <= 20; i++){
+        constants.values[i % 8] = i;
+        cache.store(&constants, 100 * i);
+        cache.update(100 * i);
+    }
+    BOOST_CHECK(eeprom.writes.empty());
+    cache.update(100 + 5000);
+
+    const EepromWriteStats & stats = cache.getStats();
+    BOOST_CHECK_EQUAL(stats.stores, 20u);
+    BOOST_CHECK_EQUAL(stats.flushes, 1u);
+    BOOST_CHECK_EQUAL(stats.writes, 8u); // one for each value, the runs are separated by zero bytes
+    checkStored();
+}
+
+BOOST_AUTO_TEST_CASE(window_starts_at_first_change){
+    // changes that keep coming do not postpone writing forever
+    for(ticks_millis_t t = 0; t <= 20000; t += 1000){
+        settings.beerSetting = t;
+        cache.store(&settings, t);
+        cache.update(t);
+    }
+    BOOST_CHECK_EQUAL(cache.getStats().flushes, 3u); // at 5, 11 and 17 seconds
+}
+
+BOOST_AUTO_TEST_CASE(unchanged_or_reverted_values_are_not_written){
+    cache.store(&settings, 0);
+    cache.update(5000);
+    BOOST_CHECK(eeprom.writes.empty());
+
+    settings.mode = 'f';
+    cache.store(&settings, 6000);
+    settings.mode = 0;
+    cache.store(&settings, 7000);
+    cache.update(11000);
+    BOOST_CHECK(eeprom.writes.empty());
+    BOOST_CHECK_EQUAL(cache.getStats().flushes, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(sync_reads_eeprom_written_without_cache){
+    // the EEPROM is initialized with other values, like when it is zapped
+    std::memset(&eeprom.data[0], 0xFF, eeprom.data.size());
+    cache.sync();
+    std::memset(&settings, 0xFF, sizeof(settings));
+    settings.mode = 'o';
+    cache.store(&settings, 0);
+    cache.flush();
+
+    BOOST_REQUIRE_EQUAL(eeprom.writes.size(), 1u);
+    BOOST_CHECK_EQUAL(eeprom.writes[0].size, 1u);
+    BOOST_CHECK(std::memcmp(&eeprom.data[settingsOffset], &settings, sizeof(settings)) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(unknown_objects_and_blocks_are_rejected){
+    int other = 0;
+    BOOST_CHECK(!cache.store(&other, 0));
+    BOOST_CHECK(!cache.pending());
+    BOOST_CHECK(!cache.add(200, &other, nullptr, sizeof(other))); // all blocks in use
+}
+
+BOOST_AUTO_TEST_SUITE_END()
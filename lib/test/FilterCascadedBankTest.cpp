@@ -0,0 +1,129 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "FilterCascaded.h"
+#include "FilterCascadedBank.h"
+#include "temperatureFormats.h"
+#include <cstdlib>
+#include <vector>
+
+// checks that every channel in the bank has the same state as the scalar filter for that channel
+static void checkSameAsScalar(FilterCascadedBank const & bank, std::vector<FilterCascaded> & scalar, uint32_t sample){
+    for(uint16_t n = 0; n < bank.size(); n++){
+        BOOST_TEST_CONTEXT("channel " << n << ", sample " << sample){
+            BOOST_REQUIRE_EQUAL(bank.readOutput(n), scalar[n].readOutput());
+            BOOST_REQUIRE_EQUAL(bank.readPrevOutput(n), scalar[n].readPrevOutput());
+            BOOST_REQUIRE_EQUAL(bank.readInput(n), scalar[n].readInput());
+        }
+    }
+}
+
+// random temperature with steps and spikes
+static temp_precise_t randomInput(){
+    temp_precise_t t;
+    int r = rand() % 100;
+    if(r < 2){
+        t = temp_precise_t::max(); // saturates the filters
+    }
+    else if(r < 4){
+        t = temp_precise_t::min();
+    }
+    else{
+        t.setRaw((rand() % (80 << 16)) << 7); // -40 to 40 degrees in the top 24 bits
+        t -= temp_precise_t(40.0);
+    }
+    return t;
+}
+
+BOOST_AUTO_TEST_SUITE(FilterCascadedBankTest)
+
+BOOST_AUTO_TEST_CASE(bank_output_is_same_as_scalar_filter){
+    srand(1);
+    const uint16_t channels = 21; // not a multiple of the number of lanes
+    FilterCascadedBank bank(channels);
+    std::vector<FilterCascaded> scalar(channels);
+
+    for(uint16_t n = 0; n < channels; n++){
+        uint8_t b = (n < 8) ? 3 : n % 7; // first blocks have the same b value for all channels, others are mixed
+        bank.setFiltering(n, b);
+        scalar[n].setFiltering(b);
+        BOOST_CHECK_EQUAL(bank.getFiltering(n), b);
+        temp_precise_t initial = 20.0 + n;
+        bank.init(n, initial);
+        scalar[n].init(initial);
+    }
+    checkSameAsScalar(bank, scalar, 0);
+
+    std::vector<temp_precise_t> input(channels);
+    for(uint32_t s = 1; s < 5000; s++){
+        for(uint16_t n = 0; n < channels; n++){
+            input[n] = randomInput();
+            scalar[n].add(input[n]);
+        }
+        bank.add(input.data());
+        checkSameAsScalar(bank, scalar, s);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(masked_channels_keep_their_state){
+    srand(2);
+    const uint16_t channels = 12;
+    FilterCascadedBank bank(channels);
+    std::vector<FilterCascaded> scalar(channels);
+    std::vector<temp_precise_t> input(channels);
+    std::vector<uint8_t> mask(channels);
+
+    for(uint32_t s = 0; s < 1000; s++){
+        for(uint16_t n = 0; n < channels; n++){
+            input[n] = randomInput();
+            mask[n] = rand() % 3 != 0;
+            if(mask[n]){
+                scalar[n].add(input[n]);
+            }
+        }
+        bank.add(input.data(), mask.data());
+        checkSameAsScalar(bank, scalar, s);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(block_of_samples_gives_same_output_as_scalar_filter){
+    srand(3);
+    const uint16_t channels = 9;
+    const uint32_t samples = 500;
+    FilterCascadedBank bank(channels);
+    std::vector<FilterCascaded> scalar(channels);
+    std::vector<temp_precise_t> data(channels * samples);
+    std::vector<temp_precise_t> expected(channels * samples);
+
+    for(uint32_t s = 0; s < samples; s++){
+        for(uint16_t n = 0; n < channels; n++){
+            data[s * channels + n] = randomInput();
+            expected[s * channels + n] = scalar[n].add(data[s * channels + n]);
+        }
+    }
+
+    bank.addBlock(data.data(), data.data(), samples); // filter in place
+    for(uint32_t i = 0; i < data.size(); i++){
+        BOOST_REQUIRE_EQUAL(data[i], expected[i]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "JsonTokenizer.h"
+#include <string>
+#include <vector>
+
+struct JsonTokenizerTest {
+    // feeds the input in chunks of the given size and collects the pairs, returns the flags of the last character
+    uint8_t parse(const std::string & input, size_t chunk = 1){
+        pairs.clear();
+        tokenizer.reset();
+        uint8_t result = JsonTokenizer::NONE;
+        for(size_t start = 0; start < input.size(); start += chunk){
+            // a chunk is what is available on the serial port at one time, the tokenizer returns after each character
+            for(size_t i = start; i < start + chunk && i < input.size(); i++){
+                result = tokenizer.feed(input[i]);
+                if(result & JsonTokenizer::PAIR){
+                    pairs.push_back(std::string(tokenizer.key()) + "=" + tokenizer.value());
+                }
+                if(result & (JsonTokenizer::END | JsonTokenizer::ERROR)){
+                    return result;
+                }
+            }
+        }
+        return result;
+    }
+
+    JsonTokenizer tokenizer;
+    std::vector<std::string> pairs;
+};
+
+BOOST_FIXTURE_TEST_SUITE(JsonTokenizerTestSuite, JsonTokenizerTest)
+
+BOOST_AUTO_TEST_CASE(pairs_are_parsed_from_object){
+    BOOST_CHECK_EQUAL(parse("{\"mode\":\"b\", \"beerSet\": 20.5 ,tempFormat:C}"), JsonTokenizer::PAIR | JsonTokenizer::END);
+    BOOST_REQUIRE_EQUAL(pairs.size(), 3u);
+    BOOST_CHECK_EQUAL(pairs[0], "mode=b");
+    BOOST_CHECK_EQUAL(pairs[1], "beerSet=20.5");
+    BOOST_CHECK_EQUAL(pairs[2], "tempFormat=C");
+}
+
+BOOST_AUTO_TEST_CASE(result_does_not_depend_on_how_input_is_split){
+    std::string input = "{\"i\":0,\"c\":1,\"b\":0,\"f\":0,\"h\":2,\"p\":0,\"a\":\"28C80E9A0300009B\",\"j\":\"-0.5\"}";
+    parse(input);
+    std::vector<std::string> expected = pairs;
+    BOOST_REQUIRE_EQUAL(expected.size(), 8u);
+    for(size_t chunk = 2; chunk < input.size(); chunk++){
+        BOOST_CHECK_EQUAL(parse(input, chunk), JsonTokenizer::PAIR | JsonTokenizer::END);
+        BOOST_CHECK(pairs == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(quoted_strings_keep_separators_and_spaces){
+    parse("{\"name\":\"Beer 1: {test}, ok\"}");
+    BOOST_REQUIRE_EQUAL(pairs.size(), 1u);
+    BOOST_CHECK_EQUAL(pairs[0], "name=Beer 1: {test}, ok");
+}
+
+BOOST_AUTO_TEST_CASE(empty_keys_and_values_are_skipped){
+    BOOST_CHECK_EQUAL(parse("{}"), JsonTokenizer::END);
+    BOOST_CHECK(pairs.empty());
+    BOOST_CHECK_EQUAL(parse("{\"a\":\"\",\"\":1,b,\"c\":2,}"), JsonTokenizer::END);
+    BOOST_REQUIRE_EQUAL(pairs.size(), 1u);
+    BOOST_CHECK_EQUAL(pairs[0], "c=2");
+}
+
+BOOST_AUTO_TEST_CASE(missing_open_brace_is_an_error){
+    BOOST_CHECK_EQUAL(parse("  x"), JsonTokenizer::ERROR);
+    BOOST_CHECK_EQUAL(tokenizer.error(), 'x');
+    BOOST_CHECK_EQUAL(tokenizer.feed('{'), JsonTokenizer::ERROR); // needs a reset to start a new object
+}
+
+BOOST_AUTO_TEST_CASE(tokens_up_to_max_length_are_accepted){
+    std::string longValue(JsonTokenizer::maxTokenLength, 'v');
+    parse("{\"k\":\"" + longValue + "\"}");
+    BOOST_REQUIRE_EQUAL(pairs.size(), 1u);
+    BOOST_CHECK_EQUAL(pairs[0], "k=" + longValue);
+
+    BOOST_CHECK_EQUAL(parse("{\"k\":\"" + longValue + "w\"}"), JsonTokenizer::ERROR);
+    BOOST_CHECK(pairs.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
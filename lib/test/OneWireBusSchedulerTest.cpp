@@ -0,0 +1,170 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "OneWireBusScheduler.h"
+#include "OneWireTempSensor.h"
+#include "OneWire.h"
+#include "Ticks.h"
+#include "runner.h"
+#include <memory>
+#include <vector>
+
+// The test platform uses OneWireNull, so no sensors respond. These tests check the timing of the state machine.
+struct OneWireBusSchedulerTest {
+    OneWireBusSchedulerTest() : bus(0) {
+        ticks.reset();
+    }
+
+    void addSensors(OneWireBusScheduler & scheduler, uint8_t count){
+        for(uint8_t i = 0; i < count; i++){
+            DeviceAddress address = {0x28, i, 0, 0, 0, 0, 0, 0};
+            sensors.emplace_back(new OneWireTempSensor(&bus, address, temp_t(0.0), &scheduler));
+        }
+    }
+
+    OneWire bus;
+    std::vector<std::unique_ptr<OneWireTempSensor>> sensors;
+};
+
+BOOST_FIXTURE_TEST_SUITE(OneWireBusSchedulerTestSuite, OneWireBusSchedulerTest)
+
+BOOST_AUTO_TEST_CASE(scheduler_without_sensors_stays_idle){
+    OneWireBusScheduler scheduler(&bus);
+    for(uint32_t t = 0; t < 3000; t += 10){
+        ticks.setMillis(t);
+        scheduler.update();
+        BOOST_REQUIRE_EQUAL(scheduler.getState(), OneWireBusScheduler::IDLE);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(one_conversion_for_all_sensors_then_one_sensor_per_update){
+    OneWireBusScheduler scheduler(&bus);
+    addSensors(scheduler, 5);
+
+    for(uint32_t period = 0; period < 3; period++){
+        ticks.setMillis(period * 1000);
+        scheduler.update(); // broadcast convert command
+        BOOST_REQUIRE_EQUAL(scheduler.getState(), OneWireBusScheduler::CONVERTING);
+
+        ticks.setMillis(period * 1000 + OneWireBusScheduler::conversionTime - 1);
+        scheduler.update();
+        BOOST_REQUIRE_EQUAL(scheduler.getState(), OneWireBusScheduler::CONVERTING);
+
+        ticks.setMillis(period * 1000 + OneWireBusScheduler::conversionTime);
+        scheduler.update();
+        BOOST_REQUIRE_EQUAL(scheduler.getState(), OneWireBusScheduler::READING);
+
+        // each update reads a single sensor, or re-initializes the sensor that could not be read in the previous
+        // update. No sensors respond, so every sensor is read and then re-initialized.
+        for(uint8_t i = 0; i < 2 * sensors.size() - 1; i++){
+            scheduler.update();
+            BOOST_REQUIRE_EQUAL(scheduler.getState(), OneWireBusScheduler::READING);
+        }
+        scheduler.update();
+        BOOST_REQUIRE_EQUAL(scheduler.getState(), OneWireBusScheduler::IDLE);
+
+        // no new conversion until the period has passed
+        ticks.setMillis(period * 1000 + 999);
+        scheduler.update();
+        BOOST_REQUIRE_EQUAL(scheduler.getState(), OneWireBusScheduler::IDLE);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(time_until_next_follows_the_state_machine){
+    OneWireBusScheduler scheduler(&bus);
+    BOOST_CHECK_EQUAL(scheduler.timeUntilNext(), UINT32_MAX); // no sensors, nothing to do
+
+    addSensors(scheduler, 1);
+    BOOST_CHECK_EQUAL(scheduler.timeUntilNext(), 0u); // first conversion is due immediately
+
+    scheduler.update();
+    BOOST_REQUIRE_EQUAL(scheduler.getState(), OneWireBusScheduler::CONVERTING);
+    ticks.setMillis(100);
+    BOOST_CHECK_EQUAL(scheduler.timeUntilNext(), OneWireBusScheduler::conversionTime - 100);
+
+    ticks.setMillis(OneWireBusScheduler::conversionTime);
+    scheduler.update();
+    BOOST_REQUIRE_EQUAL(scheduler.getState(), OneWireBusScheduler::READING);
+    BOOST_CHECK_EQUAL(scheduler.timeUntilNext(), 0u);
+
+    scheduler.update(); // read fails
+    scheduler.update(); // re-initialize
+    BOOST_REQUIRE_EQUAL(scheduler.getState(), OneWireBusScheduler::IDLE);
+    BOOST_CHECK_EQUAL(scheduler.timeUntilNext(), 1000 - OneWireBusScheduler::conversionTime);
+}
+
+BOOST_AUTO_TEST_CASE(sensors_not_responding_are_disconnected_after_scheduled_read){
+    OneWireBusScheduler scheduler(&bus);
+    addSensors(scheduler, 2);
+
+    for(uint32_t t = 0; t < 2000; t += 10){
+        ticks.setMillis(t);
+        scheduler.update();
+        for(auto & s : sensors){
+            s->update(); // does not access the bus, the scheduler reads the sensors
+        }
+    }
+    for(auto & s : sensors){
+        BOOST_CHECK(!s->isConnected());
+        BOOST_CHECK(s->read().isDisabledOrInvalid());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(deleted_sensor_is_removed_from_scheduler){
+    OneWireBusScheduler scheduler(&bus);
+    addSensors(scheduler, 3);
+
+    ticks.setMillis(0);
+    scheduler.update();
+    ticks.setMillis(OneWireBusScheduler::conversionTime);
+    scheduler.update();
+    scheduler.update(); // read first sensor, which fails
+    BOOST_REQUIRE_EQUAL(scheduler.getState(), OneWireBusScheduler::READING);
+
+    sensors.erase(sensors.begin()); // delete the sensor that was just read, before it is re-initialized
+    scheduler.update(); // reads the second sensor
+    BOOST_CHECK_EQUAL(scheduler.getState(), OneWireBusScheduler::READING);
+    scheduler.update(); // re-initializes the second sensor
+    BOOST_CHECK_EQUAL(scheduler.getState(), OneWireBusScheduler::READING);
+    scheduler.update(); // reads the last sensor
+    BOOST_CHECK_EQUAL(scheduler.getState(), OneWireBusScheduler::READING);
+    scheduler.update(); // re-initializes the last sensor
+    BOOST_CHECK_EQUAL(scheduler.getState(), OneWireBusScheduler::IDLE);
+
+    sensors.clear();
+    ticks.setMillis(1000);
+    scheduler.update();
+    BOOST_CHECK_EQUAL(scheduler.getState(), OneWireBusScheduler::IDLE); // no sensors, no conversion
+}
+
+BOOST_AUTO_TEST_CASE(for_bus_returns_the_same_scheduler_for_a_bus){
+    static OneWire busA(1);
+    static OneWire busB(2);
+    OneWireBusScheduler * a = OneWireBusScheduler::forBus(&busA);
+    OneWireBusScheduler * b = OneWireBusScheduler::forBus(&busB);
+    BOOST_CHECK(a != nullptr);
+    BOOST_CHECK(a != b);
+    BOOST_CHECK_EQUAL(a, OneWireBusScheduler::forBus(&busA));
+    BOOST_CHECK_EQUAL(a->getBus(), &busA);
+    BOOST_CHECK(OneWireBusScheduler::forBus(nullptr) == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "OneWireProfiler.h"
+#include "OneWire.h"
+#include "DallasTemperature.h"
+#include "runner.h"
+
+struct OneWireProfilerTest {
+    OneWireProfilerTest(){
+        OneWireProfiler::clear(); // statistics are global, other tests also use the bus
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(OneWireProfilerTestSuite, OneWireProfilerTest)
+
+BOOST_AUTO_TEST_CASE(histogram_buckets_are_powers_of_two){
+    BOOST_CHECK_EQUAL(OneWireProfiler::bucket(0), 0);
+    BOOST_CHECK_EQUAL(OneWireProfiler::bucket(63), 0);
+    BOOST_CHECK_EQUAL(OneWireProfiler::bucket(64), 1);
+    BOOST_CHECK_EQUAL(OneWireProfiler::bucket(127), 1);
+    BOOST_CHECK_EQUAL(OneWireProfiler::bucket(128), 2);
+    BOOST_CHECK_EQUAL(OneWireProfiler::bucket(65535), 10);
+    BOOST_CHECK_EQUAL(OneWireProfiler::bucket(65536), 11);
+    BOOST_CHECK_EQUAL(OneWireProfiler::bucket(UINT32_MAX), OneWireProfiler::numBuckets - 1);
+}
+
+BOOST_AUTO_TEST_CASE(operations_are_counted_per_type){
+    OneWireProfiler::record(OneWireProfiler::RESET, 500);
+    OneWireProfiler::record(OneWireProfiler::RESET, 1000);
+    OneWireProfiler::record(OneWireProfiler::READ_SCRATCHPAD, 12000);
+
+    const OneWireProfiler::OperationStats & reset = OneWireProfiler::getOperation(OneWireProfiler::RESET);
+    BOOST_CHECK_EQUAL(reset.count, 2u);
+    BOOST_CHECK_EQUAL(reset.maxMicros, 1000u);
+    BOOST_CHECK_EQUAL(reset.buckets[OneWireProfiler::bucket(500)], 1u);
+    BOOST_CHECK_EQUAL(reset.buckets[OneWireProfiler::bucket(1000)], 1u);
+
+    const OneWireProfiler::OperationStats & read = OneWireProfiler::getOperation(OneWireProfiler::READ_SCRATCHPAD);
+    BOOST_CHECK_EQUAL(read.count, 1u);
+    BOOST_CHECK_EQUAL(read.maxMicros, 12000u);
+    BOOST_CHECK_EQUAL(OneWireProfiler::getOperation(OneWireProfiler::SEARCH).count, 0u);
+
+    OneWireProfiler::clear();
+    BOOST_CHECK_EQUAL(OneWireProfiler::getOperation(OneWireProfiler::RESET).count, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(errors_are_counted_per_device){
+    DeviceAddress a = {0x28, 1, 2, 3, 4, 5, 6, 7};
+    DeviceAddress b = {0x3A, 1, 2, 3, 4, 5, 6, 7};
+    OneWireProfiler::countTransaction(a);
+    OneWireProfiler::countTransaction(a);
+    OneWireProfiler::countCrcError(a);
+    OneWireProfiler::countRetry(b);
+
+    BOOST_REQUIRE_EQUAL(OneWireProfiler::getDeviceCount(), 2);
+    const OneWireProfiler::DeviceStats & da = OneWireProfiler::getDevice(0);
+    BOOST_CHECK_EQUAL(memcmp(da.address, a, sizeof(DeviceAddress)), 0);
+    BOOST_CHECK_EQUAL(da.transactions, 2u);
+    BOOST_CHECK_EQUAL(da.crcErrors, 1u);
+    BOOST_CHECK_EQUAL(da.retries, 0u);
+    const OneWireProfiler::DeviceStats & db = OneWireProfiler::getDevice(1);
+    BOOST_CHECK_EQUAL(db.transactions, 0u);
+    BOOST_CHECK_EQUAL(db.retries, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(devices_that_do_not_fit_in_the_table_are_ignored){
+    DeviceAddress address = {0x28, 0, 0, 0, 0, 0, 0, 0};
+    for(uint8_t i = 0; i < OneWireProfiler::maxDevices + 4; i++){
+        address[1] = i;
+        OneWireProfiler::countCrcError(address);
+    }
+    BOOST_CHECK_EQUAL(OneWireProfiler::getDeviceCount(), OneWireProfiler::maxDevices);
+}
+
+BOOST_AUTO_TEST_CASE(bus_transactions_are_profiled){
+    OneWire bus(0);
+    DallasTemperature dallas(&bus);
+    DeviceAddress address = {0x28, 1, 2, 3, 4, 5, 6, 7};
+    uint8_t scratchPad[9];
+
+    BOOST_CHECK(dallas.readScratchPadCRC(address, scratchPad)); // OneWireNull reads all zeros, which has a valid CRC
+
+    BOOST_CHECK_EQUAL(OneWireProfiler::getOperation(OneWireProfiler::READ_SCRATCHPAD).count, 1u);
+    BOOST_CHECK_EQUAL(OneWireProfiler::getOperation(OneWireProfiler::RESET).count, 2u); // before and after the read
+    BOOST_REQUIRE_EQUAL(OneWireProfiler::getDeviceCount(), 1);
+    BOOST_CHECK_EQUAL(OneWireProfiler::getDevice(0).transactions, 1u);
+    BOOST_CHECK_EQUAL(OneWireProfiler::getDevice(0).crcErrors, 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+#include "OneWireSimPlant.h"
+#include "OneWire.h"
+#include "DallasTemperature.h"
+#include "Ticks.h"
+#include "runner.h"
+#include <string.h>
+#include <vector>
+
+struct OneWireSimTest {
+    OneWireSimTest() : bus(OneWireSimBus::forAddress(0)), plant(bus), wire(0) {
+        ticks.reset();
+    }
+
+    // finds the addresses of all devices with the search algorithm used by OneWire::search
+    std::vector<std::vector<uint8_t>> search(){
+        std::vector<std::vector<uint8_t>> found;
+        uint8_t rom[8] = {0};
+        uint8_t lastDiscrepancy = 0;
+        do {
+            if(!wire.reset()){
+                break;
+            }
+            wire.write(0xF0);
+            uint8_t lastZero = 0;
+            for(uint8_t bit = 1; bit <= 64; bit++){
+                uint8_t & byte = rom[(bit - 1) / 8];
+                uint8_t mask = 1 << ((bit - 1) % 8);
+                uint8_t direction = bit < lastDiscrepancy ? (byte & mask) != 0 : bit == lastDiscrepancy;
+                uint8_t idBit, cmpIdBit;
+                wire.search_triplet(&direction, &idBit, &cmpIdBit);
+                if(idBit && cmpIdBit){
+                    return found;
+                }
+                if(!idBit && !cmpIdBit && direction == 0){
+                    lastZero = bit;
+                }
+                byte = direction ? (byte | mask) : (byte & ~mask);
+            }
+            found.emplace_back(rom, rom + 8);
+            lastDiscrepancy = lastZero;
+        } while (lastDiscrepancy);
+        return found;
+    }
+
+    void select(const uint8_t * address){
+        BOOST_REQUIRE(wire.reset());
+        wire.write(0x55);
+        for(uint8_t i = 0; i < 8; i++){
+            wire.write(address[i]);
+        }
+    }
+
+    void readScratchpad(const uint8_t * address, uint8_t * scratchpad){
+        select(address);
+        wire.write(READSCRATCH);
+        for(uint8_t i = 0; i < 9; i++){
+            scratchpad[i] = wire.read();
+        }
+    }
+
+    void convert(){
+        BOOST_REQUIRE(wire.reset());
+        wire.write(0xCC); // skip ROM, all sensors convert
+        wire.write(STARTCONVO);
+    }
+
+    OneWireSimBus & bus;
+    OneWireSimPlant plant;
+    OneWireSim wire;
+};
+
+BOOST_FIXTURE_TEST_SUITE(OneWireSimTestSuite, OneWireSimTest)
+
+BOOST_AUTO_TEST_CASE(empty_bus_has_no_presence_pulse){
+    BOOST_CHECK(!wire.reset());
+    BOOST_CHECK(search().empty());
+}
+
+BOOST_AUTO_TEST_CASE(search_finds_all_devices){
+    plant.addDefaultDevices();
+    plant.addDevice("ds2408 - - heater");
+    BOOST_REQUIRE(wire.reset());
+
+    auto found = search();
+    BOOST_REQUIRE_EQUAL(found.size(), plant.getDevices().size());
+    for(auto & d : plant.getDevices()){
+        bool match = false;
+        for(auto & address : found){
+            match |= memcmp(d->getAddress(), address.data(), 8) == 0;
+        }
+        BOOST_CHECK(match);
+        BOOST_CHECK_EQUAL(OneWire::crc8(d->getAddress(), 7), d->getAddress()[7]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(temperature_sensor_reads_model_after_conversion){
+    BOOST_REQUIRE(plant.addDevice("ds18b20 beer"));
+    const uint8_t * address = plant.getDevices()[0]->getAddress();
+    plant.getModel().beerTemp = 21.5;
+
+    uint8_t scratchpad[9];
+    readScratchpad(address, scratchpad);
+    BOOST_CHECK_EQUAL(OneWire::crc8(scratchpad, 8), scratchpad[SCRATCHPAD_CRC]);
+    BOOST_CHECK_EQUAL(int16_t(scratchpad[TEMP_MSB] << 8 | scratchpad[TEMP_LSB]), 85 * 16); // power on value
+
+    convert();
+    readScratchpad(address, scratchpad);
+    BOOST_CHECK_EQUAL(OneWire::crc8(scratchpad, 8), scratchpad[SCRATCHPAD_CRC]);
+    BOOST_CHECK_EQUAL(int16_t(scratchpad[TEMP_MSB] << 8 | scratchpad[TEMP_LSB]), 344); // 21.5 * 16
+}
+
+BOOST_AUTO_TEST_CASE(switch_latches_drive_model_heater){
+    plant.addDefaultDevices();
+    auto & sw = static_cast<OneWireSwitchSim &>(*plant.getDevices()[3]);
+    BOOST_CHECK(!sw.latchActive(0));
+    BOOST_CHECK(!sw.latchActive(1));
+
+    // turn on PIOB, the heater
+    select(sw.getAddress());
+    wire.write(0x5A);
+    wire.write(0x01);
+    wire.write(0xFE);
+    BOOST_CHECK_EQUAL(wire.read(), 0xAA);
+    BOOST_CHECK(!sw.latchActive(0));
+    BOOST_CHECK(sw.latchActive(1));
+
+    // access read: PIOB latch and pin are low, complement in the upper nibble
+    select(sw.getAddress());
+    wire.write(0xF5);
+    uint8_t status = wire.read();
+    BOOST_CHECK_EQUAL(status & 0x0F, 0x3);
+    BOOST_CHECK_EQUAL(status >> 4, uint8_t(~status) & 0x0F);
+
+    // a write that does not match its complement is rejected
+    select(sw.getAddress());
+    wire.write(0x5A);
+    wire.write(0x00);
+    wire.write(0x00);
+    BOOST_CHECK_EQUAL(wire.read(), 0xFF);
+    BOOST_CHECK(!sw.latchActive(0));
+
+    double start = plant.getModel().beerTemp;
+    ticks.setMillis(3600 * 1000);
+    convert(); // the reset updates the model
+    BOOST_CHECK_GT(plant.getModel().beerTemp, start + 0.1);
+    BOOST_CHECK_EQUAL(static_cast<DS18B20Sim &>(*plant.getDevices()[0]).getTemperature(), plant.getModel().beerTemp);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_device_lines_are_rejected){
+    BOOST_CHECK(!plant.addDevice(""));
+    BOOST_CHECK(!plant.addDevice("ds1234"));
+    BOOST_CHECK(!plant.addDevice("ds18b20 heater"));
+    BOOST_CHECK(!plant.addDevice("ds2413 heater cooler heater"));
+    BOOST_CHECK(!plant.addDevice("ds2413 boiler"));
+    BOOST_CHECK(plant.getDevices().empty());
+    BOOST_CHECK(!wire.reset());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
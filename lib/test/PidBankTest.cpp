@@ -0,0 +1,205 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+// yes this is hacky, but it allows us to some private variables without adding a lot of getters
+#define protected public
+#include "Pid.h"
+#undef protected
+
+#include "PidBank.h"
+#include "SetPoint.h"
+#include "TempSensorExternal.h"
+#include "ActuatorMocks.h"
+#include "ActuatorPwm.h"
+#include "Ticks.h"
+#include "SimulationEngine.h"
+#include "runner.h"
+#include <math.h>
+#include <memory>
+#include <vector>
+
+/* Runs the same loops as separate Pid objects and in a PidBank.
+ * Each loop has its own inputs and outputs for both, which are driven with the same values.
+ */
+struct PidBankTest {
+    struct Loop {
+        Loop(bool pwm) : sensor(true), bankSensor(true), setPoint(20.0), bankSetPoint(20.0),
+                pin(), bankPin(),
+                actuator(pwm ? static_cast<ActuatorRange*>(new ActuatorPwm(&pin, 4))
+                             : static_cast<ActuatorRange*>(new ActuatorValue(0.0, -10.0, 10.0))),
+                bankActuator(pwm ? static_cast<ActuatorRange*>(new ActuatorPwm(&bankPin, 4))
+                                 : static_cast<ActuatorRange*>(new ActuatorValue(0.0, -10.0, 10.0))),
+                pid(&sensor, actuator.get(), &setPoint){
+            sensor.setValue(20.0);
+            bankSensor.setValue(20.0);
+        }
+
+        void setTemp(temp_t t){
+            sensor.setValue(t);
+            bankSensor.setValue(t);
+        }
+        void setConnected(bool connected){
+            sensor.setConnected(connected);
+            bankSensor.setConnected(connected);
+        }
+        void writeSetPoint(temp_t t){
+            setPoint.write(t);
+            bankSetPoint.write(t);
+        }
+        void update(){
+            ActuatorPwm * pwm = dynamic_cast<ActuatorPwm*>(actuator.get());
+            if(pwm){
+                pwm->update();
+                dynamic_cast<ActuatorPwm*>(bankActuator.get())->update();
+            }
+        }
+
+        TempSensorExternal sensor;
+        TempSensorExternal bankSensor;
+        SetPointSimple setPoint;
+        SetPointSimple bankSetPoint;
+        ActuatorBool pin;
+        ActuatorBool bankPin;
+        std::unique_ptr<ActuatorRange> actuator;
+        std::unique_ptr<ActuatorRange> bankActuator;
+        Pid pid;
+    };
+
+    PidBankTest(){
+        ticks.reset();
+    }
+
+    Loop & addLoop(bool pwm, temp_long_t kp, uint16_t ti, uint16_t td, uint8_t inputFilter, uint8_t derivativeFilter, bool negative){
+        loops.emplace_back(new Loop(pwm));
+        Loop & loop = *loops.back();
+        PidBank::index_t n = bank.add(&loop.bankSensor, loop.bankActuator.get(), &loop.bankSetPoint);
+        BOOST_REQUIRE_EQUAL(n, loops.size() - 1);
+
+        loop.pid.setConstants(kp, ti, td);
+        loop.pid.setInputFilter(inputFilter);
+        loop.pid.setDerivativeFilter(derivativeFilter);
+        loop.pid.setActuatorIsNegative(negative);
+        bank.setConstants(n, kp, ti, td);
+        bank.setInputFilter(n, inputFilter);
+        bank.setDerivativeFilter(n, derivativeFilter);
+        bank.setActuatorIsNegative(n, negative);
+        return loop;
+    }
+
+    void update(){
+        for(auto & loop : loops){
+            loop->pid.update();
+        }
+        bank.update();
+        for(auto & loop : loops){
+            loop->update();
+        }
+    }
+
+    void checkEqual(uint32_t t){
+        for(PidBank::index_t n = 0; n < loops.size(); n++){
+            Pid & pid = loops[n]->pid;
+            BOOST_TEST_CONTEXT("loop " << n << " at t=" << t){
+                BOOST_REQUIRE_EQUAL(pid.inputError, bank.getInputError(n));
+                BOOST_REQUIRE_EQUAL(pid.p, bank.getP(n));
+                BOOST_REQUIRE_EQUAL(pid.i, bank.getI(n));
+                BOOST_REQUIRE_EQUAL(pid.d, bank.getD(n));
+                BOOST_REQUIRE_EQUAL(pid.integral, bank.getIntegral(n));
+                BOOST_REQUIRE_EQUAL(pid.derivative, bank.getDerivative(n));
+                BOOST_REQUIRE_EQUAL(loops[n]->actuator->getValue(), loops[n]->bankActuator->getValue());
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Loop>> loops;
+    PidBank bank;
+};
+
+BOOST_FIXTURE_TEST_SUITE(PidBankTestSuite, PidBankTest)
+
+BOOST_AUTO_TEST_CASE(new_bank_loop_has_same_defaults_as_pid){
+    addLoop(false, 10.0, 0, 0, 0, 2, false);
+    update();
+    checkEqual(0);
+}
+
+BOOST_AUTO_TEST_CASE(bank_is_bit_identical_to_pid_objects){
+    // a mix of PWM and range actuators, heaters and coolers, filter settings and gains
+    addLoop(true, 10.0, 0, 0, 0, 2, false);
+    addLoop(true, 20.0, 600, 60, 1, 3, false);
+    addLoop(true, 40.0, 1800, 300, 2, 4, true);
+    addLoop(false, 5.0, 1200, 120, 0, 2, false);
+    addLoop(false, 2.0, 600, 600, 3, 5, true);
+    addLoop(false, 100.0, 300, 1200, 1, 6, false); // saturates the actuator
+    addLoop(true, 0.5, 7200, 0, 6, 2, true);
+    addLoop(false, 30.0, 0, 900, 4, 1, false);
+
+    SimulationEngine engine(ticks);
+    engine.run(4000, [&](uint32_t t){
+        for(uint16_t n = 0; n < loops.size(); n++){
+            Loop & loop = *loops[n];
+            // different input signal for each loop, quantized like a DS18B20
+            double temp = 20.0 + 2.0 * sin((t + 97 * n) / (200.0 + 30 * n)) + 0.002 * n * (t % 700);
+            loop.setTemp(temp_t(floor(temp * 16.0) / 16.0));
+
+            if(t == 100){
+                loop.writeSetPoint(21.0 - n * 0.5);
+            }
+            if(n % 2 == 0){
+                loop.setConnected(!(t >= 1000 && t < 1008)); // short disconnect, filters keep their state
+            }
+            else{
+                loop.setConnected(!(t >= 2000 && t < 2100)); // long disconnect, pid disabled and filters re-initialized
+            }
+            if(n % 3 == 0 && t >= 3000 && t < 3020){
+                loop.writeSetPoint(temp_t::disabled());
+            }
+            if(n % 3 == 0 && t == 3020){
+                loop.writeSetPoint(19.0);
+            }
+        }
+        update();
+        checkEqual(t);
+    });
+}
+
+BOOST_AUTO_TEST_CASE(disabled_loop_is_bit_identical_to_disabled_pid){
+    Loop & a = addLoop(false, 2.0, 600, 60, 1, 2, false);
+    Loop & b = addLoop(false, 2.0, 600, 60, 1, 2, true);
+    a.writeSetPoint(22.0);
+    b.writeSetPoint(18.0);
+
+    for(uint32_t t = 0; t < 600; t++){
+        if(t == 200){
+            a.pid.disable(true);
+            bank.disable(0, true);
+        }
+        if(t == 400){
+            a.pid.enable();
+            bank.enable(0);
+        }
+        update();
+        checkEqual(t);
+    }
+    BOOST_CHECK(a.pid.integral != temp_long_t(0.0)); // make sure the integrator was exercised
+}
+
+BOOST_AUTO_TEST_SUITE_END()
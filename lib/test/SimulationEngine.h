@@ -0,0 +1,154 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Ticks.h"
+#include <stdint.h>
+#include <vector>
+
+/* A set point profile is a list of (time, temperature) points.
+ * Between two points the set point is linearly interpolated, like a beer profile in the web interface.
+ * Before the first point, the first temperature is used. After the last point, the last temperature is held.
+ */
+class SetPointProfile {
+public:
+    SetPointProfile() = default;
+    ~SetPointProfile() = default;
+
+    // add a point to the profile. Points should be added in chronological order
+    void add(ticks_seconds_t time, double temp){
+        points.push_back({time, temp});
+    }
+
+    // shorthand for a point that is a number of days after the previous point
+    void addDays(double days, double temp){
+        ticks_seconds_t previous = points.empty() ? 0 : points.back().time;
+        add(previous + ticks_seconds_t(days * 86400), temp);
+    }
+
+    double read(ticks_seconds_t time) const {
+        if(points.empty()){
+            return 0.0;
+        }
+        if(time <= points.front().time){
+            return points.front().temp;
+        }
+        // keep track of the current segment, profiles are normally read with increasing time
+        if(segment >= points.size() || time < points[segment].time){
+            segment = 0;
+        }
+        while(segment + 1 < points.size() && time >= points[segment + 1].time){
+            segment++;
+        }
+        if(segment + 1 == points.size()){
+            return points.back().temp;
+        }
+        Point const & from = points[segment];
+        Point const & to = points[segment + 1];
+        double fraction = double(time - from.time) / double(to.time - from.time);
+        return from.temp + (to.temp - from.temp) * fraction;
+    }
+
+    ticks_seconds_t duration() const {
+        return points.empty() ? 0 : points.back().time;
+    }
+
+private:
+    struct Point {
+        ticks_seconds_t time;
+        double temp;
+    };
+    std::vector<Point> points;
+    mutable size_t segment = 0;
+};
+
+/* SimulationEngine runs a closed loop simulation (control objects + a thermal model) in virtual time.
+ * Instead of waiting for real time to pass, it advances an ExternalTicks clock directly, so the speed of
+ * the simulation is only limited by the amount of work done each step.
+ *
+ * Each step, the engine calls the step function with the number of the step (seconds since the start
+ * of the run for the default step of 1000 ms) and then advances the clock by one step.
+ * Optionally, a fast step function is called a number of times in between, with the clock advanced in
+ * equal parts. This mimics the main loop of the firmware, where actuators are updated as often as possible
+ * and the rest of the system once per second.
+ */
+class SimulationEngine {
+public:
+    SimulationEngine(ExternalTicks & clock_,
+                     ticks_millis_t stepMillis_ = 1000,
+                     uint16_t fastStepsPerStep_ = 0) :
+        clock(clock_),
+        stepMillis(stepMillis_),
+        fastStepsPerStep(fastStepsPerStep_),
+        stepCount(0)
+    {
+    }
+    ~SimulationEngine() = default;
+
+    // run the simulation for a number of steps
+    template<typename Step>
+    void run(uint32_t steps, Step && step){
+        for(uint32_t t = 0; t < steps; t++){
+            step(t);
+            clock.incMillis(stepMillis);
+            stepCount++;
+        }
+    }
+
+    // run the simulation for a number of steps, with fast updates in between the normal steps
+    template<typename Step, typename FastStep>
+    void run(uint32_t steps, Step && step, FastStep && fastStep){
+        if(fastStepsPerStep == 0){
+            run(steps, step);
+            return;
+        }
+        ticks_millis_t fastStepMillis = stepMillis / (fastStepsPerStep + 1);
+        ticks_millis_t remainder = stepMillis - fastStepMillis * fastStepsPerStep;
+        for(uint32_t t = 0; t < steps; t++){
+            step(t);
+            for(uint16_t i = 0; i < fastStepsPerStep; i++){
+                clock.incMillis(fastStepMillis);
+                fastStep();
+            }
+            clock.incMillis(remainder);
+            stepCount++;
+        }
+    }
+
+    // total number of steps run by this engine
+    uint32_t steps() const {
+        return stepCount;
+    }
+
+    // simulated time that has passed in all runs, in seconds
+    ticks_seconds_t elapsedSeconds() const {
+        return ticks_seconds_t((uint64_t(stepCount) * stepMillis) / 1000);
+    }
+
+    ticks_millis_t getStepMillis() const {
+        return stepMillis;
+    }
+
+private:
+    ExternalTicks & clock;
+    ticks_millis_t stepMillis;
+    uint16_t fastStepsPerStep;
+    uint32_t stepCount;
+};
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "runner.h"
+#include "Ticks.h"
+#include "SimulationEngine.h"
+
+BOOST_AUTO_TEST_SUITE(SimulationEngineTest)
+
+BOOST_AUTO_TEST_CASE(profile_interpolates_between_points){
+    SetPointProfile profile;
+    profile.add(100, 20.0);
+    profile.add(200, 30.0);
+    profile.add(400, 10.0);
+
+    BOOST_CHECK_EQUAL(profile.read(0), 20.0); // before first point
+    BOOST_CHECK_EQUAL(profile.read(100), 20.0);
+    BOOST_CHECK_CLOSE(profile.read(150), 25.0, 0.001);
+    BOOST_CHECK_EQUAL(profile.read(200), 30.0);
+    BOOST_CHECK_CLOSE(profile.read(300), 20.0, 0.001);
+    BOOST_CHECK_EQUAL(profile.read(500), 10.0); // after last point
+    BOOST_CHECK_CLOSE(profile.read(150), 25.0, 0.001); // reading back in time works too
+    BOOST_CHECK_EQUAL(profile.duration(), 400u);
+}
+
+BOOST_AUTO_TEST_CASE(profile_points_can_be_added_in_days){
+    SetPointProfile profile;
+    profile.add(0, 18.0);
+    profile.addDays(2, 18.0);
+    profile.addDays(0.5, 21.0);
+
+    BOOST_CHECK_EQUAL(profile.duration(), 2u*86400 + 43200);
+    BOOST_CHECK_CLOSE(profile.read(2*86400 + 21600), 19.5, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(engine_advances_clock_after_each_step){
+    ticks.reset();
+    SimulationEngine engine(ticks);
+    uint32_t calls = 0;
+
+    engine.run(1000, [&](uint32_t t){
+        BOOST_REQUIRE_EQUAL(t, calls);
+        BOOST_REQUIRE_EQUAL(ticks.millis(), t * 1000);
+        calls++;
+    });
+
+    BOOST_CHECK_EQUAL(calls, 1000u);
+    BOOST_CHECK_EQUAL(ticks.seconds(), 1000u);
+    BOOST_CHECK_EQUAL(engine.elapsedSeconds(), 1000u);
+
+    engine.run(500, [&](uint32_t t){});
+    BOOST_CHECK_EQUAL(engine.steps(), 1500u);
+    BOOST_CHECK_EQUAL(ticks.seconds(), 1500u);
+}
+
+BOOST_AUTO_TEST_CASE(engine_runs_fast_steps_in_between_steps){
+    ticks.reset();
+    SimulationEngine engine(ticks, 1000, 3);
+    uint32_t fastCalls = 0;
+    ticks_millis_t lastFastCall = 0;
+
+    engine.run(10, [&](uint32_t t){
+        BOOST_REQUIRE_EQUAL(ticks.millis(), t * 1000); // steps stay aligned to whole seconds
+    },
+    [&](){
+        BOOST_REQUIRE_GT(ticks.millis(), lastFastCall);
+        lastFastCall = ticks.millis();
+        fastCalls++;
+    });
+
+    BOOST_CHECK_EQUAL(fastCalls, 30u);
+    BOOST_CHECK_EQUAL(ticks.millis(), 10000u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -37,12 +37,14 @@
 #include "ActuatorMutexDriver.h"
 #include "ActuatorMutexGroup.h"
 #include "runner.h"
+#include "SimulationModels.h"
+#include "SimulationEngine.h"
 #include <iostream>
 #include <fstream>
 
 struct MashStaticSetup{
 public:
-    MashStaticSetup(){
+    MashStaticSetup() : engine(ticks) {
         BOOST_TEST_MESSAGE( "setup mash test fixture" );
 
         mashSensor = new TempSensorMock(20.0);
@@ -111,90 +113,8 @@ public:
 
     SetPoint * mashSet;
     SetPoint * hltSet;
-};
-
-/* This class simulates a mashing process.
- * There are 3 heat capacities: the beer itself, the air in the fridge and the fridge walls.
- * The heater heats the air in the fridge directly.
- * The cooler cools the fridge walls, which in turn cool the fridge air.
- * This causes an extra delay when cooling and a potential source of overshoot
- */
-
-
-struct MashSimulation{
-    MashSimulation(){
-        mashTemp = 60.0;
-        hltTemp = 60.0;
-        envTemp = 20.0;
-        coilInTemp = 20;
-        coilOutTemp = 20;
-        mashInTemp = 20;
-
-        mashVolume = 18;
-        hltVolume = 36;
-
-        hltCapacity = 4.2 * 1.0 * hltVolume; // heat capacity water * density of water * 20L volume (in kJ per degree C).
-        mashCapacity = 4.2 * 1.0 * mashVolume;
-
-        hltHeaterPower = 3.5; // 3500W, in kW.
-
-        coilTransfer = 0.8; // percentage of temperature difference picked up in HLT coil
-        flowRate = 10.0/60; // 5 liter per minute, in L/s.
-        kettleEnvTransfer = 0.01; // losses to environment
-        mashToCoilLoss = 0.05; // losses between mash tun and coil
-        coilToMashLoss = 0.03; // losses between mash tun and coil
-
-        mashPumping = true;
-    }
-
-    virtual ~MashSimulation(){}
-
-    void update(temp_t heaterValue){
-        double mashTempNew = mashTemp;
-        double hltTempNew = hltTemp;
-
-        if(mashPumping){
-            coilInTemp = mashTemp - (mashTemp - envTemp) * mashToCoilLoss;
-            coilOutTemp = coilInTemp + (hltTemp - coilInTemp) * coilTransfer;
-            mashInTemp = coilOutTemp - (coilOutTemp - envTemp) * coilToMashLoss;
 
-            // coil transfer
-            mashTempNew = (mashTemp * (mashVolume - flowRate) + mashInTemp*flowRate) / mashVolume;
-            hltTempNew -= (coilOutTemp - coilInTemp) * flowRate / hltCapacity;
-        }
-
-        // heater
-        hltTempNew += hltHeaterPower * double(heaterValue) / (100.0 * hltCapacity);
-
-        // environment loss
-        mashTempNew -= (mashTemp - envTemp) * kettleEnvTransfer / mashCapacity;
-        hltTempNew -= (hltTemp - envTemp) * kettleEnvTransfer / hltCapacity;
-
-        hltTemp = hltTempNew;
-        mashTemp = mashTempNew;
-    }
-
-    double mashVolume;
-    double hltVolume;
-
-    double mashTemp;
-    double hltTemp;
-    double envTemp;
-    double coilInTemp;
-    double coilOutTemp;
-    double mashInTemp;
-
-    double hltCapacity;
-    double mashCapacity;
-
-    double hltHeaterPower;
-
-    double coilTransfer;
-    double flowRate;
-    double kettleEnvTransfer;
-    double mashToCoilLoss;
-    double coilToMashLoss;
-    bool mashPumping;
+    SimulationEngine engine; // advances the global test ticks in virtual time
 };
 
 /* Below are a few static setups that show how control can be set up.
@@ -217,7 +137,6 @@ struct SimMashDirect : public MashStaticSetup {
         mashSensor->setTemp(sim.mashTemp);
         hltSensor->setTemp(sim.hltTemp);
         sim.update(hltHeater->getValue());
-        delay(1000);
     }
 };
 
@@ -247,7 +166,6 @@ struct SimMashCascaded : public MashStaticSetup {
         mashSensor->setTemp(sim.mashTemp);
         hltSensor->setTemp(sim.hltTemp);
         sim.update(hltHeater->getValue());
-        delay(1000); // simulate actual time passing for pin state of cooler, which is time limited
     }
 };
 
@@ -260,7 +178,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_HLT_Heater_Acts_On_MashTemp, SimMashDirect)
     ofstream csv("./test_results/" + boost_test_name() + ".csv");
     csv << "1# mash setPoint, 2#error, 1#mash out sensor, 1#hlt sensor, 1#mash in temp, 3#heater pwm, 3# heater realized pwm, 4#p, 4#i, 4#d" << endl;
     double SetPointDouble = 68;
-    for(int t = 0; t < 7200; t++){
+    engine.run(7200, [&](uint32_t t){
 
         if(t > 2600 && t < 3200){
             SetPointDouble += (5.0/600); // ramp up slowly, 5 degrees in 10 minutes
@@ -284,7 +202,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_HLT_Heater_Acts_On_MashTemp, SimMashDirect)
                 << hltHeaterPid->i << "," // integral action
                 << hltHeaterPid->d // derivative action
                 << endl;
-    }
+    });
     csv.close();
 }
 
@@ -299,7 +217,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Mash_Cascaded_Control, SimMashCascaded)
             "5#heater pwm, 5# header realized pwm, 4#heater P, 4#heater I, 4#heater D"
             << endl;
     double SetPointDouble = 68;
-    for(int t = 0; t < 10800; t++){
+    engine.run(10800, [&](uint32_t t){
 
         if(t > 3600 && t < 4200){
             SetPointDouble += (5.0/600); // ramp up slowly, 5 degrees in 10 minutes
@@ -327,7 +245,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Mash_Cascaded_Control, SimMashCascaded)
                 << hltHeaterPid->i << "," // integral action
                 << hltHeaterPid->d  // derivative action
                 << endl;
-    }
+    });
     csv.close();
 }
 
@@ -346,7 +264,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Switch_from_HTL_to_Cascaded_Control, SimMashCas
     hltSet->write(70.0);
     sim.mashPumping = false;
 
-    for(int t = 0; t < 10800; t++){
+    engine.run(10800, [&](uint32_t t){
         if(t == 3600){
             // change to cascaded control (enable automatic HLT set point)
             mashSet->write(65.0);
@@ -374,7 +292,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Switch_from_HTL_to_Cascaded_Control, SimMashCas
                 << hltHeaterPid->i << "," // integral action
                 << hltHeaterPid->d  // derivative action
                 << endl;
-    }
+    });
     csv.close();
 }
 
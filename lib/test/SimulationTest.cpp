@@ -36,12 +36,14 @@
 #include "ActuatorMutexDriver.h"
 #include "ActuatorMutexGroup.h"
 #include "runner.h"
+#include "SimulationModels.h"
+#include "SimulationEngine.h"
 #include <iostream>
 #include <fstream>
 
 struct StaticSetup{
 public:
-    StaticSetup(){
+    StaticSetup() : engine(ticks) {
         BOOST_TEST_MESSAGE( "setup PID test fixture" );
 
         beerSensor = new TempSensorMock(20.0);
@@ -120,98 +122,8 @@ public:
 
     SetPoint * beerSet;
     SetPoint * fridgeSet;
-};
-
-/* This class simulates a fridge is a simple way:
- * There are 3 heat capacities: the beer itself, the air in the fridge and the fridge walls.
- * The heater heats the air in the fridge directly.
- * The cooler cools the fridge walls, which in turn cool the fridge air.
- * This causes an extra delay when cooling and a potential source of overshoot
- */
-
-
-struct Simulation{
-    Simulation(){
-        beerTemp = 20.0;
-        airTemp = 20.0;
-        wallTemp = 20.0;
-        envTemp = 20.0;
-        heaterTemp = 20.0;
-
-        beerCapacity = 4.2 * 1.0 * 20; // heat capacity water * density of water * 20L volume (in kJ per kelvin).
-        airCapacity = 1.005 * 1.225 * 0.200; // heat capacity of dry air * density of air * 200L volume (in kJ per kelvin).
-        // Moist air has only slightly higher heat capacity, 1.02 when saturated at 20C.
-        wallCapacity = 5.0; // just a guess
-        heaterCapacity = 1.0; // also a guess, to simulate that heater first heats itself, then starts heating the air
-
-        heaterPower = 0.1; // 100W, in kW.
-        coolerPower = 0.1; // 100W, in kW. Assuming 200W at 50% efficiency
-
-        airBeerTransfer= 1.0/300;
-        wallAirTransfer= 1.0/300;
-        heaterAirTransfer= 1.0/30;
-        envWallTransfer = 0.001; // losses to environment
-
-        heaterToBeer = 0.0; // ratio of heater transfered directly to beer instead of fridge air
-        heaterToAir = 1.0 - heaterToBeer;
-
-    }
-    virtual ~Simulation(){}
-
-    void update(bool heaterActive, bool coolerActive){
-        double beerTempNew = beerTemp;
-        double airTempNew = airTemp;
-        double wallTempNew = wallTemp;
-        double heaterTempNew = heaterTemp;
-
-        beerTempNew += (airTemp - beerTemp) * airBeerTransfer / beerCapacity;
-
-        if(heaterActive){
-            heaterTempNew += heaterPower / heaterCapacity;
-        }
-        if(coolerActive){
-            wallTempNew -= coolerPower / wallCapacity;
-        }
-
-        airTempNew += (heaterTemp - airTemp) * heaterAirTransfer / airCapacity;
-        airTempNew += (wallTemp - airTemp) * wallAirTransfer / airCapacity;
-        airTempNew += (beerTemp - airTemp) * airBeerTransfer / airCapacity;
-
-
-        beerTempNew += (airTemp - beerTemp) * airBeerTransfer / beerCapacity;
-
-        heaterTempNew += (airTemp - heaterTemp) * heaterAirTransfer / heaterCapacity;
-
-        wallTempNew += (envTemp - wallTemp) * envWallTransfer / wallCapacity;
-        wallTempNew += (airTemp - wallTemp) * wallAirTransfer/ wallCapacity;
-
-        airTemp = airTempNew;
-        beerTemp = beerTempNew;
-        wallTemp = wallTempNew;
-        heaterTemp = heaterTempNew;
-    }
-
-    double beerTemp;
-    double airTemp;
-    double wallTemp;
-    double envTemp;
-    double heaterTemp;
 
-    double beerCapacity;
-    double airCapacity;
-    double wallCapacity;
-    double heaterCapacity;
-
-    double heaterPower;
-    double coolerPower;
-
-    double airBeerTransfer;
-    double wallAirTransfer;
-    double envWallTransfer;
-    double heaterAirTransfer;
-
-    double heaterToBeer;
-    double heaterToAir;
+    SimulationEngine engine; // advances the global test ticks in virtual time
 };
 
 /* Below are a few static setups that show how control can be set up.
@@ -237,7 +149,6 @@ struct SimBeerHeater : public StaticSetup {
         heaterPid->update();
         heater->update();
         sim.update(heaterPin->isActive(), coolerPin->isActive());
-        delay(1000); // simulate actual time passing for pin state and mutex group
     }
 };
 
@@ -261,7 +172,6 @@ struct SimFridgeHeater : public StaticSetup {
         heater->update();
 
         sim.update(heaterPin->isActive(), coolerPin->isActive());
-        delay(1000); // simulate actual time passing for pin state and mutex group
     }
 };
 
@@ -286,7 +196,6 @@ struct SimBeerCooler : public StaticSetup {
         cooler->update();
 
         sim.update(heaterPin->isActive(), coolerPin->isActive());
-        delay(1000); // simulate actual time passing for pin state of cooler, which is time limited
     }
 };
 
@@ -310,7 +219,6 @@ struct SimFridgeCooler : public StaticSetup {
         cooler->update();
 
         sim.update(heaterPin->isActive(), coolerPin->isActive());
-        delay(1000); // simulate actual time passing for pin state of cooler, which is time limited
     }
 };
 
@@ -345,7 +253,6 @@ struct SimFridgeHeaterCooler : public StaticSetup {
         mutex->update();
 
         sim.update(heaterPin->isActive(), coolerPin->isActive());
-        delay(1000); // simulate actual time passing for pin state of cooler, which is time limited
     }
 };
 
@@ -380,7 +287,6 @@ struct SimBeerHeaterCooler : public StaticSetup {
         mutex->update();
 
         sim.update(heaterPin->isActive(), coolerPin->isActive());
-        delay(1000); // simulate actual time passing for pin state of cooler, which is time limited
     }
 };
 
@@ -426,7 +332,6 @@ struct SimCascadedHeaterCooler : public StaticSetup {
         mutex->update();
 
         sim.update(heaterPin->isActive(), coolerPin->isActive());
-        delay(1000); // simulate actual time passing for pin state of cooler, which is time limited
     }
 };
 
@@ -442,7 +347,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Air_Heater_Acts_On_Beer, SimBeerHeater)
     csv << "1#beer setPoint, 2#error, 1#beer sensor, 1#fridge air sensor, 1#fridge wall temp, "
             "3#heater pwm, 3#heater achieved pwm, 4#p, 4#i, 4#d" << endl;
     double SetPointDouble = 19;
-    for(int t = 0; t < 60000; t++){
+    engine.run(60000, [&](uint32_t t){
         if(t==1000){
             SetPointDouble = 21;
         }
@@ -463,7 +368,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Air_Heater_Acts_On_Beer, SimBeerHeater)
                 << heaterPid->i << "," // integral action
                 << heaterPid->d // derivative action
                 << endl;
-    }
+    });
     csv.close();
 }
 
@@ -474,7 +379,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Air_Heater_Acts_On_Fridge_Air, SimFridgeHeater)
     csv << "1#fridge setPoint, 2#error, 1#beer sensor, 1#fridge air sensor, 1#fridge wall temp, "
             "3#heater pwm, 3#heater achieved pwm, 4#p, 4#i, 4#d" << endl;
     double SetPointDouble = 19;
-    for(int t = 0; t < 20000; t++){
+    engine.run(20000, [&](uint32_t t){
         if(t==1000){
             SetPointDouble = 24;
         }
@@ -495,7 +400,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Air_Heater_Acts_On_Fridge_Air, SimFridgeHeater)
                 << heaterPid->i << "," // integral action
                 << heaterPid->d // derivative action
                 << endl;
-    }
+    });
     csv.close();
 }
 
@@ -506,7 +411,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Air_Cooler_Acts_On_Beer, SimBeerCooler)
     csv << "1#setPoint, 2#error, 1#beer sensor, 1#fridge air sensor, 1#fridge wall temp, "
             "3#cooler pwm, 3#cooler achieved pwm, 4#p, 4#i, 4#d, 5a#cooler pin" << endl;
     double SetPointDouble = 21;
-    for(int t = 0; t < 30000; t++){
+    engine.run(30000, [&](uint32_t t){
         if(t==1000){
             SetPointDouble = 19;
         }
@@ -528,7 +433,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Air_Cooler_Acts_On_Beer, SimBeerCooler)
                 << coolerPid->d << "," // derivative action
                 << coolerPin->isActive() // actual cooler pin state
                 << endl;
-    }
+    });
     csv.close();
 }
 
@@ -539,7 +444,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Air_Cooler_Acts_On_Fridge_Air, SimFridgeCooler)
     csv << "1#setPoint, 2#error, 1#beer sensor, 1#fridge air sensor, 1#fridge wall temp, "
             "3#cooler pwm, 3#cooler achieved pwm, 4#p, 4#i, 4#d, 5a#cooler pin" << endl;
     double SetPointDouble = 21;
-    for(int t = 0; t < 20000; t++){
+    engine.run(20000, [&](uint32_t t){
         if(t==1000){
             SetPointDouble = 19;
         }
@@ -561,7 +466,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Air_Cooler_Acts_On_Fridge_Air, SimFridgeCooler)
                 << coolerPid->d << "," // derivative action
                 << coolerPin->isActive() // actual cooler pin state
                 << endl;
-    }
+    });
     csv.close();
 }
 
@@ -579,7 +484,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Air_Cooler_Acts_On_Fridge_Air_With_Long_Period_
     cooler->setPeriod(3600);
     coolerTimeLimited->setTimes(600, 120);
 
-    for(int t = 0; t < 50000; t++){
+    engine.run(50000, [&](uint32_t t){
         if(t==1000){
             SetPointDouble = 19;
         }
@@ -601,7 +506,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Air_Cooler_Acts_On_Fridge_Air_With_Long_Period_
                 << coolerPid->d << "," // derivative action
                 << coolerPin->isActive() // actual cooler pin state
                 << endl;
-    }
+    });
     csv.close();
 }
 
@@ -615,7 +520,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Air_Heater_And_Cooler_Acting_On_Fridge_Air, Sim
                 "4#heater pwm, 4#heater achieved pwm, 3#heater P, 3#heater I, 3#heater D, "
                 "5a#cooler pin, 5a#heater pin" << endl;
     double SetPointDouble = 20;
-    for(int t = 0; t < 40000; t++){
+    engine.run(40000, [&](uint32_t t){
         if(t==1000){
             SetPointDouble = 19;
         }
@@ -651,7 +556,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Air_Heater_And_Cooler_Acting_On_Fridge_Air, Sim
                 << coolerPin->isActive() << "," // actual cooler pin state
                 << heaterPin->isActive() // actual cooler pin state
                 << endl;
-    }
+    });
     csv.close();
 }
 
@@ -664,7 +569,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Air_Heater_And_Cooler_Acting_On_Beer, SimBeerHe
             "4#heater pwm, 4#heater achieved pwm, 3#heater P, 3#heater I, 3#heater D, "
             "5a#cooler pin, 5a#heater pin" << endl;
     double SetPointDouble = 20;
-    for(int t = 0; t < 40000; t++){
+    engine.run(40000, [&](uint32_t t){
         if(t==1000){
             SetPointDouble = 19;
         }
@@ -699,7 +604,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Air_Heater_And_Cooler_Acting_On_Beer, SimBeerHe
                 << coolerPin->isActive() << "," // actual cooler pin state
                 << heaterPin->isActive() // actual cooler pin state
                 << endl;
-    }
+    });
     csv.close();
 }
 
@@ -714,7 +619,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Cascaded_Control, SimCascadedHeaterCooler)
            "7#heater pwm, 7# heater achieved pwm, 6#heater P, 6#heater I, 6#heater D, "
            "8a#cooler pin, 8a#heater pin" << endl;
     double SetPointDouble = 20;
-    for(int t = 0; t < 50000; t++){
+    engine.run(50000, [&](uint32_t t){
         if(t==1000){
             SetPointDouble = 19;
         }
@@ -761,7 +666,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Cascaded_Control, SimCascadedHeaterCooler)
                 << coolerPin->isActive() << "," // actual cooler pin state
                 << heaterPin->isActive() // actual cooler pin state
                 << endl;
-    }
+    });
     csv.close();
 }
 
@@ -782,7 +687,7 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Cascaded_Cool_Small_Volume, SimCascadedHeaterCo
 
     beerToFridgePid->setConstants(0.5, 1800, 180);
 
-    for(int t = 0; t < 10000; t++){
+    engine.run(10000, [&](uint32_t t){
         if(t==2000){
             beerSet->write(5.0);
         }
@@ -824,8 +729,64 @@ BOOST_FIXTURE_TEST_CASE(Simulate_Cascaded_Cool_Small_Volume, SimCascadedHeaterCo
                 << coolerPin->isActive() << "," // actual cooler pin state
                 << heaterPin->isActive() // actual cooler pin state
                 << endl;
-    }
+    });
     csv.close();
 }
 
+// Run a complete fermentation profile of 14 days with cascaded control.
+// Only one in 60 steps is written to the csv file, to keep the output manageable.
+// Lines end with '\n' instead of endl, so the file is not flushed for each line.
+BOOST_FIXTURE_TEST_CASE(Simulate_Cascaded_14_Day_Fermentation_Profile, SimCascadedHeaterCooler)
+{
+    ofstream csv("./test_results/" + boost_test_name() + ".csv");
+    csv << "1#beer setpoint, 1#beer sensor, 1#fridge setpoint, 1#fridge air sensor, 1#fridge wall temp, "
+           "2#cooler pwm, 2#heater pwm, 3a#cooler pin, 3a#heater pin" << endl;
+
+    SetPointProfile profile;
+    profile.add(0, 19.0);
+    profile.addDays(4, 19.0); // primary fermentation
+    profile.addDays(1, 21.0); // ramp up for diacetyl rest
+    profile.addDays(4, 21.0);
+    profile.addDays(1, 16.0); // ramp down to condition
+    profile.addDays(4, 16.0);
+
+    beerSet->write(profile.read(0));
+    sim.beerTemp = 19.0;
+
+    uint32_t bothActive = 0;
+    double maxError = 0;
+    const uint32_t settleTime = 86400; // ignore the first day
+
+    engine.run(profile.duration(), [&](uint32_t t){
+        beerSet->write(profile.read(t));
+        update();
+
+        if(heaterPin->isActive() && coolerPin->isActive()){
+            bothActive++;
+        }
+        if(t > settleTime){
+            double error = std::abs(sim.beerTemp - double(beerSet->read()));
+            maxError = (error > maxError) ? error : maxError;
+        }
+
+        if(t % 60 == 0){
+            csv     << beerSet->read() << "," // beer setpoint
+                    << beerSensor->read() << "," // beer temp
+                    << fridgeSet->read() << "," // fridge setpoint
+                    << fridgeSensor->read() << "," // air temp
+                    << sim.wallTemp << "," // fridge wall temperature
+                    << cooler->getValue() << "," // cooler output
+                    << heater->getValue() << "," // heater output
+                    << coolerPin->isActive() << "," // actual cooler pin state
+                    << heaterPin->isActive() // actual heater pin state
+                    << '\n';
+        }
+    });
+    csv.close();
+
+    BOOST_CHECK_EQUAL(bothActive, 0u); // pins are never active at the same time
+    BOOST_TEST_MESSAGE("maximum beer temperature error after first day: " << maxError);
+    BOOST_CHECK_LT(maxError, 1.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
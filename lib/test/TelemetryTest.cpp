@@ -0,0 +1,116 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "Telemetry.h"
+#include "temperatureFormats.h"
+#include <cstdlib>
+
+BOOST_AUTO_TEST_SUITE(TelemetryTest)
+
+BOOST_AUTO_TEST_CASE(frames_decode_to_the_encoded_values){
+    srand(7);
+    const uint8_t channels = 6;
+    TelemetryEncoder encoder(channels);
+    TelemetryDecoder decoder(channels);
+    int16_t values[channels] = {0};
+    uint8_t frame[Telemetry::maxFrameLength];
+
+    for(uint16_t i = 0; i < 1000; i++){
+        for(uint8_t c = 0; c < channels; c++){
+            int r = rand() % 10;
+            if(r == 0){
+                values[c] = (rand() % 2) ? INT16_MAX : INT16_MIN; // largest possible steps
+            }
+            else if(r < 4){
+                values[c] += rand() % 33 - 16; // small changes, typical for temperatures
+            }
+        }
+        uint8_t length = encoder.encode(values, frame);
+        BOOST_REQUIRE(length <= Telemetry::maxFrameLength);
+        BOOST_REQUIRE(decoder.decode(frame, length));
+        for(uint8_t c = 0; c < channels; c++){
+            BOOST_TEST_CONTEXT("frame " << i << ", channel " << int(c)){
+                BOOST_REQUIRE_EQUAL(decoder.value(c), values[c]);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(unchanged_values_are_not_sent){
+    TelemetryEncoder encoder(5);
+    int16_t values[5];
+    for(uint8_t c = 0; c < 5; c++){
+        values[c] = temp_t(20.0 + c).getRaw();
+    }
+    uint8_t frame[Telemetry::maxFrameLength];
+    uint8_t keyFrameLength = encoder.encode(values, frame);
+    BOOST_CHECK_EQUAL(frame[0], Telemetry::frameStart);
+    BOOST_CHECK(frame[3] & Telemetry::flagKeyFrame);
+
+    uint8_t emptyLength = encoder.encode(values, frame);
+    BOOST_CHECK_EQUAL(emptyLength, Telemetry::headerLength + 3); // header only
+
+    values[2] += 1; // one step of the least significant bit
+    BOOST_CHECK_EQUAL(encoder.encode(values, frame), emptyLength + 1);
+    BOOST_CHECK(keyFrameLength > emptyLength + 5);
+}
+
+BOOST_AUTO_TEST_CASE(corrupt_or_lost_frames_are_rejected_until_next_key_frame){
+    TelemetryEncoder encoder(2);
+    TelemetryDecoder decoder(2);
+    int16_t values[2] = {100, 200};
+    uint8_t frame[Telemetry::maxFrameLength];
+
+    uint8_t length = encoder.encode(values, frame);
+    BOOST_CHECK(decoder.decode(frame, length));
+
+    values[0] = 101;
+    length = encoder.encode(values, frame);
+    frame[length - 2] ^= 0x01; // corrupt the delta
+    BOOST_CHECK(!decoder.decode(frame, length));
+
+    values[0] = 102;
+    length = encoder.encode(values, frame);
+    BOOST_CHECK(!decoder.decode(frame, length)); // previous frame was lost, delta cannot be applied
+
+    encoder.requestKeyFrame();
+    values[1] = 201;
+    length = encoder.encode(values, frame);
+    BOOST_CHECK(decoder.decode(frame, length));
+    BOOST_CHECK_EQUAL(decoder.value(0), 102);
+    BOOST_CHECK_EQUAL(decoder.value(1), 201);
+}
+
+BOOST_AUTO_TEST_CASE(key_frames_are_sent_periodically){
+    TelemetryEncoder encoder(1);
+    int16_t value = 0;
+    uint8_t frame[Telemetry::maxFrameLength];
+    uint16_t keyFrames = 0;
+    for(uint16_t i = 0; i < 3 * TelemetryEncoder::keyFrameInterval; i++){
+        encoder.encode(&value, frame);
+        if(frame[3] & Telemetry::flagKeyFrame){
+            keyFrames++;
+        }
+    }
+    BOOST_CHECK_EQUAL(keyFrames, 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "UpdateScheduler.h"
+#include "Ticks.h"
+#include "ActuatorMocks.h"
+#include "ActuatorPwm.h"
+#include <string>
+
+struct UpdateSchedulerTest {
+    UpdateSchedulerTest(){
+        ticks.reset();
+        log.clear();
+    }
+
+    static void append(void * name){
+        log += static_cast<const char *>(name);
+    }
+
+    static std::string log;
+    UpdateScheduler scheduler;
+};
+
+std::string UpdateSchedulerTest::log;
+
+BOOST_FIXTURE_TEST_SUITE(UpdateSchedulerTestSuite, UpdateSchedulerTest)
+
+BOOST_AUTO_TEST_CASE(tasks_run_at_their_own_period){
+    scheduler.add(&append, (void *) "s", 1000);
+    scheduler.add(&append, (void *) "f", 250);
+
+    BOOST_CHECK_EQUAL(scheduler.run(), 250u); // all tasks are due when added
+    BOOST_CHECK_EQUAL(log, "sf");
+
+    for(ticks_millis_t t = 1; t <= 2000; t++){
+        ticks.setMillis(t);
+        scheduler.run();
+    }
+    BOOST_CHECK_EQUAL(log, "sffffsffffsf");
+}
+
+BOOST_AUTO_TEST_CASE(due_tasks_run_in_the_order_they_were_added){
+    scheduler.add(&append, (void *) "1", 1000);
+    scheduler.add(&append, (void *) "2", 500);
+    scheduler.add(&append, (void *) "3", 1000);
+    scheduler.run();
+    ticks.setMillis(1000);
+    scheduler.run();
+    BOOST_CHECK_EQUAL(log, "123123");
+}
+
+BOOST_AUTO_TEST_CASE(nothing_runs_before_the_next_deadline){
+    scheduler.add(&append, (void *) "a", 1000);
+    scheduler.run();
+    ticks.setMillis(400);
+    BOOST_CHECK_EQUAL(scheduler.timeUntilNext(), 600u);
+    BOOST_CHECK_EQUAL(scheduler.run(), 600u);
+    ticks.setMillis(999);
+    BOOST_CHECK_EQUAL(scheduler.run(), 1u);
+    BOOST_CHECK_EQUAL(log, "a");
+}
+
+BOOST_AUTO_TEST_CASE(late_task_does_not_catch_up){
+    scheduler.add(&append, (void *) "a", 1000);
+    scheduler.run();
+    ticks.setMillis(1100); // a little late, next deadline stays at 2000
+    BOOST_CHECK_EQUAL(scheduler.run(), 900u);
+    ticks.setMillis(5500); // more than a period late, rescheduled from now
+    BOOST_CHECK_EQUAL(scheduler.run(), 1000u);
+    ticks.setMillis(6000);
+    scheduler.run();
+    BOOST_CHECK_EQUAL(log, "aaa");
+}
+
+BOOST_AUTO_TEST_CASE(deadlines_are_correct_when_millis_wrap_around){
+    ticks.setMillis(UINT32_MAX - 500);
+    scheduler.add(&append, (void *) "a", 1000);
+    scheduler.run();
+    ticks.setMillis(200);
+    BOOST_CHECK_EQUAL(scheduler.run(), 299u);
+    ticks.setMillis(499);
+    scheduler.run();
+    BOOST_CHECK_EQUAL(log, "aa");
+}
+
+BOOST_AUTO_TEST_CASE(period_zero_runs_every_time){
+    scheduler.add(&append, (void *) "a", 0);
+    scheduler.add(&append, (void *) "b", 1000);
+    BOOST_CHECK_EQUAL(scheduler.run(), 0u);
+    BOOST_CHECK_EQUAL(scheduler.run(), 0u);
+    BOOST_CHECK_EQUAL(log, "aba");
+}
+
+static ticks_millis_t pwmFastUpdatePeriod(void * pwm){
+    return static_cast<ActuatorPwm *>(pwm)->fastUpdatePeriod();
+}
+
+static void countPwmUpdate(void * pwm){
+    UpdateSchedulerTest::log += "p";
+}
+
+BOOST_AUTO_TEST_CASE(period_function_is_read_each_time_the_task_is_rescheduled){
+    ActuatorDigital * target = new ActuatorBool();
+    ActuatorPwm * pwm = new ActuatorPwm(target, 256); // fast update every 1000 ms
+    scheduler.addWithPeriodFn(&countPwmUpdate, pwm, &pwmFastUpdatePeriod);
+
+    BOOST_CHECK_EQUAL(scheduler.run(), 1000u);
+    pwm->setPeriod(4); // fast update every 15 ms
+    ticks.setMillis(1000);
+    BOOST_CHECK_EQUAL(scheduler.run(), 15u);
+    for(ticks_millis_t t = 1001; t <= 1150; t++){
+        ticks.setMillis(t);
+        scheduler.run();
+    }
+    BOOST_CHECK_EQUAL(log, "pppppppppppp"); // at 0, 1000 and 10 times 15 ms after that
+
+    delete pwm;
+    delete target;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,278 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "temperatureFormats.h"
+#include <cstdlib>
+#include <cstring>
+
+/* The original string conversion functions, which used a division per digit and strtol.
+ * The current implementation should give exactly the same results.
+ */
+// converts fixed point value to string, without using double/float
+// resulting string is always length len (including \0). Spaces are prepended to achieve that
+static char * referenceToString(const int32_t raw, // raw value of fixed point
+        unsigned char const F, // number of fraction bits
+        char buf[], // target buffer
+        uint8_t const numDecimals, // number of decimals to print
+        uint8_t const len, // maximum number of characters to print
+        char format, // C or F
+        bool absolute) // is this an absolute temperature? need to subtract 32 for F
+        {
+
+    char const digit[] = "0123456789";
+    char* p;
+    bool negative = false;
+
+    // Use larger type to prevent overflow.
+    int64_t shifter = raw;
+
+    if(format =='F'){
+        int8_t rounder = (shifter < 0) ? -25 : 25;
+        shifter = (shifter * 90 + rounder) / 50;
+        if(absolute){
+            shifter += 32 << F;
+        }
+    }
+
+    if (shifter < 0) {
+        shifter = -shifter;
+        negative = true;
+    }
+    // code below looks a bit cryptic, but what it does is * 10^numDecimals / 2^F
+    for (uint8_t i = 0; i < numDecimals; i++) {
+        shifter = shifter * 5; // *5 instead of 10, combined with reduced shift below. Less chance of overflow
+    }
+    shifter = (shifter + (1 << (F - numDecimals - 1))) >> (F - numDecimals); // divide rounded by fixed point scale
+
+    p = &buf[len - 1]; // start at the end of buffer
+    *p = '\0';
+    lldiv_t dv { };
+    dv.quot = shifter;
+    do { //Move back, inserting digits as u go
+        if (p == &buf[len - 1 - numDecimals]) {
+            *--p = '.'; // insert decimal point at right moment
+        } else {
+            dv = lldiv(dv.quot, 10);
+            if ((dv.quot || dv.rem)) { // check if end of digits
+                *--p = digit[std::abs(dv.rem)];
+            } else if ((p - buf) > (len - numDecimals - 3)) { // still need to print some leading zeros
+                *--p = '0';
+            } else if (negative) {
+                // print minus sign if needed as last digit to print
+                *--p = '-';
+                break;
+            } else {
+                break;
+            }
+        }
+    } while (p > buf);
+    char * pWithoutSpaces = p;
+    while (p > buf) {
+        *(--p) = ' '; // prepend digits with spaces
+    }
+    // return pointer to string skipping spaces
+    // programmer can choose to use original buf pointer with spaces or return value without spaces
+    return pWithoutSpaces;
+}
+
+// Converts string into fixed point and returns bool on success.
+static bool referenceFromString(int32_t * raw, // result is put in this variable upon success
+        unsigned char F, // number of fraction bits
+        char const * const s, // the string to convert
+        char format,
+        bool absolute,
+        int32_t minimum, // minimum value for result
+        int32_t maximum) // maximum value for result
+        {
+    // receive new value as null terminated string: "19.20"
+    int64_t newValue;
+
+    // larger type to prevent overflow
+    int64_t decimalValue = 0;
+
+    char const * decimalPtr;
+    char* end;
+    // Check if - is in the string
+    bool positive = (0 == strchr(s, '-'));
+
+    newValue = strtol_impl(s, &end); // convert string to integer
+    if (invalidStrtolResult(s, end)) {
+        return false; // string was not valid
+    }
+    newValue = newValue << F; // shift to fixed point
+
+    // find the point in the string to know whether we have decimals
+    decimalPtr = strchr(s, '.'); // returns pointer to the point.
+    if (decimalPtr != 0) {
+        decimalPtr++; // skip decimal point
+        // convert decimals to integer
+        decimalValue = strtol_impl(decimalPtr, &end);
+        if (invalidStrtolResult(decimalPtr, end)) {
+            return false; // string was not valid
+        }
+
+        decimalValue = decimalValue << F;
+        uint8_t charsAfterPoint = end - decimalPtr; // actually used # digits after point
+        while (charsAfterPoint-- > 0) {
+            decimalValue = (decimalValue + 5) / 10;
+        }
+    }
+    newValue = positive ? newValue + decimalValue : newValue - decimalValue;
+    if(format == 'F'){
+        if(absolute){
+            newValue -= 32 << F;
+        }
+        int8_t rounder = (newValue < 0) ? -45 : 45;
+        newValue = (newValue * 50 + rounder) / 90; // rounded conversion from F to C
+    }
+    if (newValue >= minimum && newValue <= maximum) {
+        *raw = newValue;
+        return true;
+    }
+    return false; // if value is not within limits, it is likely invalid
+}
+
+// checks toStringImpl against the reference for one raw value, in all formats and a few buffer lengths
+static void checkToString(int32_t raw, unsigned char F, uint8_t maxDecimals){
+    static const uint8_t lengths[] = {6, 9, 12, 15};
+    for(uint8_t numDecimals = 0; numDecimals <= maxDecimals; numDecimals++){
+        for(uint8_t len : lengths){
+            for(char format : {'C', 'F'}){
+                for(bool absolute : {false, true}){
+                    char expected[16];
+                    char actual[16];
+                    char * e = referenceToString(raw, F, expected, numDecimals, len, format, absolute);
+                    char * a = toStringImpl(raw, F, actual, numDecimals, len, format, absolute);
+                    if(e - expected == a - actual && memcmp(expected, actual, len) == 0){
+                        continue; // only use boost test for mismatches, it is too slow for millions of checks
+                    }
+                    BOOST_TEST_CONTEXT("raw " << raw << ", F " << int(F) << ", decimals " << int(numDecimals)
+                            << ", len " << int(len) << ", " << format << (absolute ? " absolute" : "")){
+                        BOOST_REQUIRE_EQUAL(std::string(expected, len), std::string(actual, len));
+                        BOOST_REQUIRE_EQUAL(e - expected, a - actual);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// checks fromStringImpl against the reference for one string
+static void checkFromString(char const * s, unsigned char F, int32_t minimum, int32_t maximum){
+    for(char format : {'C', 'F'}){
+        for(bool absolute : {false, true}){
+            int32_t expected = 12345;
+            int32_t actual = 12345;
+            bool expectedSuccess = referenceFromString(&expected, F, s, format, absolute, minimum, maximum);
+            bool success = fromStringImpl(&actual, F, s, format, absolute, minimum, maximum);
+            if(expectedSuccess == success && expected == actual){
+                continue;
+            }
+            BOOST_TEST_CONTEXT("\"" << s << "\", F " << int(F) << ", " << format << (absolute ? " absolute" : "")){
+                BOOST_REQUIRE_EQUAL(expectedSuccess, success);
+                BOOST_REQUIRE_EQUAL(expected, actual);
+            }
+        }
+    }
+}
+
+// parses the output of the reference toString for a raw value
+static void checkRoundTrip(int32_t raw, unsigned char F, uint8_t maxDecimals, int32_t minimum, int32_t maximum){
+    for(uint8_t numDecimals = 1; numDecimals <= maxDecimals; numDecimals++){
+        for(char format : {'C', 'F'}){
+            char buf[16];
+            char * s = referenceToString(raw, F, buf, numDecimals, 16, format, true);
+            checkFromString(s, F, minimum, maximum);
+            checkFromString(buf, F, minimum, maximum); // with leading spaces
+        }
+    }
+}
+
+// random raw value, with the magnitude spread over all bit lengths
+static int32_t randomRaw(){
+    uint32_t bits = (uint32_t(rand()) << 16) ^ uint32_t(rand());
+    return int32_t(bits) >> (rand() % 32);
+}
+
+BOOST_AUTO_TEST_SUITE(temperature_string_suite)
+
+BOOST_AUTO_TEST_CASE(toString_is_same_as_reference_for_all_temp_values){
+    for(int32_t raw = INT16_MIN; raw <= INT16_MAX; raw++){
+        checkToString(raw, temp_t::fractional_bit_count, 4);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(toString_is_same_as_reference_for_long_and_precise_values){
+    srand(1);
+    const int32_t edges[] = {INT32_MIN, INT32_MIN + 1, -1, 0, 1, INT32_MAX - 1, INT32_MAX};
+    for(int32_t raw : edges){
+        checkToString(raw, temp_long_t::fractional_bit_count, 4);
+        checkToString(raw, temp_precise_t::fractional_bit_count, 8);
+    }
+    for(uint32_t i = 0; i < 20000; i++){
+        int32_t raw = randomRaw();
+        checkToString(raw, temp_long_t::fractional_bit_count, 4);
+        checkToString(raw, temp_precise_t::fractional_bit_count, 8);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fromString_is_same_as_reference_for_all_temp_values){
+    for(int32_t raw = INT16_MIN; raw <= INT16_MAX; raw++){
+        checkRoundTrip(raw, temp_t::fractional_bit_count, 4, temp_t::min_val, temp_t::max_val);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fromString_is_same_as_reference_for_long_and_precise_values){
+    srand(2);
+    for(uint32_t i = 0; i < 5000; i++){
+        int32_t raw = randomRaw();
+        checkRoundTrip(raw, temp_long_t::fractional_bit_count, 4, temp_long_t::min_val, temp_long_t::max_val);
+        checkRoundTrip(raw, temp_precise_t::fractional_bit_count, 8, temp_precise_t::min_val, temp_precise_t::max_val);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fromString_is_same_as_reference_for_unusual_strings){
+    const char * strings[] = {
+        "", " ", "-", ".", "-.5", "12.", "1.2.3", "1-2", "- 5", "12 ", "12 .5", "12.5 ", "1.-5", "abc", "12a",
+        "0000000012.500000000", "1234567890", "0.1234567890", "99999999999", "-0", "-0.0", "+5", "5e2"
+    };
+    for(const char * s : strings){
+        checkFromString(s, temp_t::fractional_bit_count, temp_t::min_val, temp_t::max_val);
+        checkFromString(s, temp_long_t::fractional_bit_count, temp_long_t::min_val, temp_long_t::max_val);
+        checkFromString(s, temp_precise_t::fractional_bit_count, temp_precise_t::min_val, temp_precise_t::max_val);
+    }
+
+    // random strings of characters that can occur in a number
+    srand(3);
+    const char chars[] = " -.0123456789x";
+    for(uint32_t i = 0; i < 50000; i++){
+        char s[14];
+        uint8_t len = rand() % sizeof(s);
+        for(uint8_t c = 0; c < len; c++){
+            s[c] = chars[rand() % (sizeof(chars) - 1)];
+        }
+        s[len] = '\0';
+        checkFromString(s, temp_t::fractional_bit_count, temp_t::min_val, temp_t::max_val);
+        checkFromString(s, temp_long_t::fractional_bit_count, temp_long_t::min_val, temp_long_t::max_val);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -680,6 +680,48 @@ BOOST_AUTO_TEST_CASE(temp_disabled_or_invalid_prints_null){
     BOOST_REQUIRE_MESSAGE(strcmp(s1, s2) == 0, "\"" << s1 << "\" should be \"" << s2 << "\"" << " converting " << t);
 }
 
+BOOST_AUTO_TEST_CASE(constants_and_conversions_are_constexpr){
+    constexpr temp_t a(1.5);
+    constexpr temp_precise_t b(a);
+    constexpr temp_long_t c(b);
+    constexpr temp_t d(temp_long_t(1000.0)); // constrained to max
+    constexpr temp_t e(temp_long_t(-1000.0)); // constrained to min
+
+    static_assert(a.getRaw() == 3 << (temp_t::fractional_bit_count - 1), "1.5 is 3 halves");
+    static_assert(b.getRaw() == 3 << (temp_precise_t::fractional_bit_count - 1), "1.5 in temp_precise_t");
+    static_assert(c.getRaw() == a.getRaw(), "same fraction bits");
+    static_assert(d.getRaw() == temp_t::max_val, "constrained to max");
+    static_assert(e.getRaw() == temp_t::min_val, "constrained to min");
+    static_assert(!e.isDisabledOrInvalid(), "min is valid");
+    static_assert(temp_precise_t(temp_t(-2.25)).getRaw() == -9 * (1 << (temp_precise_t::fractional_bit_count - 2)),
+            "negative values convert correctly");
+
+    BOOST_CHECK_EQUAL(double(a), 1.5);
+}
+
+// the converting constructors are bit exact with shifting the raw values, for all values of temp_t
+BOOST_AUTO_TEST_CASE(conversions_are_bit_exact_for_all_temp_values){
+    const uint8_t preciseShift = temp_precise_t::fractional_bit_count - temp_t::fractional_bit_count;
+    for(int32_t raw = INT16_MIN; raw <= INT16_MAX; raw++){
+        temp_t t;
+        t.setRaw(raw);
+        temp_precise_t p(t);
+        BOOST_REQUIRE_EQUAL(p.getRaw(), int32_t(uint32_t(raw) << preciseShift));
+        BOOST_REQUIRE_EQUAL(temp_t(p).getRaw(), raw);
+        temp_long_t l(t);
+        BOOST_REQUIRE_EQUAL(l.getRaw(), raw);
+        int32_t constrained = (raw < temp_t::min_val) ? temp_t::min_val : raw; // invalid and disabled are below min
+        BOOST_REQUIRE_EQUAL(temp_t(l).getRaw(), constrained);
+        BOOST_REQUIRE_EQUAL(temp_precise_t(l).getRaw(), int32_t(uint32_t(constrained) << preciseShift));
+
+        // precise values with all fraction bits set are truncated towards minus infinity
+        temp_precise_t q;
+        q.setRaw(p.getRaw() | ((1 << preciseShift) - 1));
+        BOOST_REQUIRE_EQUAL(temp_t(q).getRaw(), raw);
+        BOOST_REQUIRE_EQUAL(temp_long_t(q).getRaw(), raw);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SweepCase.h"
+
+#include "Pid.h"
+#include "SetPoint.h"
+#include "TempSensorExternal.h"
+#include "ActuatorMocks.h"
+#include "ActuatorPwm.h"
+#include "ActuatorTimeLimited.h"
+#include "Ticks.h"
+#include "SimulationModels.h"
+#include "SimulationEngine.h"
+#include <math.h>
+
+SweepScenario::SweepScenario(Type t) : type(t)
+{
+    // defaults match the basic setups in SimulationTest.cpp
+    envTemp = isHeater() ? 16.0 : 24.0;
+    startTemp = isHeater() ? 19.0 : 21.0;
+    if(actsOnBeer()){
+        stepTemp = isHeater() ? 21.0 : 19.0;
+        duration = 40000;
+    }
+    else{
+        stepTemp = isHeater() ? 24.0 : 19.0;
+        duration = 20000;
+    }
+    stepTime = 1000;
+    settlingBand = 0.25;
+    pwmPeriod = isHeater() ? 20 : 1200;
+    beerLiters = 20.0;
+    heaterPower = 0.1;
+    coolerPower = 0.1;
+}
+
+/* Mimics a DS18B20 like TempSensorMock: 1/16 degree resolution with up to half a bit of noise.
+ * Uses its own pseudo random generator, so every simulation sees the same noise and results are reproducible
+ * regardless of how simulations are distributed over threads.
+ */
+class QuantizedSensorValue {
+public:
+    QuantizedSensorValue() : state(2463534242u) {}
+
+    temp_t quantize(double value){
+        const uint8_t shift = temp_t::fractional_bit_count - 4;
+        temp_t rounder;
+        rounder.setRaw((1 << (shift - 1)) + next() % (1 << (shift - 1)));
+        temp_t t = value;
+        return ((t + rounder) >> shift) << shift;
+    }
+
+private:
+    uint32_t next(){
+        // xorshift32
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    uint32_t state;
+};
+
+SweepResult runSweepCase(SweepScenario const & scenario, SweepParameters const & params, SweepWeights const & weights)
+{
+    ticks.reset();
+
+    Simulation sim;
+    sim.envTemp = scenario.envTemp;
+    sim.beerTemp = scenario.startTemp;
+    sim.airTemp = scenario.startTemp;
+    sim.wallTemp = scenario.startTemp;
+    sim.heaterTemp = scenario.startTemp;
+    sim.beerCapacity = 4.2 * 1.0 * scenario.beerLiters;
+    sim.heaterPower = scenario.heaterPower;
+    sim.coolerPower = scenario.coolerPower;
+
+    bool heater = scenario.isHeater();
+    double * processTemp = scenario.actsOnBeer() ? &sim.beerTemp : &sim.airTemp;
+
+    QuantizedSensorValue noise;
+    TempSensorExternal sensor(true);
+    sensor.setValue(noise.quantize(*processTemp));
+    SetPointSimple setPoint(scenario.startTemp);
+
+    ActuatorBool pin;
+    ActuatorTimeLimited coolerTimeLimited(&pin, 120, 180); // 2 min minOn time, 3 min minOff, like the cooler in the tests
+    ActuatorDigital * pwmTarget = heater ? static_cast<ActuatorDigital *>(&pin) : &coolerTimeLimited;
+    ActuatorPwm pwm(pwmTarget, scenario.pwmPeriod);
+
+    Pid pid(&sensor, &pwm, &setPoint);
+    pid.setActuatorIsNegative(!heater);
+    pid.setInputFilter(params.inputFilter);
+    pid.setDerivativeFilter(params.derivativeFilter);
+    pid.setConstants(temp_long_t(params.kp), params.ti, params.td);
+
+    SweepResult result;
+    result.params = params;
+    result.overshoot = 0.0;
+    result.toggles = 0;
+
+    bool wasActive = pin.isActive();
+    uint32_t withinBandSince = scenario.stepTime;
+    bool outsideBand = true;
+    double sumSquaredError = 0.0;
+    uint32_t errorSamples = 0;
+    double direction = (scenario.stepTemp >= scenario.startTemp) ? 1.0 : -1.0;
+
+    SimulationEngine engine(ticks);
+    engine.run(scenario.duration, [&](uint32_t t){
+        if(t == scenario.stepTime){
+            setPoint.write(scenario.stepTemp);
+        }
+        sensor.setValue(noise.quantize(*processTemp));
+        pid.update();
+        pwm.update();
+        sim.update(heater && pin.isActive(), !heater && pin.isActive());
+
+        if(pin.isActive() != wasActive){
+            wasActive = pin.isActive();
+            result.toggles++;
+        }
+
+        if(t >= scenario.stepTime){
+            double error = *processTemp - scenario.stepTemp;
+            double beyond = error * direction;
+            if(beyond > result.overshoot){
+                result.overshoot = beyond;
+            }
+            outsideBand = fabs(error) > scenario.settlingBand;
+            if(outsideBand){
+                withinBandSince = t + 1;
+            }
+            sumSquaredError += error * error;
+            errorSamples++;
+        }
+    });
+
+    result.settled = !outsideBand;
+    result.settlingTime = result.settled ? withinBandSince - scenario.stepTime : scenario.duration - scenario.stepTime;
+    result.rmsError = errorSamples ? sqrt(sumSquaredError / errorSamples) : 0.0;
+
+    double hours = scenario.duration / 3600.0;
+    result.score = weights.rmsError * result.rmsError
+            + weights.overshoot * result.overshoot
+            + weights.settlingTime * (result.settlingTime / 3600.0)
+            + weights.toggles * (result.toggles / hours);
+    return result;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// PID settings for one simulation in the sweep
+struct SweepParameters {
+    double kp;
+    uint16_t ti;
+    uint16_t td;
+    uint8_t inputFilter;
+    uint8_t derivativeFilter;
+};
+
+/* The closed loop that is simulated: a single heater or cooler acting on beer or fridge air temperature,
+ * like the basic setups in SimulationTest.cpp. The set point makes a step at stepTime.
+ */
+struct SweepScenario {
+    enum Type : uint8_t {
+        BEER_HEATER,
+        FRIDGE_HEATER,
+        BEER_COOLER,
+        FRIDGE_COOLER
+    };
+
+    SweepScenario(Type t = BEER_HEATER);
+
+    bool isHeater() const {
+        return type == BEER_HEATER || type == FRIDGE_HEATER;
+    }
+
+    bool actsOnBeer() const {
+        return type == BEER_HEATER || type == BEER_COOLER;
+    }
+
+    Type type;
+    double envTemp;        // temperature outside the fridge
+    double startTemp;      // initial temperature of the thermal model and initial set point
+    double stepTemp;       // set point after the step
+    uint32_t stepTime;     // seconds after start at which the set point changes
+    uint32_t duration;     // total duration in seconds
+    double settlingBand;   // error within which the process is considered settled
+    uint16_t pwmPeriod;    // PWM period of the actuator in seconds
+    double beerLiters;     // beer volume, used for heat capacity of the beer
+    double heaterPower;    // in kW
+    double coolerPower;    // in kW
+};
+
+// Weights to combine the measured performance of a simulation into a single score. Lower is better.
+struct SweepWeights {
+    double rmsError = 1.0;       // per degree RMS error after the step
+    double overshoot = 2.0;      // per degree overshoot
+    double settlingTime = 0.25;  // per hour settling time
+    double toggles = 0.005;      // per actuator toggle per hour
+};
+
+struct SweepResult {
+    SweepParameters params;
+    double overshoot;       // maximum temperature beyond the new set point in the direction of the step
+    uint32_t settlingTime;  // seconds from the step until the error stays within the settling band
+    bool settled;           // false if the error was outside the settling band at the end of the simulation
+    uint32_t toggles;       // number of times the actuator pin changed state
+    double rmsError;        // root mean square error between temperature and set point after the step
+    double score;
+};
+
+/* Runs a single closed loop simulation with the controller objects from lib/src and the thermal model
+ * from the simulation tests and returns its performance.
+ * The simulation uses the ticks of the calling thread, so simulations in different threads are independent.
+ */
+SweepResult runSweepCase(SweepScenario const & scenario, SweepParameters const & params, SweepWeights const & weights);
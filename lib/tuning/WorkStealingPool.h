@@ -0,0 +1,123 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Runs a fixed number of independent tasks on a number of worker threads.
+ * Each worker starts with its own contiguous range of task indices in a private queue and takes work from
+ * the back of that queue. When its queue is empty, it steals from the front of the queue of another worker.
+ * This keeps all cores busy when some simulations take longer than others (for example when a PID oscillates
+ * and the actuators toggle a lot), without a single shared queue that all workers contend for.
+ */
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned numThreads) : queues(numThreads ? numThreads : 1), stolen(0) {}
+    ~WorkStealingPool() = default;
+
+    unsigned size() const {
+        return queues.size();
+    }
+
+    // number of tasks executed by another worker than the one they were assigned to in the last run
+    size_t stolenTasks() const {
+        return stolen;
+    }
+
+    // calls task(index) for all indices in [0, count) and returns when all are done
+    template<typename Task>
+    void run(size_t count, Task && task){
+        unsigned n = size();
+        stolen = 0;
+        for(unsigned w = 0; w < n; w++){
+            size_t begin = count * w / n;
+            size_t end = count * (w + 1) / n;
+            queues[w].tasks.clear();
+            for(size_t i = begin; i < end; i++){
+                queues[w].tasks.push_back(i);
+            }
+        }
+
+        std::vector<std::thread> workers;
+        for(unsigned w = 1; w < n; w++){
+            workers.emplace_back([this, w, &task](){ work(w, task); });
+        }
+        work(0, task); // calling thread is worker 0
+        for(auto & t : workers){
+            t.join();
+        }
+    }
+
+private:
+    struct Queue {
+        std::mutex lock;
+        std::deque<size_t> tasks;
+    };
+
+    // take the next task from the own queue, last in first out
+    bool pop(unsigned w, size_t & index){
+        std::lock_guard<std::mutex> guard(queues[w].lock);
+        if(queues[w].tasks.empty()){
+            return false;
+        }
+        index = queues[w].tasks.back();
+        queues[w].tasks.pop_back();
+        return true;
+    }
+
+    // take the oldest task from another worker, which is furthest from what that worker is doing now
+    bool steal(unsigned w, size_t & index){
+        unsigned n = size();
+        for(unsigned i = 1; i < n; i++){
+            Queue & victim = queues[(w + i) % n];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if(!victim.tasks.empty()){
+                index = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<typename Task>
+    void work(unsigned w, Task & task){
+        size_t index;
+        while(true){
+            if(pop(w, index)){
+                task(index);
+            }
+            else if(steal(w, index)){
+                stolen++;
+                task(index);
+            }
+            else{
+                return; // no tasks are added during a run, so all queues empty means done
+            }
+        }
+    }
+
+    std::vector<Queue> queues;
+    std::atomic<size_t> stolen;
+};
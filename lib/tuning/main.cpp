@@ -0,0 +1,289 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* pidsweep: runs a grid of PID settings through closed loop simulations on all cores and ranks them.
+ * Run without arguments for the default beer heater sweep, or with -h for all options.
+ */
+
+#include "Platform.h"
+#include "Ticks.h"
+#include "SweepCase.h"
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+thread_local ExternalTicks ticks;
+thread_local NoOpDelay wait;
+
+// a range of values to sweep: from, to (inclusive) and step
+struct SweepRange {
+    double from;
+    double to;
+    double step;
+
+    std::vector<double> values() const {
+        std::vector<double> v;
+        if(step <= 0){
+            v.push_back(from);
+            return v;
+        }
+        for(double x = from; x <= to + step * 1e-6; x += step){
+            v.push_back(x);
+        }
+        return v;
+    }
+};
+
+// parses "from:to:step", "from:to" (step 1) or a single value
+static bool parseRange(char const * s, SweepRange & range){
+    char * end;
+    range.from = strtod(s, &end);
+    if(end == s){
+        return false;
+    }
+    range.to = range.from;
+    range.step = 0;
+    if(*end == ':'){
+        char const * next = end + 1;
+        range.to = strtod(next, &end);
+        if(end == next){
+            return false;
+        }
+        range.step = 1;
+        if(*end == ':'){
+            next = end + 1;
+            range.step = strtod(next, &end);
+            if(end == next){
+                return false;
+            }
+        }
+    }
+    return *end == '\0' && range.to >= range.from;
+}
+
+static bool parseScenario(char const * s, SweepScenario::Type & type){
+    struct { char const * name; SweepScenario::Type type; } const names[] = {
+        {"beer-heater", SweepScenario::BEER_HEATER},
+        {"fridge-heater", SweepScenario::FRIDGE_HEATER},
+        {"beer-cooler", SweepScenario::BEER_COOLER},
+        {"fridge-cooler", SweepScenario::FRIDGE_COOLER},
+    };
+    for(auto const & n : names){
+        if(strcmp(s, n.name) == 0){
+            type = n.type;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void usage(char const * name){
+    printf("Usage: %s [options]\n"
+           "Runs closed loop simulations for a grid of PID settings and ranks them by score (lower is better).\n"
+           "Ranges are given as from:to:step, from:to (step 1) or a single value.\n\n"
+           "  -s, --scenario NAME        beer-heater (default), fridge-heater, beer-cooler, fridge-cooler\n"
+           "      --kp RANGE             proportional gain (default 10:60:10)\n"
+           "      --ti RANGE             integral time in seconds, 0 disables the integrator (default 0:7200:1800)\n"
+           "      --td RANGE             derivative time in seconds (default 0:1200:300)\n"
+           "      --input-filter RANGE   input filter b value, 0-6 (default 0:2)\n"
+           "      --derivative-filter RANGE  derivative filter b value, 0-6 (default 2:5)\n"
+           "      --env TEMP             temperature outside the fridge\n"
+           "      --start TEMP           initial temperature and set point\n"
+           "      --target TEMP          set point after the step\n"
+           "      --duration SECONDS     simulated time per run\n"
+           "      --period SECONDS       PWM period of the actuator\n"
+           "      --liters L             beer volume\n"
+           "      --heater-watts W       heater power\n"
+           "      --cooler-watts W       cooler power\n"
+           "      --band TEMP            settling band around the set point (default 0.25)\n"
+           "      --weights R,O,S,T      score weights for RMS error, overshoot, settling hours, toggles per hour\n"
+           "  -j, --threads N            number of worker threads (default: all cores)\n"
+           "  -n, --top N                number of results to print (default 20, 0 for all)\n"
+           "      --csv                  print results as comma separated values\n"
+           "  -h, --help                 show this help\n", name);
+}
+
+int main(int argc, char * argv[]){
+    SweepScenario::Type type = SweepScenario::BEER_HEATER;
+    SweepRange kp = {10, 60, 10};
+    SweepRange ti = {0, 7200, 1800};
+    SweepRange td = {0, 1200, 300};
+    SweepRange inputFilter = {0, 2, 1};
+    SweepRange derivativeFilter = {2, 5, 1};
+    SweepWeights weights;
+    unsigned threads = std::thread::hardware_concurrency();
+    size_t top = 20;
+    bool csv = false;
+
+    // scenario is needed first, because the other options override its defaults
+    for(int i = 1; i < argc - 1; i++){
+        if(strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--scenario") == 0){
+            if(!parseScenario(argv[i + 1], type)){
+                fprintf(stderr, "unknown scenario: %s\n", argv[i + 1]);
+                return 1;
+            }
+        }
+    }
+    SweepScenario scenario(type);
+
+    for(int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if(arg == "-h" || arg == "--help"){
+            usage(argv[0]);
+            return 0;
+        }
+        if(arg == "--csv"){
+            csv = true;
+            continue;
+        }
+        if(i + 1 >= argc){
+            fprintf(stderr, "missing value for %s\n", arg.c_str());
+            return 1;
+        }
+        char const * value = argv[++i];
+        bool valid = true;
+        if(arg == "-s" || arg == "--scenario"){
+            // already handled
+        }
+        else if(arg == "--kp"){
+            valid = parseRange(value, kp);
+        }
+        else if(arg == "--ti"){
+            valid = parseRange(value, ti);
+        }
+        else if(arg == "--td"){
+            valid = parseRange(value, td);
+        }
+        else if(arg == "--input-filter"){
+            valid = parseRange(value, inputFilter);
+        }
+        else if(arg == "--derivative-filter"){
+            valid = parseRange(value, derivativeFilter);
+        }
+        else if(arg == "--env"){
+            scenario.envTemp = atof(value);
+        }
+        else if(arg == "--start"){
+            scenario.startTemp = atof(value);
+        }
+        else if(arg == "--target"){
+            scenario.stepTemp = atof(value);
+        }
+        else if(arg == "--duration"){
+            scenario.duration = strtoul(value, nullptr, 10);
+            valid = scenario.duration > scenario.stepTime;
+        }
+        else if(arg == "--period"){
+            scenario.pwmPeriod = strtoul(value, nullptr, 10);
+            valid = scenario.pwmPeriod > 0;
+        }
+        else if(arg == "--liters"){
+            scenario.beerLiters = atof(value);
+            valid = scenario.beerLiters > 0;
+        }
+        else if(arg == "--heater-watts"){
+            scenario.heaterPower = atof(value) / 1000.0;
+        }
+        else if(arg == "--cooler-watts"){
+            scenario.coolerPower = atof(value) / 1000.0;
+        }
+        else if(arg == "--band"){
+            scenario.settlingBand = atof(value);
+        }
+        else if(arg == "--weights"){
+            valid = sscanf(value, "%lf,%lf,%lf,%lf", &weights.rmsError, &weights.overshoot,
+                           &weights.settlingTime, &weights.toggles) == 4;
+        }
+        else if(arg == "-j" || arg == "--threads"){
+            threads = strtoul(value, nullptr, 10);
+        }
+        else if(arg == "-n" || arg == "--top"){
+            top = strtoul(value, nullptr, 10);
+        }
+        else{
+            fprintf(stderr, "unknown option: %s\n", arg.c_str());
+            usage(argv[0]);
+            return 1;
+        }
+        if(!valid){
+            fprintf(stderr, "invalid value for %s: %s\n", arg.c_str(), value);
+            return 1;
+        }
+    }
+
+    std::vector<SweepParameters> grid;
+    for(double p : kp.values()){
+        for(double i : ti.values()){
+            for(double d : td.values()){
+                for(double fi : inputFilter.values()){
+                    for(double fd : derivativeFilter.values()){
+                        grid.push_back({p, uint16_t(i), uint16_t(d), uint8_t(fi), uint8_t(fd)});
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<SweepResult> results(grid.size());
+    WorkStealingPool pool(threads);
+
+    auto start = std::chrono::steady_clock::now();
+    pool.run(grid.size(), [&](size_t index){
+        results[index] = runSweepCase(scenario, grid[index], weights);
+    });
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::sort(results.begin(), results.end(), [](SweepResult const & a, SweepResult const & b){
+        return a.score < b.score;
+    });
+
+    double simulatedSeconds = double(grid.size()) * scenario.duration;
+    fprintf(stderr, "%zu simulations, %.0f simulated seconds in %.2f s on %u threads (%.2e simulated s/s, %zu stolen)\n",
+            grid.size(), simulatedSeconds, elapsed.count(), pool.size(),
+            simulatedSeconds / elapsed.count(), pool.stolenTasks());
+
+    size_t count = (top == 0 || top > results.size()) ? results.size() : top;
+    if(csv){
+        printf("rank,kp,ti,td,input_filter,derivative_filter,score,rms_error,overshoot,settling_time,settled,toggles\n");
+        for(size_t r = 0; r < count; r++){
+            SweepResult const & res = results[r];
+            printf("%zu,%g,%u,%u,%u,%u,%.4f,%.4f,%.4f,%u,%d,%u\n", r + 1,
+                   res.params.kp, res.params.ti, res.params.td, res.params.inputFilter, res.params.derivativeFilter,
+                   res.score, res.rmsError, res.overshoot, res.settlingTime, res.settled, res.toggles);
+        }
+    }
+    else{
+        printf("%5s %8s %6s %6s %4s %4s %8s %8s %9s %9s %7s\n",
+               "rank", "kp", "ti", "td", "fi", "fd", "score", "rms", "overshoot", "settling", "toggles");
+        for(size_t r = 0; r < count; r++){
+            SweepResult const & res = results[r];
+            printf("%5zu %8g %6u %6u %4u %4u %8.4f %8.4f %9.4f %8u%c %7u\n", r + 1,
+                   res.params.kp, res.params.ti, res.params.td, res.params.inputFilter, res.params.derivativeFilter,
+                   res.score, res.rmsError, res.overshoot, res.settlingTime, res.settled ? ' ' : '*', res.toggles);
+        }
+        printf("settling time in seconds, * = not settled at end of simulation\n");
+    }
+    return 0;
+}
@@ -39,6 +39,7 @@
 #include <boost/crc.hpp>  // for boost::crc_32_type
 #include "eeprom_file.h"
 #include "eeprom_hal.h"
+#include "virtual_timer.h"
 
 using std::cout;
 
@@ -257,6 +258,10 @@ bool HAL_watchdog_reset_flagged()
 
 void HAL_Notify_WDT()
 {
+    // the system notifies the watchdog once per loop and while delaying, which is where the virtual clock idles
+    GCC_Timer_Idle();
+    GCC_EEPROM_Idle();
+    GCC_Signal_Idle();
 }
 
 void HAL_Core_Init(void)
@@ -18,17 +18,24 @@
 
 #include "delay_hal.h"
 #include "timer_hal.h"
+#include "virtual_timer.h"
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/thread/thread.hpp>
 
 void HAL_Delay_Milliseconds(uint32_t millis)
 {
-    boost::this_thread::sleep(boost::posix_time::milliseconds(millis));
+    if (GCC_Timer_Is_Virtual())
+        GCC_Timer_Advance_Micros(uint64_t(millis)*1000);
+    else
+        boost::this_thread::sleep(boost::posix_time::milliseconds(millis));
 }
 
 void HAL_Delay_Microseconds(uint32_t micros)
 {
-    boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    if (GCC_Timer_Is_Virtual())
+        GCC_Timer_Advance_Micros(micros ? micros : 1);   // always advance, callers poll the clock until it moves
+    else
+        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
 }
 
@@ -19,7 +19,10 @@
 #include "device_config.h"
 #include "core_msg.h"
 #include "filesystem.h"
+#include "virtual_timer.h"
 #include <cstdlib>
+#include <csignal>
+#include <unistd.h>
 #include <fstream>
 #include <istream>
 #include <iostream>
@@ -52,6 +55,21 @@ std::istream& operator>>(std::istream& in, ProtocolFactory& pf)
 	return in;
 }
 
+std::istream& operator>>(std::istream& in, EepromSync& sync)
+{
+	string value;
+	in >> value;
+	if (value=="none")
+		sync = EEPROM_SYNC_NONE;
+	else if (value=="batched")
+		sync = EEPROM_SYNC_BATCHED;
+	else if (value=="durable")
+		sync = EEPROM_SYNC_DURABLE;
+	else
+		throw boost::program_options::invalid_option_value(value);
+	return in;
+}
+
 class ConfigParser
 {
 
@@ -95,6 +113,9 @@ public:
             ("server_key,sk", po::value<string>(&config.server_key)->default_value("server_key.der"), "the filename containing the server public key")
             ("state,s", po::value<string>(&config.periph_directory)->default_value("state"), "the directory where device state and peripherals is stored")
 			("protocol,p", po::value<ProtocolFactory>(&config.protocol)->default_value(PROTOCOL_LIGHTSSL), "the cloud communication protocol to use")
+            ("eeprom_sync", po::value<EepromSync>(&config.eeprom_sync)->default_value(EEPROM_SYNC_BATCHED), "when eeprom writes are synced to the file: none, batched or durable")
+            ("eeprom_stats", po::value<bool>(&config.eeprom_stats)->default_value(false)->implicit_value(true), "print eeprom write statistics on exit")
+            ("virtual_time,t", po::value<bool>(&config.virtual_time)->default_value(false)->implicit_value(true), "run on a virtual clock that advances when the device is idle or delays")
 			;
 
         command_line_options.add(program_options).add(device_options);
@@ -186,6 +207,26 @@ bool read_device_config(int argc, char* argv[])
     return true;
 }
 
+static void print_eeprom_stats()
+{
+    GCC_EEPROM_Print_Stats(cout);
+}
+
+static volatile sig_atomic_t exit_signal = 0;
+
+static void exit_on_signal(int signal)
+{
+    if (exit_signal)
+        _exit(128+signal);      // the loop did not exit on the first signal, only async-signal-safe calls here
+    exit_signal = signal;
+}
+
+void GCC_Signal_Idle()
+{
+    if (exit_signal)
+        exit(128+exit_signal);
+}
+
 void DeviceConfig::read(Configuration& configuration)
 {
 #ifndef SPARK_NO_CLOUD
@@ -203,5 +244,14 @@ void DeviceConfig::read(Configuration& configuration)
     setLoggerLevel(LoggerOutputLevel(NO_LOG_LEVEL-configuration.log_level));
 
     this->protocol = configuration.protocol;
+
+    GCC_Timer_Set_Virtual(configuration.virtual_time);
+
+    GCC_EEPROM_Set_Sync(configuration.eeprom_sync);
+    if (configuration.eeprom_stats) {
+        atexit(print_eeprom_stats);
+        signal(SIGINT, exit_on_signal);     // the device normally runs until it is interrupted
+        signal(SIGTERM, exit_on_signal);
+    }
 }
 
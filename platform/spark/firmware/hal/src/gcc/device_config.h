@@ -22,6 +22,7 @@
 #include <stdexcept>
 #include <cstring>
 #include "filesystem.h"
+#include "eeprom_file.h"
 #include "spark_protocol_functions.h"
 
 extern const char* DEVICE_ID;
@@ -41,6 +42,12 @@ void read_config_file(const char* config_name, void* data, size_t length);
  */
 bool read_device_config(int argc, char* argv[]);
 
+/**
+ * Called once per system loop and while delaying. Exits when SIGINT or SIGTERM was received, so the exit handlers
+ * run outside of the signal handler.
+ */
+void GCC_Signal_Idle();
+
 
 /**
  * The external configuration data.
@@ -53,6 +60,9 @@ struct Configuration
     std::string periph_directory;
     uint16_t log_level = 0;
     ProtocolFactory protocol = PROTOCOL_LIGHTSSL;
+    bool virtual_time = false;
+    EepromSync eeprom_sync = EEPROM_SYNC_BATCHED;
+    bool eeprom_stats = false;
 };
 
 
@@ -1,8 +1,35 @@
-
 #pragma once
 
+#include <cstddef>
+#include <ostream>
+
+/**
+ * How writes to a persisted eeprom reach the file.
+ */
+enum EepromSync
+{
+	EEPROM_SYNC_NONE,		// left to the operating system, the file is synced on exit
+	EEPROM_SYNC_BATCHED,	// all writes since the last loop are synced asynchronously once per loop
+	EEPROM_SYNC_DURABLE		// each write is synced to disk before it returns
+};
+
+std::ostream& operator<<(std::ostream& out, EepromSync sync);
+
+/**
+ * Maps the eeprom to the given file, which is extended to the eeprom size when it is shorter.
+ */
 void GCC_EEPROM_Load(const char* filename);
 
 void GCC_EEPROM_Save(const char* filename);
 
+void GCC_EEPROM_Set_Sync(EepromSync sync);
+
+/**
+ * Called once per system loop to sync the writes of the last loop.
+ */
+void GCC_EEPROM_Idle();
 
+/**
+ * Writes the number of writes, written bytes and syncs to the output.
+ */
+void GCC_EEPROM_Print_Stats(std::ostream& out);
@@ -21,26 +21,94 @@
 #include "eeprom_file.h"
 #include "filesystem.h"
 #include <string.h>
+#include <cstdlib>
 #include <string>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace ipc = boost::interprocess;
 
 /*
  * Implements eeprom either as a transient storage,
  * or as a persisted storage, depending upon if the file exists.
  *
+ * The persisted storage maps the file into memory, so writes are plain memory writes.
+ * When they reach the file depends on the sync mode.
+ */
+
+static const size_t eeprom_size = 2048;
+
+static uint8_t eeprom_ram[eeprom_size];
+
+/**
+ * The eeprom contents. This points to the mapped file when the eeprom is persisted.
  */
+static uint8_t* eeprom = eeprom_ram;
+
+static ipc::mapped_region eeprom_region;
+
+static EepromSync eeprom_sync = EEPROM_SYNC_BATCHED;
 
-static uint8_t eeprom[2048];
+static bool eeprom_dirty = false;
+
+static struct
+{
+	unsigned long writes;
+	unsigned long bytes;
+	unsigned long syncs;
+} eeprom_stats;
 
 std::string eeprom_file;
 
 /**
- * Write the eeprom state to the file.
- * This currently writes the entire file.
+ * Syncs the changes in the mapped eeprom to the file.
  */
-void GCC_EEPROM_Flush()
+static void GCC_EEPROM_Flush(bool async)
+{
+	if (eeprom_dirty && eeprom_file.length()) {
+		eeprom_region.flush(0, eeprom_size, async);
+		eeprom_stats.syncs++;
+	}
+	eeprom_dirty = false;
+}
+
+static void eeprom_written(size_t length)
+{
+	eeprom_stats.writes++;
+	eeprom_stats.bytes += length;
+	eeprom_dirty = true;
+	if (eeprom_sync==EEPROM_SYNC_DURABLE)
+		GCC_EEPROM_Flush(false);
+}
+
+static void eeprom_exit()
+{
+	GCC_EEPROM_Flush(false);
+}
+
+void GCC_EEPROM_Idle()
+{
+	if (eeprom_sync==EEPROM_SYNC_BATCHED)
+		GCC_EEPROM_Flush(true);
+}
+
+void GCC_EEPROM_Set_Sync(EepromSync sync)
+{
+	eeprom_sync = sync;
+}
+
+void GCC_EEPROM_Print_Stats(std::ostream& out)
+{
+	out << "eeprom: " << eeprom_stats.writes << " writes, " << eeprom_stats.bytes << " bytes, "
+		<< eeprom_stats.syncs << " syncs (" << eeprom_sync << ")" << std::endl;
+}
+
+std::ostream& operator<<(std::ostream& out, EepromSync sync)
 {
-	if (eeprom_file.length()) {
-		GCC_EEPROM_Save(eeprom_file.c_str());
+	switch (sync) {
+		case EEPROM_SYNC_NONE: return out << "none";
+		case EEPROM_SYNC_BATCHED: return out << "batched";
+		default: return out << "durable";
 	}
 }
 
@@ -75,18 +143,18 @@ void HAL_EEPROM_Get(uint32_t index, void *data, size_t length)
 void HAL_EEPROM_Put(uint32_t index, const void *data, size_t length)
 {
 	memcpy(eeprom+index, data, length);
-	GCC_EEPROM_Flush();
+	eeprom_written(length);
 }
 
 size_t HAL_EEPROM_Length()
 {
-	return sizeof(eeprom);
+	return eeprom_size;
 }
 
 void HAL_EEPROM_Clear()
 {
-	memset(eeprom, 0xFF, sizeof(eeprom));
-	GCC_EEPROM_Flush();
+	memset(eeprom, 0xFF, eeprom_size);
+	eeprom_written(eeprom_size);
 }
 
 bool HAL_EEPROM_Has_Pending_Erase()
@@ -100,13 +168,19 @@ void HAL_EEPROM_Perform_Pending_Erase()
 
 void GCC_EEPROM_Load(const char* filename)
 {
-	read_file(filename, eeprom, sizeof(eeprom));
+	// a shorter file is extended with the current contents, which are erased by HAL_EEPROM_Init
+	read_file(filename, eeprom_ram, eeprom_size);
+	write_file(filename, eeprom_ram, eeprom_size);
+
+	ipc::file_mapping mapping(file_path(filename).c_str(), ipc::read_write);
+	eeprom_region = ipc::mapped_region(mapping, ipc::read_write, 0, eeprom_size);
+	eeprom = static_cast<uint8_t*>(eeprom_region.get_address());
 	eeprom_file = filename;
+	eeprom_dirty = false;
+	atexit(eeprom_exit);
 }
 
 void GCC_EEPROM_Save(const char* filename)
 {
-	write_file(filename, eeprom, sizeof(eeprom));
+	write_file(filename, eeprom, eeprom_size);
 }
-
-
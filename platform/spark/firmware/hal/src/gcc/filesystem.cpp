@@ -74,3 +74,12 @@ void write_file(const char* filename, const void* data, size_t length)
     }
 }
 
+string file_path(const char* filename)
+{
+    string path;
+    if (rootDir) {
+        path = rootDir;
+        path += "/";
+    }
+    return path + filename;
+}
@@ -9,11 +9,17 @@
 #define	FILESYSTEM_H
 
 #include <stddef.h>
+#include <string>
 
 void read_file(const char* filename, void* data, size_t length);
 void write_file(const char* filename, const void* data, size_t length);
 bool exists_file(const char* filename);
 
+/**
+ * The path of a file, relative to the root directory when one is set.
+ */
+std::string file_path(const char* filename);
+
 
 void set_root_dir(const char* dir);
 
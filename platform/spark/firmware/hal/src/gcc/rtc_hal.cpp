@@ -1,5 +1,6 @@
 
 #include "rtc_hal.h"
+#include "virtual_timer.h"
 
 
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -23,6 +24,11 @@ time_t to_time_t(boost::posix_time::ptime t)
 time_t HAL_RTC_Get_UnixTime(void)
 {
     auto now = boost::posix_time::microsec_clock::universal_time();
+    if (GCC_Timer_Is_Virtual()) {
+        // the virtual time is counted from the wall clock time when it was first used
+        static auto origin = now - boost::posix_time::microseconds(GCC_Timer_Get_Micros64());
+        now = origin + boost::posix_time::microseconds(GCC_Timer_Get_Micros64());
+    }
     return to_time_t(now);
 }
 
@@ -1,23 +1,88 @@
 
 #include "timer_hal.h"
+#include "virtual_timer.h"
 
+#include <atomic>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 auto start = boost::posix_time::microsec_clock::universal_time();
 
-system_tick_t HAL_Timer_Get_Micro_Seconds(void)
+static bool virtual_time = false;
+static std::atomic<uint64_t> virtual_micros(0);
+static bool delayed = false;        // the virtual clock was advanced by a delay since the previous idle call
+static std::atomic<uint64_t> idle_until(0);    // virtual time the application has nothing to do until, 0 if unknown
+static std::atomic<uint32_t> stalled_reads(0); // clock reads since the virtual clock last moved
+
+/**
+ * Code that busy-waits on the clock would wait forever when the virtual clock does not move. After this many reads
+ * without the clock moving, the caller is taken to be spinning and each further read moves the clock by 1 us.
+ */
+static const uint32_t busy_wait_reads = 1000;
+
+void GCC_Timer_Set_Virtual(bool enable)
+{
+    virtual_micros = GCC_Timer_Get_Micros64();
+    delayed = false;
+    idle_until = 0;
+    stalled_reads = 0;
+    virtual_time = enable;
+}
+
+bool GCC_Timer_Is_Virtual()
 {
+    return virtual_time;
+}
+
+uint64_t GCC_Timer_Get_Micros64()
+{
+    if (virtual_time) {
+        if (stalled_reads < busy_wait_reads) {
+            stalled_reads++;
+            return virtual_micros;
+        }
+        return ++virtual_micros;
+    }
     auto now = boost::posix_time::microsec_clock::universal_time();
     auto diff = now - start;
     return diff.total_microseconds();
 }
 
-system_tick_t HAL_Timer_Get_Milli_Seconds(void)
+void GCC_Timer_Advance_Micros(uint64_t micros)
 {
-    auto now = boost::posix_time::microsec_clock::universal_time();
-    auto diff = now - start;
-    return diff.total_milliseconds();
+    if (virtual_time) {
+        virtual_micros += micros;
+        stalled_reads = 0;
+        delayed = true;
+    }
 }
 
+void GCC_Timer_Idle_Millis(uint32_t millis)
+{
+    if (virtual_time)
+        idle_until = virtual_micros + uint64_t(millis)*1000;
+}
 
+void GCC_Timer_Idle()
+{
+    if (!virtual_time)
+        return;
+    uint64_t now = virtual_micros;
+    uint64_t next = idle_until.exchange(0);
+    if (!delayed && next < (now/1000+1)*1000)
+        next = (now/1000+1)*1000;
+    if (next > now) {
+        virtual_micros = next;
+        stalled_reads = 0;
+    }
+    delayed = false;
+}
 
+system_tick_t HAL_Timer_Get_Micro_Seconds(void)
+{
+    return GCC_Timer_Get_Micros64();
+}
+
+system_tick_t HAL_Timer_Get_Milli_Seconds(void)
+{
+    return GCC_Timer_Get_Micros64()/1000;
+}
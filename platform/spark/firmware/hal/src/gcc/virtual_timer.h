@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Switches between the wall clock and a virtual clock. The virtual clock only moves when a delay is requested,
+ * or when the device is idle, so the firmware runs as fast as the host allows.
+ */
+void GCC_Timer_Set_Virtual(bool enable);
+
+bool GCC_Timer_Is_Virtual();
+
+/**
+ * The time since startup in microseconds, without the wrap around of HAL_Timer_Get_Micro_Seconds.
+ * The virtual clock does not move when it is read, unless it was read many times without moving, which means the
+ * caller busy-waits on it. Then each read moves it by a microsecond, so the wait ends.
+ */
+uint64_t GCC_Timer_Get_Micros64();
+
+/**
+ * Moves the virtual clock forward. Does nothing when the wall clock is used.
+ */
+void GCC_Timer_Advance_Micros(uint64_t micros);
+
+/**
+ * Tells the virtual clock that nothing is due for the given number of milliseconds. The next call to
+ * GCC_Timer_Idle() moves the clock to that time. Does nothing when the wall clock is used.
+ */
+void GCC_Timer_Idle_Millis(uint32_t millis);
+
+/**
+ * Called each time the system loop runs. The virtual clock moves on to the time given to GCC_Timer_Idle_Millis()
+ * since the previous call. Without it, when the firmware did not delay since the previous call, the device was
+ * idle and the clock moves on to the next millisecond.
+ */
+void GCC_Timer_Idle();
@@ -61,6 +61,18 @@
 #endif
 
 
+/**
+ * Log all control values to a ring of pages in external flash, so the host can fill gaps in its history.
+ * Only the Core has external flash.
+ */
+#ifndef BREWPI_DATA_LOG
+#if PLATFORM_ID==0
+#define BREWPI_DATA_LOG 1
+#else
+#define BREWPI_DATA_LOG 0
+#endif
+#endif
+
 #ifndef BREWPI_BOARD
 #if PLATFORM_ID==0
     #define BREWPI_BOARD BREWPI_BOARD_SPARKCORE
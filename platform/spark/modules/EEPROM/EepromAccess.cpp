@@ -4,10 +4,17 @@
 
 void SparkEepromAccess::init()
 {
+    using namespace Flashee;
 #if PLATFORM_ID==0
-    flash = Flashee::Devices::createAddressErase(4096*EEPROM_CONTROLLER_START_BLOCK, 4096*EEPROM_CONTROLLER_END_BLOCK);
+    // same layers as Devices::createAddressErase, with the wear counter on top of the physical pages
+    FlashDevice* userFlash = Devices::createUserFlashRegion(4096*EEPROM_CONTROLLER_START_BLOCK, 4096*EEPROM_CONTROLLER_END_BLOCK);
+    wear = new FlashWearCounter(*userFlash);
+    FlashDevice* mapper = new LogicalPageMapper<>(*wear, wear->pageCount() - 2);
+    flash = new PageSpanFlashDevice(*new MultiWriteFlashStore(*mapper));
 #elif PLATFORM_ID==6 || PLATFORM_ID==3
-    flash = Flashee::Devices::createEepromDevice(EEPROM_CONTROLLER_START_BLOCK, EEPROM_CONTROLLER_END_BLOCK);
+    // the system erases the emulated EEPROM itself, so only writes are counted here
+    wear = new FlashWearCounter(*new EepromFlashDevice());
+    flash = new FlashDeviceRegion(*wear, EEPROM_CONTROLLER_START_BLOCK, EEPROM_CONTROLLER_END_BLOCK);
 #else
 #error Unknown Platform ID
 #endif
@@ -8,9 +8,32 @@ namespace Flashee {
     class FlashDevice;
 };
 
+/**
+ * Forwards to the flash device below the wear levelling, counting page erases and writes to monitor flash wear.
+ */
+class FlashWearCounter : public Flashee::ForwardingFlashDevice
+{
+public:
+    FlashWearCounter(Flashee::FlashDevice& storage) : ForwardingFlashDevice(storage), erases(0), writes(0) {}
+
+    virtual bool erasePage(Flashee::flash_addr_t address) {
+        erases++;
+        return ForwardingFlashDevice::erasePage(address);
+    }
+
+    virtual bool writePage(const void* data, Flashee::flash_addr_t address, Flashee::page_size_t length) {
+        writes++;
+        return ForwardingFlashDevice::writePage(data, address, length);
+    }
+
+    uint32_t erases;
+    uint32_t writes;
+};
+
 class SparkEepromAccess
 {
     Flashee::FlashDevice* flash;
+    FlashWearCounter* wear;
 public:
     void init();
     
@@ -33,6 +56,16 @@ public:
     size_t length() {
         return flash->length();
     }
+
+    // number of pages erased in the flash that emulates the EEPROM
+    uint32_t pageErases() const {
+        return wear->erases;
+    }
+
+    // number of writes to the flash that emulates the EEPROM
+    uint32_t pageWrites() const {
+        return wear->writes;
+    }
 };
 
 typedef SparkEepromAccess EepromAccess;
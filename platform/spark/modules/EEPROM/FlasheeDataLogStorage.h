@@ -0,0 +1,50 @@
+/*
+ * Copyright 2015 BrewPi/Elco Jacobs.
+ *
+ * This file is part of BrewPi.
+ *
+ * BrewPi is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * BrewPi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with BrewPi.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "DataLog.h"
+#include "flashee-eeprom.h"
+
+/*
+ * Data log in a region of external flash. The pages are erased and written directly, without the wear levelling
+ * layers of flashee, because the data log uses the pages as a ring.
+ */
+class FlasheeDataLogStorage : public DataLogStorage
+{
+    Flashee::FlashDevice* flash;
+public:
+    FlasheeDataLogStorage(Flashee::FlashDevice* flash) : flash(flash){}
+
+    uint32_t pageSize() const override final {
+        return flash->pageSize();
+    }
+    uint32_t pageCount() const override final {
+        return flash->pageCount();
+    }
+    bool erasePage(uint32_t address) override final {
+        return flash->erasePage(address);
+    }
+    bool writePage(const void * data, uint32_t address, uint32_t length) override final {
+        return flash->writePage(data, address, length);
+    }
+    bool readPage(void * data, uint32_t address, uint32_t length) const override final {
+        return flash->readPage(data, address, length);
+    }
+};
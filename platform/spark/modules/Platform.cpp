@@ -6,6 +6,10 @@
 #include "Ymodem/Ymodem.h"
 #endif
 #include "EepromAccess.h"
+#include "SparkEepromRegions.h"
+#if PLATFORM_ID==0
+#include "FlasheeDataLogStorage.h"
+#endif
 
 SYSTEM_MODE(SEMI_AUTOMATIC);
 
@@ -33,13 +37,53 @@ void eraseExternalFlash()
 
 
 #if PLATFORM_ID==3
+#include "OneWireSimPlant.h"
+#include "virtual_timer.h"
+#include "Board.h"
+#include "Logger.h"
+#include <fstream>
+#include <string>
+
 static uint8_t device_id[12];
+
+/**
+ * The virtual device has no OneWire hardware, so it is simulated. The devices are read from hardware.conf in the
+ * current directory, one device per line as accepted by OneWireSimPlant::addDevice(). Without the file, a fridge
+ * with the default devices is simulated.
+ */
+static void simulatedHardwareInit()
+{
+    static OneWireSimPlant plant(OneWireSimBus::forAddress(oneWirePin));
+    std::ifstream in("hardware.conf");
+    if (!in) {
+        plant.addDefaultDevices();
+        return;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0]=='#')
+            continue;
+        if (!plant.addDevice(line.c_str()))
+            logDebug("invalid line in hardware.conf: %s", line.c_str());
+    }
+}
 #endif
 
+DataLogStorage * platform_dataLogStorage()
+{
+#if PLATFORM_ID==0
+    Flashee::FlashDevice* flash = Flashee::Devices::createUserFlashRegion(4096*DATA_LOG_START_BLOCK, 4096*DATA_LOG_END_BLOCK);
+    return flash ? new FlasheeDataLogStorage(flash) : NULL;
+#else
+    return NULL; // no external flash
+#endif
+}
+
 bool platform_init()
 {            
 #if PLATFORM_ID==3
 	HAL_device_ID(device_id, 12);
+	simulatedHardwareInit();
 #endif
 
 	bool initialize = (EEPROM.read(0)!=EEPROM_MAGIC1 || EEPROM.read(1)!=EEPROM_MAGIC2);
@@ -80,3 +124,9 @@ void platform_device_id(data_block_ref& id)
 #endif
 }
 
+void platform_idle(ticks_millis_t millis)
+{
+#if PLATFORM_ID==3
+	GCC_Timer_Idle_Millis(millis); // with virtual time, skip to the next update instead of stepping through it
+#endif
+}
@@ -21,7 +21,11 @@
 
 #define PRINTF_PROGMEM "%s"             // devices with unified address space
 
+#if PLATFORM_ID==3
+#define ONEWIRE_SIM     // the virtual device has simulated OneWire hardware, see OneWireSimPlant
+#else
 #define ONEWIRE_DS248X
+#endif
 
 typedef uint32_t tcduration_t;
 typedef uint32_t ticks_millis_t;
@@ -48,7 +52,20 @@ inline void watchdogCheckin(){}
 #endif
 
 
+/**
+ * Called by the main loop with the time in ms until the next update is due. A platform that can skip time while
+ * nothing is due can use this, the other platforms ignore it.
+ */
+void platform_idle(ticks_millis_t millis);
+
 /**
  * Retrieves a pointer to the device id.
  */
 void platform_device_id(data_block_ref& id);
+
+class DataLogStorage;
+
+/**
+ * Flash that holds the data log, NULL when the platform has no external flash for it.
+ */
+DataLogStorage * platform_dataLogStorage();
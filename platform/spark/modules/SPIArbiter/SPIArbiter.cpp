@@ -48,6 +48,14 @@ void SPIArbiter::apply(SPIConfiguration& client){
     }
 }
 
+SPIArbiter* SPIArbiter::dma_arbiter_ = nullptr;
+
+void SPIArbiter::dmaComplete() {
+	SPIArbiter* arbiter = dma_arbiter_;
+	arbiter->dma_callback_();
+	arbiter->dma_busy_ = false;
+}
+
 void SPIArbiter::unapply() {
 	digitalWrite(ss_pin_, HIGH); // unselect pin
 	ss_pin_ = SS_PIN_NONE;
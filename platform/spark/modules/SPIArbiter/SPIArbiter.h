@@ -85,6 +85,16 @@ class SPIArbiter : private SPIConfiguration, public GuardedResource<SPIArbiter>
     SPIClass& spi_;
     os_mutex_recursive_t mutex_;
 
+    /**
+     * Set while a DMA transfer is in progress. The client that started it releases the SPI
+     * from the completion callback, so other clients wait for this before taking over the bus.
+     */
+    volatile bool dma_busy_;
+    wiring_spi_dma_transfercomplete_callback_t dma_callback_;
+
+    static SPIArbiter* dma_arbiter_;
+    static void dmaComplete();
+
     void unapply();
     void apply(SPIConfiguration& client);
     os_mutex_recursive_t get_mutex() { return mutex_; }
@@ -93,7 +103,7 @@ class SPIArbiter : private SPIConfiguration, public GuardedResource<SPIArbiter>
 
 public:
 
-    SPIArbiter(SPIClass& spi) : current_(nullptr), spi_(spi), mutex_(nullptr) {
+    SPIArbiter(SPIClass& spi) : current_(nullptr), spi_(spi), mutex_(nullptr), dma_busy_(false), dma_callback_(nullptr) {
 #if PLATFORM_THREADING
         os_mutex_recursive_create(&mutex_);
 #endif
@@ -106,7 +116,7 @@ public:
     }
 
     inline bool try_begin(SPIConfiguration& client) {
-        if (isClient(client) || try_lock()) {
+        if (isClient(client) || (!dma_busy_ && try_lock())) {
             current_ = &client;
             apply(client);
         }
@@ -114,6 +124,9 @@ public:
     }
 
     inline void begin(SPIConfiguration& client) {
+        if (!isClient(client)) {
+            waitForTransfer();
+        }
         lock();
         current_ = &client;
         apply(client);
@@ -139,9 +152,21 @@ public:
 
     inline void transfer(SPIConfiguration& client, void* tx_buffer, void* rx_buffer, size_t length, wiring_spi_dma_transfercomplete_callback_t user_callback) {
         if (isClient(client)) {
+            if (user_callback) {
+                dma_callback_ = user_callback;
+                dma_arbiter_ = this;
+                dma_busy_ = true;
+                user_callback = dmaComplete;
+            }
             spi_.transfer(tx_buffer, rx_buffer, length, user_callback);
         }
-        // todo - should we independently track that DMA is in progress?
+    }
+
+    /**
+     * Waits until the current DMA transfer, if any, is complete.
+     */
+    inline void waitForTransfer() {
+        while (dma_busy_);
     }
 
     inline void transferCancel(SPIConfiguration& client) {
@@ -125,6 +125,15 @@ const D4DLCD_FUNCTIONS d4dlcd_ili9341 = {
 
 static D4DLCD_ORIENTATION d4dlcd_orientation = Landscape;
 
+/**
+ * The column and row range last sent to the display. Consecutive elements often share one of them,
+ * for example the characters of a text line share the rows, so it is only sent when it changes.
+ * RAMWR still has to be sent for each window, because it resets the write position to the start.
+ */
+static unsigned short window_columns[2];
+static unsigned short window_rows[2];
+static bool window_valid = false;
+
 /**************************************************************//*!
   *
   * Functions bodies
@@ -143,6 +152,7 @@ static D4DLCD_ORIENTATION d4dlcd_orientation = Landscape;
   *******************************************************************************/
 
 static unsigned char D4DLCD_Init_ili9341(void) {
+    window_valid = false; // the reset below clears the window
     D4D_LLD_LCD_HW.D4DLCDHW_Init(); // init low level hardware driver (e.g. SPI)
 
     D4DLCD_Delay_ms_ili9341(20);
@@ -282,17 +292,26 @@ static unsigned char D4DLCD_DeInit_ili9341(void) {
   *******************************************************************************/
 
 static unsigned char D4DLCD_SetWindow_ili9341(unsigned short x0, unsigned short y0, unsigned short x1, unsigned short y1) {
-    D4D_LLD_LCD_HW.D4DLCDHW_SendCmdWord(ILI9341_CASET); // Column addr set
-    D4D_LLD_LCD_HW.D4DLCDHW_SendDataWord(x0 >> 8);
-    D4D_LLD_LCD_HW.D4DLCDHW_SendDataWord(x0 & 0xFF); // XSTART 
-    D4D_LLD_LCD_HW.D4DLCDHW_SendDataWord(x1 >> 8);
-    D4D_LLD_LCD_HW.D4DLCDHW_SendDataWord(x1 & 0xFF); // XEND
-
-    D4D_LLD_LCD_HW.D4DLCDHW_SendCmdWord(ILI9341_PASET); // Row addr set
-    D4D_LLD_LCD_HW.D4DLCDHW_SendDataWord(y0 >> 8);
-    D4D_LLD_LCD_HW.D4DLCDHW_SendDataWord(y0); // YSTART
-    D4D_LLD_LCD_HW.D4DLCDHW_SendDataWord(y1 >> 8);
-    D4D_LLD_LCD_HW.D4DLCDHW_SendDataWord(y1); // YEND
+    if (!window_valid || window_columns[0] != x0 || window_columns[1] != x1) {
+        D4D_LLD_LCD_HW.D4DLCDHW_SendCmdWord(ILI9341_CASET); // Column addr set
+        D4D_LLD_LCD_HW.D4DLCDHW_SendDataWord(x0 >> 8);
+        D4D_LLD_LCD_HW.D4DLCDHW_SendDataWord(x0 & 0xFF); // XSTART 
+        D4D_LLD_LCD_HW.D4DLCDHW_SendDataWord(x1 >> 8);
+        D4D_LLD_LCD_HW.D4DLCDHW_SendDataWord(x1 & 0xFF); // XEND
+        window_columns[0] = x0;
+        window_columns[1] = x1;
+    }
+
+    if (!window_valid || window_rows[0] != y0 || window_rows[1] != y1) {
+        D4D_LLD_LCD_HW.D4DLCDHW_SendCmdWord(ILI9341_PASET); // Row addr set
+        D4D_LLD_LCD_HW.D4DLCDHW_SendDataWord(y0 >> 8);
+        D4D_LLD_LCD_HW.D4DLCDHW_SendDataWord(y0); // YSTART
+        D4D_LLD_LCD_HW.D4DLCDHW_SendDataWord(y1 >> 8);
+        D4D_LLD_LCD_HW.D4DLCDHW_SendDataWord(y1); // YEND
+        window_rows[0] = y0;
+        window_rows[1] = y1;
+    }
+    window_valid = true;
 
     D4D_LLD_LCD_HW.D4DLCDHW_SendCmdWord(ILI9341_RAMWR); // write to RAM
     return 1;
@@ -309,6 +328,7 @@ static unsigned char D4DLCD_SetOrientation_ili9341(D4DLCD_ORIENTATION new_orient
 
     unsigned short width, height;
     d4dlcd_orientation = new_orientation;
+    window_valid = false; // the window is interpreted differently after the orientation changes
 
     D4D_LLD_LCD_HW.D4DLCDHW_SendCmdWord(ILI9341_MADCTL);
 
@@ -113,6 +113,12 @@ extern "C" const D4DLCDHW_FUNCTIONS d4dlcdhw_spi_spark_8b ={
 
 #define SCREEN_DATA_BUFFER_SIZE 320
 
+/**
+ * Transfers shorter than this are sent directly. For the few parameter bytes of a command,
+ * setting up DMA and waiting for the completion interrupt takes longer than sending the bytes.
+ */
+#define DMA_MIN_TRANSFER_SIZE 32
+
 static uint8_t tx_buffer[2][SCREEN_DATA_BUFFER_SIZE];
 /**
  * The index of the currently active buffer. This buffer is written to by calls to
@@ -165,14 +171,16 @@ inline void scheduleTransfer(int8_t tx_buffer_idx, uint16_t length)
 	waitForTransferToComplete();
 	SpiLCD.begin();
 #if PLATFORM_THREADING && LCD_USE_DMA  // use DMA on the photon
-	dma_buffer_idx = tx_buffer_idx;
-	SpiLCD.transfer(tx_buffer[tx_buffer_idx], NULL, length, transferComplete);
-#else
+	if (length>=DMA_MIN_TRANSFER_SIZE) {
+		dma_buffer_idx = tx_buffer_idx;
+		SpiLCD.transfer(tx_buffer[tx_buffer_idx], NULL, length, transferComplete);
+		return;
+	}
+#endif
 	for(int i=0; i < length; i++){
 	    SpiLCD.transfer(tx_buffer[tx_buffer_idx][i]);
 	}
 	transferComplete();
-#endif
 }
 
 /**
@@ -269,6 +277,7 @@ static unsigned char D4DLCDHW_Init_Spi_Spark_8b(void) {
 //-----------------------------------------------------------------------------
 
 static unsigned char D4DLCDHW_DeInit_Spi_Spark_8b(void) {
+    waitForTransferToComplete();
     SpiLCD.end();
     return 0;
 }
@@ -425,15 +434,21 @@ static unsigned char D4DLCDHW_PinCtl_Spi_Spark_8b(D4DLCDHW_PINS pinId, D4DHW_PIN
 // DESCRIPTION: For buffered low level interfaces is used to inform
 //              driver the complete object is drawed and pending pixels should be flushed
 //
-// PARAMETERS:  none
+//              Pixels of consecutive elements are kept in the buffer, because the next
+//              element starts with setting the window, which flushes them anyway.
+//              At the end of the screen or a forced flush, the last pixels are sent without
+//              waiting, so the control loop continues while DMA finishes. The next command
+//              waits for the transfer, and the SPI arbiter makes the touch controller wait
+//              before it uses the bus.
+//
+// PARAMETERS:  mode - the reason for the flush
 //
 // RETURNS:     none
 //-----------------------------------------------------------------------------
 
 static void D4DLCD_FlushBuffer_Spi_Spark_8b(D4DLCD_FLUSH_MODE mode) {
-    if (true || mode==D4DLCD_FLSH_SCR_END || mode==D4DLCD_FLSH_FORCE) {
+    if (mode==D4DLCD_FLSH_SCR_END || mode==D4DLCD_FLSH_FORCE) {
     		flushData();
-    		waitForTransferToComplete(); // wait for last DMA transfer to complete
     }
 }
 
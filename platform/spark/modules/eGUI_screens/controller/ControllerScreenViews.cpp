@@ -117,6 +117,16 @@ const char* TemperatureProcessPresenter::ltrim(const char* s) {
 
 void TemperatureProcessPresenter::update(temp_t current, temp_t setpoint, bool has_setpoint)
 {
+    char format = tempControl.cc.tempFormat;
+    if (format==shown_format && current==shown_current && has_setpoint==shown_has_setpoint
+            && (!has_setpoint || setpoint==shown_setpoint)) {
+        return;
+    }
+    shown_format = format;
+    shown_current = current;
+    shown_setpoint = setpoint;
+    shown_has_setpoint = has_setpoint;
+
     char current_str[MAX_TEMP_LEN];
     char setpoint_str[MAX_TEMP_LEN];
 
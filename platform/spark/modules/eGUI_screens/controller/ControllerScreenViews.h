@@ -125,10 +125,17 @@ class TemperatureProcessPresenter
 {
     TemperatureProcessView& view_;    
     D4D_COLOR bg_col;
+
+    // the values currently shown, so the strings are only formatted when they change
+    temp_t shown_current;
+    temp_t shown_setpoint;
+    bool shown_has_setpoint;
+    char shown_format;
+
 public:
 
     TemperatureProcessPresenter(TemperatureProcessView& view, D4D_COLOR col) :
-        view_(view), bg_col(col)
+        view_(view), bg_col(col), shown_has_setpoint(false), shown_format(0)
     {}
     
     static void asString(char* buf, temp_t t, unsigned num_decimals, unsigned max_len);
@@ -216,15 +223,19 @@ uint16_t fetch_time(states state);
 class ControllerTimePresenter
 {
     ControllerTimeView& view_;
+    int shown_time;
     
 public:
 
     ControllerTimePresenter(ControllerTimeView& view)
-        : view_(view) {}
+        : view_(view), shown_time(-1) {}
             
     void update() {
         char time_str[MAX_TIME_LEN];
         int time = fetch_time(tempControl.getState());
+        if (time==shown_time)
+            return;
+        shown_time = time;
         if (time<0)
             time_str[0] = 0;
         else
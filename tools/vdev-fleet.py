@@ -0,0 +1,432 @@
+#!/usr/bin/env python3
+"""
+Runs a fleet of virtual BrewPi devices (the BrewPi controller built for the gcc platform) for load testing host software.
+
+Each instance runs in its own directory with its own eeprom.bin, vdev.conf and hardware.conf, so the instances
+have independent settings, device ids and simulated plants. The serial port of the virtual device is its
+stdin/stdout, which is connected to a pseudo-terminal. The runner forwards it to the host side, either as a
+second pseudo-terminal (linked as <dir>/<instance>/tty) or as a TCP port per instance.
+
+Because all traffic passes through the runner, it measures the latency from each request of the host to the
+first byte of the response. Together with the CPU and memory use of each instance, this is reported periodically
+and on exit, and optionally written to a CSV file.
+
+CPU and memory are read from /proc, so the resource columns are only filled on Linux.
+
+Example: 100 instances on TCP ports 8400-8499, with the plant from my-hardware.conf
+    tools/vdev-fleet.py -n 100 --tcp 8400 --hardware my-hardware.conf
+"""
+
+import argparse
+import csv
+import errno
+import os
+import pty
+import selectors
+import shutil
+import signal
+import socket
+import subprocess
+import sys
+import time
+import tty
+
+default_executable = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                  "../platform/spark/target/controller-gcc/controller")
+
+eeprom_size = 2048
+max_latency_samples = 10000  # per reporting interval, enough for a stable 95th percentile
+clock_ticks = os.sysconf("SC_CLK_TCK") if hasattr(os, "sysconf") else 100
+page_size = os.sysconf("SC_PAGE_SIZE") if hasattr(os, "sysconf") else 4096
+
+
+class LatencyStats:
+    "Latencies from a request of the host to the first byte of the response, in seconds"
+
+    def __init__(self):
+        self.samples = []
+        self.count = 0
+        self.total = 0.0
+        self.maximum = 0.0
+
+    def add(self, latency):
+        self.count += 1
+        self.total += latency
+        self.maximum = max(self.maximum, latency)
+        if len(self.samples) < max_latency_samples:
+            self.samples.append(latency)
+
+    def mean(self):
+        return self.total / self.count if self.count else None
+
+    def percentile(self, p):
+        if not self.samples:
+            return None
+        ordered = sorted(self.samples)
+        return ordered[min(len(ordered) - 1, int(p * len(ordered)))]
+
+
+class Instance:
+    "A virtual device process and the connection of its serial port to the host"
+
+    def __init__(self, index, directory, device_id):
+        self.index = index
+        self.directory = directory
+        self.device_id = device_id
+        self.process = None
+        self.device_fd = None  # pty master connected to stdin/stdout of the device
+        self.host_fd = None  # pty master for the host, when not using TCP
+        self.host_slave = None
+        self.host_socket = None
+        self.listener = None
+        self.host_name = ""
+        self.request_time = None  # when the host sent data that has not been answered yet
+        self.bytes_in = 0
+        self.bytes_out = 0
+        self.dropped = 0
+        self.latency = LatencyStats()
+        self.total_latency = LatencyStats()
+        self.cpu_ticks = 0
+        self.cpu_percent = None
+        self.rss = None
+
+    def name(self):
+        return "{0:03d}".format(self.index)
+
+    def running(self):
+        return self.process is not None and self.process.poll() is None
+
+    def from_host(self, data):
+        if self.request_time is None:
+            self.request_time = time.monotonic()
+        self.bytes_in += len(data)
+        if self.device_fd is not None:
+            self.dropped += write_available(lambda d: os.write(self.device_fd, d), data)
+
+    def from_device(self, data):
+        if self.request_time is not None:
+            latency = time.monotonic() - self.request_time
+            self.latency.add(latency)
+            self.total_latency.add(latency)
+            self.request_time = None
+        self.bytes_out += len(data)
+        if self.host_socket is not None:
+            self.dropped += write_available(self.host_socket.send, data)
+        elif self.host_fd is not None:
+            self.dropped += write_available(lambda d: os.write(self.host_fd, d), data)
+
+    def update_resources(self, interval):
+        "Reads the CPU time and resident memory of the process from /proc"
+        try:
+            with open("/proc/{0}/stat".format(self.process.pid)) as f:
+                # the process name can contain spaces, so the fields are counted from the closing parenthesis
+                fields = f.read().rsplit(")", 1)[1].split()
+            ticks = int(fields[11]) + int(fields[12])  # utime and stime
+            self.rss = int(fields[21]) * page_size
+        except (OSError, IndexError, ValueError):
+            self.cpu_percent = None
+            self.rss = None
+            return
+        if interval > 0:
+            self.cpu_percent = 100.0 * (ticks - self.cpu_ticks) / clock_ticks / interval
+        self.cpu_ticks = ticks
+
+
+def write_available(write, data):
+    """Writes as much of data as fits without blocking and returns the number of bytes that did not fit.
+    Like a serial port, data is dropped when the other side does not read it, so one stalled host or device
+    does not hold up the others."""
+    try:
+        written = write(data)
+    except BlockingIOError:
+        written = 0
+    except OSError:
+        written = len(data)  # the other side is gone, which is reported when it is read
+    return len(data) - written
+
+
+def open_pty():
+    "Returns the master and slave of a new pseudo-terminal in raw mode, so bytes pass unchanged"
+    master, slave = pty.openpty()
+    tty.setraw(slave)
+    os.set_blocking(master, False)
+    return master, slave
+
+
+def device_id_for(prefix, index):
+    "The device id is 12 bytes written as 24 hex digits: the prefix followed by the instance number"
+    suffix = "{0:x}".format(index)
+    return (prefix + suffix.rjust(24 - len(prefix), "0"))[:24]
+
+
+def prepare_directory(args, index):
+    directory = os.path.join(args.dir, "{0:03d}".format(index))
+    if args.clean and os.path.isdir(directory):
+        shutil.rmtree(directory)
+    os.makedirs(directory, exist_ok=True)
+
+    eeprom = os.path.join(directory, "eeprom.bin")
+    if not os.path.exists(eeprom):
+        # an erased eeprom, the firmware initializes it with its defaults
+        with open(eeprom, "wb") as f:
+            f.write(b"\xff" * eeprom_size)
+
+    if args.hardware:
+        shutil.copyfile(args.hardware, os.path.join(directory, "hardware.conf"))
+
+    device_id = device_id_for(args.id_prefix, index)
+    with open(os.path.join(directory, "vdev.conf"), "w") as f:
+        f.write("device_id={0}\n".format(device_id))
+        if args.virtual_time:
+            f.write("virtual_time=true\n")
+        if args.eeprom_sync:
+            f.write("eeprom_sync={0}\n".format(args.eeprom_sync))
+    return Instance(index, directory, device_id)
+
+
+def start_instance(instance, args, selector):
+    instance.device_fd, device_slave = open_pty()
+    log = open(os.path.join(instance.directory, "stderr.log"), "ab")
+    environment = dict(os.environ)
+    # settings from the environment override vdev.conf, so they would apply to all instances alike
+    for name in list(environment):
+        if name.startswith("VDEV_"):
+            del environment[name]
+    instance.process = subprocess.Popen([os.path.abspath(args.executable)] + args.device_args,
+                                        cwd=instance.directory, stdin=device_slave, stdout=device_slave,
+                                        stderr=log, env=environment, close_fds=True, start_new_session=True)
+    os.close(device_slave)
+    log.close()
+    selector.register(instance.device_fd, selectors.EVENT_READ, (instance, "device"))
+
+    if args.tcp:
+        port = args.tcp + instance.index
+        instance.listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        instance.listener.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        instance.listener.bind((args.bind, port))
+        instance.listener.listen(1)
+        instance.listener.setblocking(False)
+        instance.host_name = "{0}:{1}".format(args.bind, port)
+        selector.register(instance.listener, selectors.EVENT_READ, (instance, "listen"))
+    else:
+        instance.host_fd, host_slave = open_pty()
+        link = os.path.join(instance.directory, "tty")
+        if os.path.lexists(link):
+            os.remove(link)
+        os.symlink(os.ttyname(host_slave), link)
+        # keep the slave open, so the master does not report hangups while no host is connected
+        instance.host_slave = host_slave
+        instance.host_name = link
+        selector.register(instance.host_fd, selectors.EVENT_READ, (instance, "host"))
+
+
+def stop_instance(instance, selector):
+    for fileobj in (instance.device_fd, instance.host_fd, instance.host_socket, instance.listener):
+        if fileobj is not None:
+            try:
+                selector.unregister(fileobj)
+            except (KeyError, ValueError):
+                pass
+    if instance.running():
+        instance.process.terminate()
+        try:
+            instance.process.wait(timeout=5)
+        except subprocess.TimeoutExpired:
+            instance.process.kill()
+            instance.process.wait()
+
+
+def handle_event(instance, kind, selector):
+    if kind == "listen":
+        connection, _ = instance.listener.accept()
+        if instance.host_socket is not None:
+            connection.close()  # one host per device, like a serial port
+            return
+        connection.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        connection.setblocking(False)
+        instance.host_socket = connection
+        instance.request_time = None
+        selector.register(connection, selectors.EVENT_READ, (instance, "socket"))
+    elif kind == "socket":
+        try:
+            data = instance.host_socket.recv(4096)
+        except (BlockingIOError, InterruptedError):
+            return
+        except OSError:
+            data = b""
+        if data:
+            instance.from_host(data)
+        else:
+            selector.unregister(instance.host_socket)
+            instance.host_socket.close()
+            instance.host_socket = None
+    elif kind == "host":
+        try:
+            data = os.read(instance.host_fd, 4096)
+        except (BlockingIOError, InterruptedError):
+            return
+        if data:
+            instance.from_host(data)
+    elif kind == "device":
+        try:
+            data = os.read(instance.device_fd, 4096)
+        except (BlockingIOError, InterruptedError):
+            return
+        except OSError as e:
+            if e.errno != errno.EIO:  # EIO means the device closed its side of the pty
+                raise
+            data = b""
+        if data:
+            instance.from_device(data)
+        else:
+            selector.unregister(instance.device_fd)
+            os.close(instance.device_fd)
+            instance.device_fd = None
+
+
+def format_ms(seconds):
+    return "-" if seconds is None else "{0:.2f}".format(seconds * 1000)
+
+
+def format_value(value, scale=1.0, digits=1):
+    return "-" if value is None else "{0:.{1}f}".format(value / scale, digits)
+
+
+columns = ["instance", "pid", "state", "cpu %", "rss MB", "in B", "out B", "dropped B", "requests",
+           "mean ms", "p95 ms", "max ms"]
+
+
+def report_rows(instances, total):
+    "The report as rows of strings, with the latencies of the last interval, or of the whole run if total is set"
+    rows = []
+    for i in instances:
+        latency = i.total_latency if total else i.latency
+        rows.append([i.name(), str(i.process.pid), "running" if i.running() else "exit {0}".format(i.process.poll()),
+                     format_value(i.cpu_percent), format_value(i.rss, 1024 * 1024), str(i.bytes_in),
+                     str(i.bytes_out), str(i.dropped), str(latency.count), format_ms(latency.mean()),
+                     format_ms(latency.percentile(0.95)), format_ms(latency.maximum if latency.count else None)])
+
+    combined = LatencyStats()
+    for i in instances:
+        latency = i.total_latency if total else i.latency
+        combined.count += latency.count
+        combined.total += latency.total
+        combined.maximum = max(combined.maximum, latency.maximum)
+        combined.samples.extend(latency.samples)
+    running = sum(1 for i in instances if i.running())
+    cpu = [i.cpu_percent for i in instances if i.cpu_percent is not None]
+    rss = [i.rss for i in instances if i.rss is not None]
+    rows.append(["all", "", "{0}/{1} running".format(running, len(instances)),
+                 format_value(sum(cpu) if cpu else None), format_value(sum(rss) if rss else None, 1024 * 1024),
+                 str(sum(i.bytes_in for i in instances)), str(sum(i.bytes_out for i in instances)),
+                 str(sum(i.dropped for i in instances)), str(combined.count), format_ms(combined.mean()),
+                 format_ms(combined.percentile(0.95)),
+                 format_ms(combined.maximum if combined.count else None)])
+    return rows
+
+
+def print_report(rows, out, summary_only):
+    if summary_only:
+        rows = rows[-1:]
+    widths = [max(len(c), *(len(r[n]) for r in rows)) for n, c in enumerate(columns)]
+    out.write("  ".join(c.rjust(w) for c, w in zip(columns, widths)) + "\n")
+    for r in rows:
+        out.write("  ".join(v.rjust(w) for v, w in zip(r, widths)) + "\n")
+    out.write("\n")
+    out.flush()
+
+
+def parse_arguments():
+    parser = argparse.ArgumentParser(description="Runs many virtual BrewPi devices for load testing.",
+                                     epilog="Arguments after -- are passed to each virtual device.")
+    parser.add_argument("-n", "--count", type=int, default=10, help="number of instances (default 10)")
+    parser.add_argument("-e", "--executable", default=default_executable, help="the virtual device executable")
+    parser.add_argument("-d", "--dir", default="vdev-fleet",
+                        help="directory with a subdirectory per instance (default vdev-fleet)")
+    parser.add_argument("--clean", action="store_true", help="remove the state of earlier runs, such as eeprom.bin")
+    parser.add_argument("--tcp", type=int, metavar="PORT",
+                        help="serve instance i on TCP port PORT+i instead of a pseudo-terminal")
+    parser.add_argument("--bind", default="127.0.0.1", help="address for the TCP ports (default 127.0.0.1)")
+    parser.add_argument("--hardware", help="hardware.conf for the simulated plant of each instance")
+    parser.add_argument("--id-prefix", default="b1ee", help="hex prefix of the device ids (default b1ee)")
+    parser.add_argument("--virtual-time", action="store_true", help="run the instances on a virtual clock")
+    parser.add_argument("--eeprom-sync", choices=["none", "batched", "durable"], help="eeprom sync mode")
+    parser.add_argument("-i", "--interval", type=float, default=10.0,
+                        help="seconds between reports, 0 to only report on exit (default 10)")
+    parser.add_argument("--summary", action="store_true", help="only print the totals in the periodic reports")
+    parser.add_argument("--csv", help="append the periodic reports per instance to this CSV file")
+    parser.add_argument("--duration", type=float, help="stop after this many seconds")
+    parser.add_argument("device_args", nargs="*", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if not os.path.exists(args.executable):
+        parser.error("virtual device executable not found: {0}. "
+                     "Build it with 'make -C platform/spark PLATFORM=gcc APP=controller'".format(args.executable))
+    if args.count < 1:
+        parser.error("count must be at least 1")
+    if len(args.id_prefix) >= 24 or any(c not in "0123456789abcdefABCDEF" for c in args.id_prefix):
+        parser.error("the device id prefix must be less than 24 hex digits")
+    if args.tcp and args.tcp + args.count > 65536:
+        parser.error("not enough TCP ports above {0}".format(args.tcp))
+    return args
+
+
+def main():
+    args = parse_arguments()
+    selector = selectors.DefaultSelector()
+    stopping = []
+    signal.signal(signal.SIGINT, lambda signum, frame: stopping.append(signum))
+    signal.signal(signal.SIGTERM, lambda signum, frame: stopping.append(signum))
+
+    instances = [prepare_directory(args, index) for index in range(args.count)]
+    for instance in instances:
+        start_instance(instance, args, selector)
+        sys.stdout.write("{0} {1} {2}\n".format(instance.name(), instance.device_id, instance.host_name))
+    sys.stdout.write("\n")
+    sys.stdout.flush()
+
+    csv_file = open(args.csv, "a", newline="") if args.csv else None
+    csv_writer = csv.writer(csv_file) if csv_file else None
+    if csv_file and csv_file.tell() == 0:
+        csv_writer.writerow(["time"] + columns)
+
+    start = time.monotonic()
+    last_report = start
+    while not stopping:
+        now = time.monotonic()
+        if args.duration and now - start >= args.duration:
+            break
+        timeout = 1.0
+        if args.interval > 0:
+            timeout = min(timeout, max(0.0, last_report + args.interval - now))
+        for key, _ in selector.select(timeout):
+            instance, kind = key.data
+            handle_event(instance, kind, selector)
+
+        now = time.monotonic()
+        if args.interval > 0 and now - last_report >= args.interval:
+            for instance in instances:
+                instance.update_resources(now - last_report)
+            rows = report_rows(instances, False)
+            print_report(rows, sys.stdout, args.summary)
+            if csv_writer:
+                timestamp = time.strftime("%Y-%m-%dT%H:%M:%S")
+                csv_writer.writerows([timestamp] + r for r in rows[:-1])
+                csv_file.flush()
+            for instance in instances:
+                instance.latency = LatencyStats()
+            last_report = now
+
+    now = time.monotonic()
+    for instance in instances:
+        instance.update_resources(now - last_report)
+    for instance in instances:
+        stop_instance(instance, selector)
+    sys.stdout.write("totals over {0:.0f} s\n".format(now - start))
+    print_report(report_rows(instances, True), sys.stdout, False)
+    if csv_file:
+        csv_file.close()
+
+
+if __name__ == "__main__":
+    main()